@@ -2,123 +2,287 @@
 
 namespace Victor::Components {
 
-  AQSensor::AQSensor(AQSensorType type, QueryConfig* query) {
+  // crc-8 0x31, init 0xFF over each 2 byte word
+  static uint8_t crc8(const uint8_t* data) {
+    uint8_t crc = 0xFF;
+    for (auto i = 0; i < 2; i++) {
+      crc ^= data[i];
+      for (auto bit = 0; bit < 8; bit++) {
+        crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+      }
+    }
+    return crc;
+  }
+
+  AQSensor::AQSensor(AQSensorType type) {
     _sgp30 = new Adafruit_SGP30();
-    if (query->loopSeconds > 0) {
-      _measureInterval = new IntervalOverAuto(query->loopSeconds * 1000);
+  }
+
+  AQSensor::~AQSensor() {
+    if (_sgp30 != nullptr) {
+      delete _sgp30;
+      _sgp30 = nullptr;
+    }
+  }
+
+  bool AQSensor::begin() {
+    _absent = !_bringUp();
+    _probeMillis = millis();
+    _probeBackoff = AQ_PROBE_MIN_MILLIS;
+    return !_absent;
+  }
+
+  bool AQSensor::isPresent() const {
+    return !_absent;
+  }
+
+  bool AQSensor::loadBaseline(const AQBaseline& baseline) {
+    _baseline = baseline;
+    if (!baseline.load) {
+      return false;
+    }
+    // the log wins, climate.json values are only a fallback for units stored before it
+    uint16_t co2 = 0, voc = 0;
+    if (!baselineLog.read(co2, voc)) {
+      co2 = baseline.co2;
+      voc = baseline.voc;
     }
-    if (query->resetHours > 0) {
-      _resetInterval = new IntervalOverAuto(query->resetHours * 60 * 60 * 1000);
+    if (co2 == 0 || voc == 0) {
+      return false;
     }
+    if (!_sgp30->setIAQBaseline(co2, voc)) {
+      return false;
+    }
+    console.log()
+      .bracket(F("load"))
+      .section(F("co2"), String(co2))
+      .section(F("voc"), String(voc));
+    return true;
   }
 
-  AQSensor::~AQSensor() {
-    if (_measureInterval != nullptr) {
-      free(_measureInterval);
-      _measureInterval = nullptr;
+  void AQSensor::reset() {
+    if (_absent) {
+      return;
     }
-    if (_resetInterval != nullptr) {
-      free(_resetInterval);
-      _resetInterval = nullptr;
+    _hasHumidity = false;
+    _hasPendingHumidity = false;
+    _converting = false;
+    // the gap around a reset is not sampling jitter
+    _hasLastSample = false;
+    _sgp30->softReset();
+  }
+
+  MeasureState AQSensor::sample() {
+    if (_converting) {
+      return _collect();
     }
-    if (_storeInterval != nullptr) {
-      free(_storeInterval);
-      _storeInterval = nullptr;
+    if (_absent && !_probe()) {
+      _sampleFailures++; // measure() reports it, no bus transaction
+      return MEASURE_FAILED;
     }
-    if (_sgp30 != nullptr) {
-      delete _sgp30;
-      _sgp30 = nullptr;
+    const auto now = micros();
+    if (_hasLastSample) {
+      const auto interval = now - _lastSampleMicros;
+      const auto target = AQ_SAMPLE_INTERVAL_MILLIS * 1000UL;
+      const auto jitter = interval > target ? interval - target : target - interval;
+      _sampling.jitterSumMicros += jitter;
+      _sampling.jitterMaxMicros = std::max<uint32_t>(_sampling.jitterMaxMicros, jitter);
+    }
+    _lastSampleMicros = now;
+    _hasLastSample = true;
+    _sampling.samples++;
+    Wire.beginTransmission(AQ_SGP30_ADDRESS);
+    Wire.write(static_cast<uint8_t>(AQ_SGP30_MEASURE_IAQ >> 8));
+    Wire.write(static_cast<uint8_t>(AQ_SGP30_MEASURE_IAQ & 0xFF));
+    if (Wire.endTransmission(true) != 0) {
+      i2cBus.record(AQ_SGP30_ADDRESS, false, micros() - now);
+      return _failed();
+    }
+    _commandMicros = micros() - now;
+    _converting = true;
+    return MEASURE_SKIPPED;
+  }
+
+  bool AQSensor::isConverting() {
+    return _converting;
+  }
+
+  unsigned long AQSensor::getWaitMillis() {
+    return AQ_SGP30_MEASURE_MILLIS;
+  }
+
+  MeasureState AQSensor::_collect() {
+    _converting = false;
+    const auto start = micros();
+    uint8_t data[6];
+    auto ok = Wire.requestFrom(static_cast<uint8_t>(AQ_SGP30_ADDRESS), static_cast<uint8_t>(6), true) == 6;
+    if (ok) {
+      for (auto i = 0; i < 6; i++) {
+        data[i] = Wire.read();
+      }
+      ok = crc8(data) == data[2] && crc8(data + 3) == data[5];
+    }
+    // bus time of the command and the read, the wait in between is not blocking
+    i2cBus.record(AQ_SGP30_ADDRESS, ok, _commandMicros + micros() - start);
+    if (!ok) {
+      return _failed();
+    }
+    _failureStreak = 0;
+    _co2Sum += (static_cast<uint16_t>(data[0]) << 8) | data[1];
+    _vocSum += (static_cast<uint16_t>(data[3]) << 8) | data[4];
+    _sampleCount++;
+    if (_hasPendingHumidity) {
+      _hasPendingHumidity = false;
+      _writeHumidity(_pendingHumidity);
     }
+    return MEASURE_SUCCESS;
   }
 
-  bool AQSensor::begin(AQBaseline* baseline) {
-    if (baseline->storeHours > 0) {
-      _storeInterval = new IntervalOver(baseline->storeHours * 60 * 60 * 1000);
+  MeasureState AQSensor::_failed() {
+    _sampling.failures++;
+    _sampleFailures++;
+    if (++_failureStreak >= AQ_RECOVER_FAILURES) {
+      _recover();
     }
+    return MEASURE_FAILED;
+  }
+
+  MeasureState AQSensor::measure() {
+    if (_sampleCount == 0) {
+      const auto state = _sampleFailures > 0 ? MEASURE_FAILED : MEASURE_SKIPPED;
+      _sampleFailures = 0;
+      return state;
+    }
+    _co2 = (_co2Sum + _sampleCount / 2) / _sampleCount;
+    _voc = (_vocSum + _sampleCount / 2) / _sampleCount;
+    _co2Sum = 0;
+    _vocSum = 0;
+    _sampleCount = 0;
+    _sampleFailures = 0;
+    return MEASURE_SUCCESS;
+  }
+
+  bool AQSensor::_bringUp() {
+    _hasHumidity = false;
+    _hasPendingHumidity = false;
+    _converting = false;
     const auto found = _sgp30->begin();
     if (found) {
       _sgp30->IAQinit();
-      if (
-        baseline->load &&
-        baseline->co2 > 0 &&
-        baseline->voc > 0
-      ) {
-        _sgp30->setIAQBaseline(
-          baseline->co2,
-          baseline->voc
-        );
-        console.log()
-          .bracket(F("load"))
-          .section(F("co2"), String(baseline->co2))
-          .section(F("voc"), String(baseline->voc));
-      }
     }
     return found;
   }
 
-  void AQSensor::reset() {
-    _sgp30->softReset();
+  bool AQSensor::_probe() {
+    const auto now = millis();
+    if (now - _probeMillis < _probeBackoff) {
+      return false;
+    }
+    _sampling.probes++;
+    _probeMillis = now;
+    if (!_bringUp()) {
+      _probeBackoff = std::min<unsigned long>(_probeBackoff * 2, AQ_PROBE_MAX_MILLIS);
+      return false;
+    }
+    _absent = false;
+    loadBaseline(_baseline);
+    // the gap while absent is not sampling jitter
+    _hasLastSample = false;
+    console.log()
+      .bracket(F("aq"))
+      .section(F("probe"), F("answered"));
+    return true;
   }
 
-  MeasureState AQSensor::measure() {
-    const auto now = millis();
-    if (_measureInterval == nullptr || !_measureInterval->isOver(now)) {
-      return MEASURE_SKIPPED;
-    }
-    if (_resetInterval != nullptr && _resetInterval->isOver(now)) {
-      reset();
-      return MEASURE_SKIPPED;
-    }
-    ESP.wdtFeed();
-    const auto readSuccess = _sgp30->IAQmeasure();
-    if (
-      readSuccess &&
-      _storeInterval != nullptr &&
-      _storeInterval->isOver(now)
-    ) {
-      uint16_t co2, voc;
-      if (_sgp30->getIAQBaseline(&co2, &voc)) {
-        _storeInterval->start(now);
-        auto setting = climateStorage.load();
-        setting->baseline->load = true; // once we have baseline generated, enable load for next boot
-        setting->baseline->co2 = co2;
-        setting->baseline->voc = voc;
-        climateStorage.save(setting);
-        console.log()
-          .bracket(F("store"))
-          .section(F("co2"), String(co2))
-          .section(F("voc"), String(voc));
-      }
+  void AQSensor::_recover() {
+    // the next sample is a second away anyway, no point in retrying sooner
+    _failureStreak = 0;
+    i2cBus.clear();
+    if (begin()) {
+      loadBaseline(_baseline);
     }
-    return readSuccess ? MEASURE_SUCCESS : MEASURE_FAILED;
+    i2cBus.recovered(AQ_SGP30_ADDRESS);
+    _sampling.recoveries++;
+    // the gap around a recovery is not sampling jitter
+    _hasLastSample = false;
   }
 
-  float AQSensor::getCO2() {
-    return _sgp30->eCO2;
+  const AQSampling& AQSensor::getSampling() {
+    return _sampling;
   }
 
-  float AQSensor::getTVOC() {
-    return _sgp30->TVOC;
+  bool AQSensor::storeBaseline() {
+    if (_converting) {
+      return false; // no command until the result is read, the caller retries
+    }
+    uint16_t co2, voc;
+    if (!_sgp30->getIAQBaseline(&co2, &voc)) {
+      return false;
+    }
+    if (!baselineLog.append(co2, voc)) {
+      return false;
+    }
+    console.log()
+      .bracket(F("store"))
+      .section(F("co2"), String(co2))
+      .section(F("voc"), String(voc));
+    return true;
+  }
+
+  uint16_t AQSensor::getCO2() {
+    return _co2;
+  }
+
+  uint16_t AQSensor::getTVOC() {
+    return _voc;
+  }
+
+  void AQSensor::setRelHumidity(const int32_t centiHumidity, const int32_t centiCelsius) {
+    if (_absent) {
+      return; // written once it answers again, begin() dropped the last written value
+    }
+    const auto absoluteHumidity = ClimateMath::absoluteHumidity(centiCelsius, centiHumidity);
+    if (_converting) {
+      // written right after the result is read, a newer value replaces the held one
+      if (_hasPendingHumidity) {
+        _humiditySkips++;
+      }
+      _pendingHumidity = absoluteHumidity;
+      _hasPendingHumidity = true;
+      return;
+    }
+    _writeHumidity(absoluteHumidity);
+  }
+
+  void AQSensor::_writeHumidity(const uint16_t absoluteHumidity) {
+    if (_hasHumidity) {
+      const auto delta = absoluteHumidity > _humidity ? absoluteHumidity - _humidity : _humidity - absoluteHumidity;
+      if (delta < _humidityDelta || delta == 0) {
+        _humiditySkips++;
+        return;
+      }
+    }
+    // the adafruit library takes mg/m³ and scales to 8.8 on its own
+    const auto start = micros();
+    const auto ok = _sgp30->setHumidity(ClimateMath::toMilligrams(absoluteHumidity));
+    i2cBus.record(AQ_SGP30_ADDRESS, ok, micros() - start);
+    if (ok) {
+      _humidity = absoluteHumidity;
+      _hasHumidity = true;
+    }
+    _humidityWrites++;
   }
 
-  void AQSensor::setRelHumidity(float relHumidity, float temperature) {
-    auto absHumidity = getAbsoluteHumidity(relHumidity, temperature);
-    auto sensHumidity = doubleToFixedPoint(absHumidity);
-    _sgp30->setHumidity(sensHumidity);
+  void AQSensor::setHumidityDelta(const uint16_t delta) {
+    _humidityDelta = delta;
   }
 
-  double AQSensor::getAbsoluteHumidity(float relativeHumidity, float temperature) {
-    double eSat = 6.11 * pow(10.0, (7.5 * temperature / (237.7 + temperature)));
-    double vaporPressure = (relativeHumidity * eSat) / 100; // millibars
-    double absHumidity = 1000 * vaporPressure * 100 / ((temperature + 273) * 461.5); // Ideal gas law with unit conversions
-    return absHumidity;
+  uint32_t AQSensor::getHumidityWrites() {
+    return _humidityWrites;
   }
 
-  uint16_t AQSensor::doubleToFixedPoint(double number) {
-    int power = 1 << 8;
-    double number2 = number * power;
-    uint16_t value = floor(number2 + 0.5);
-    return value;
+  uint32_t AQSensor::getHumiditySkips() {
+    return _humiditySkips;
   }
 
 } // namespace Victor::Components
@@ -1,31 +1,111 @@
 #ifndef AQSensor_h
 #define AQSensor_h
 
+#include <Wire.h>
 #include <Adafruit_SGP30.h>
-#include <Timer/IntervalOverAuto.h>
-#include <Timer/IntervalOver.h>
 #include "ClimateStorage.h"
+#include "BaselineLog.h"
+#include "ClimateMath.h"
+#include "I2cBus.h"
+
+// the on-chip baseline algorithm of sgp30 expects one IAQmeasure per second
+#define AQ_SAMPLE_INTERVAL_MILLIS 1000
+// fixed sgp30 bus address
+#define AQ_SGP30_ADDRESS 0x58
+// measure_iaq, answered no sooner than 12ms later (datasheet max),
+// waited one millis() tick longer as the wait starts before the command
+#define AQ_SGP30_MEASURE_IAQ 0x2008
+#define AQ_SGP30_MEASURE_MILLIS 13
+// consecutive failed samples before the bus is cleared and the sensor brought up again
+#define AQ_RECOVER_FAILURES 2
+// a sgp30 that did not answer begin() is probed again after 15s, doubling up to 8min
+#define AQ_PROBE_MIN_MILLIS 15000
+#define AQ_PROBE_MAX_MILLIS 480000
 
 namespace Victor::Components {
 
+  struct AQSampling {
+    uint32_t samples = 0;
+    uint32_t failures = 0;
+    uint32_t recoveries = 0;
+    // begin() tried again on a sgp30 that did not answer
+    uint32_t probes = 0;
+    // |interval - 1s| between consecutive samples
+    uint32_t jitterMaxMicros = 0;
+    uint64_t jitterSumMicros = 0;
+    uint32_t jitterAvgMicros() const {
+      return samples > 1 ? jitterSumMicros / (samples - 1) : 0;
+    }
+  };
+
   class AQSensor {
    public:
-    AQSensor(AQSensorType type, QueryConfig* query);
+    AQSensor(AQSensorType type);
     ~AQSensor();
-    bool begin(AQBaseline* baseline);
+    // false when the sgp30 did not answer, samples fail without bus traffic then
+    // and it is probed again on a backoff
+    bool begin();
+    bool isPresent() const;
+    // apply the latest logged baseline, climate.json values as fallback, nothing unless baseline.load
+    bool loadBaseline(const AQBaseline& baseline);
     void reset();
+    // one measure_iaq, to be called every AQ_SAMPLE_INTERVAL_MILLIS, accumulated for the next measure()
+    // split like the ht measure: the first call sends the command and returns skipped,
+    // call again getWaitMillis() later to read the result
+    MeasureState sample();
+    bool isConverting();
+    unsigned long getWaitMillis();
+    // mean of the samples since the last call, skipped when there were none
     MeasureState measure();
-    float getCO2();
-    float getTVOC();
-    void setRelHumidity(float relHumidity, float temperature);
-    static double getAbsoluteHumidity(float relativeHumidity, float temperature);
-    static uint16_t doubleToFixedPoint(double number);
+    const AQSampling& getSampling();
+    // append the current IAQ baseline to baselineLog so the next boot can load it
+    bool storeBaseline();
+    uint16_t getCO2();
+    uint16_t getTVOC();
+    // humidity compensation from centi %RH and centi °C
+    // written only when moved at least delta (8.8 g/m³) away from the last written value
+    void setRelHumidity(const int32_t centiHumidity, const int32_t centiCelsius);
+    void setHumidityDelta(const uint16_t delta);
+    // compensation writes sent and skipped (bus transactions saved)
+    uint32_t getHumidityWrites();
+    uint32_t getHumiditySkips();
 
    private:
-    IntervalOverAuto* _measureInterval = nullptr;
-    IntervalOverAuto* _resetInterval = nullptr;
-    IntervalOver* _storeInterval = nullptr;
     Adafruit_SGP30* _sgp30 = nullptr;
+    uint16_t _humidityDelta = 0;
+    uint16_t _humidity = 0;
+    // false until written, and again after the sensor lost it on reset
+    bool _hasHumidity = false;
+    uint32_t _humidityWrites = 0;
+    uint32_t _humiditySkips = 0;
+    // samples accumulated since the last measure()
+    uint32_t _co2Sum = 0;
+    uint32_t _vocSum = 0;
+    uint16_t _sampleCount = 0;
+    uint16_t _sampleFailures = 0;
+    uint16_t _co2 = 0;
+    uint16_t _voc = 0;
+    unsigned long _lastSampleMicros = 0;
+    bool _hasLastSample = false;
+    // measure_iaq sent, result not read yet
+    bool _converting = false;
+    unsigned long _commandMicros = 0;
+    // compensation held back while converting, the sgp30 takes no command then
+    uint16_t _pendingHumidity = 0;
+    bool _hasPendingHumidity = false;
+    AQSampling _sampling;
+    // failed samples in a row, and the baseline to restore after recovering
+    uint8_t _failureStreak = 0;
+    AQBaseline _baseline;
+    bool _absent = false;
+    unsigned long _probeMillis = 0;
+    unsigned long _probeBackoff = 0;
+    bool _bringUp();
+    bool _probe();
+    MeasureState _collect();
+    MeasureState _failed();
+    void _writeHumidity(const uint16_t absoluteHumidity);
+    void _recover();
   };
 
 } // namespace Victor::Components
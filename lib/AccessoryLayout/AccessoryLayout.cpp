@@ -0,0 +1,68 @@
+#include "AccessoryLayout.h"
+
+namespace Victor::Components {
+
+  AccessoryLayout::AccessoryLayout(const char* filePath)
+    : _filePath(filePath) {}
+
+  uint16_t AccessoryLayout::apply(const uint8_t layout) {
+    if (!_read()) {
+      _record = AccessoryLayoutRecord(); // nothing stored yet, the full database was advertised
+    }
+    _changed = _record.layout != layout;
+    if (_changed) {
+      _record.layout = layout;
+      _record.configNumber = _record.configNumber >= ACCESSORY_CONFIG_NUMBER_MAX ? 1 : _record.configNumber + 1;
+      if (!_write()) {
+        console.error()
+          .bracket(F("accessory"))
+          .section(F("layout write failed"));
+      }
+    }
+    return _record.configNumber;
+  }
+
+  uint16_t AccessoryLayout::getConfigNumber() const {
+    return _record.configNumber;
+  }
+
+  bool AccessoryLayout::isChanged() const {
+    return _changed;
+  }
+
+  bool AccessoryLayout::_read() {
+    auto file = LittleFS.open(_filePath, "r");
+    if (!file) {
+      return false;
+    }
+    AccessoryLayoutRecord record;
+    auto ok = file.read(reinterpret_cast<uint8_t*>(&record), sizeof(record)) == sizeof(record);
+    file.close();
+    ok = ok && record.crc == crc16(reinterpret_cast<const uint8_t*>(&record), offsetof(AccessoryLayoutRecord, crc));
+    ok = ok && record.configNumber > 0;
+    if (ok) {
+      _record = record;
+    }
+    return ok;
+  }
+
+  bool AccessoryLayout::_write() {
+    _record.crc = crc16(reinterpret_cast<const uint8_t*>(&_record), offsetof(AccessoryLayoutRecord, crc));
+    // written aside and renamed over like the config image
+    const auto tempPath = String(_filePath) + F(".tmp");
+    auto file = LittleFS.open(tempPath.c_str(), "w");
+    if (!file) {
+      return false;
+    }
+    const auto written = file.write(reinterpret_cast<const uint8_t*>(&_record), sizeof(_record));
+    file.close();
+    if (written != sizeof(_record)) {
+      return false;
+    }
+    return LittleFS.rename(tempPath.c_str(), _filePath);
+  }
+
+  // global
+  AccessoryLayout accessoryLayout;
+
+} // namespace Victor::Components
@@ -0,0 +1,52 @@
+#ifndef AccessoryLayout_h
+#define AccessoryLayout_h
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Console.h>
+#include "Crc16.h"
+
+// accessories advertised besides the bridge
+#define ACCESSORY_LAYOUT_HT 0x01 // temperature and humidity
+#define ACCESSORY_LAYOUT_AQ 0x02 // air quality
+// what the firmware advertised before the layout was stored, under configuration number 1
+#define ACCESSORY_LAYOUT_FULL (ACCESSORY_LAYOUT_HT | ACCESSORY_LAYOUT_AQ)
+// HAP configuration number range, 1~65535
+#define ACCESSORY_CONFIG_NUMBER_MAX 65535
+
+namespace Victor::Components {
+
+  struct AccessoryLayoutRecord {
+    uint8_t layout = ACCESSORY_LAYOUT_FULL;
+    uint8_t reserved = 0;
+    uint16_t configNumber = 1;
+    uint16_t crc = 0; // crc16 of the fields above
+  };
+
+  // the accessory layout of the last boot and the configuration number it was advertised with,
+  // paired controllers fetch the database again only when the number moves,
+  // so it moves forward on every layout change and never comes back to a number already used
+  class AccessoryLayout {
+   public:
+    AccessoryLayout(const char* filePath = "/accessory.bin");
+    // configuration number to advertise layout with, one past the stored one when the layout
+    // differs from the last boot (wraps from 65535 to 1)
+    uint16_t apply(const uint8_t layout);
+    uint16_t getConfigNumber() const;
+    // the last apply() moved the number
+    bool isChanged() const;
+
+   private:
+    const char* _filePath;
+    AccessoryLayoutRecord _record;
+    bool _changed = false;
+    bool _read();
+    bool _write();
+  };
+
+  // global
+  extern AccessoryLayout accessoryLayout;
+
+} // namespace Victor::Components
+
+#endif // AccessoryLayout_h
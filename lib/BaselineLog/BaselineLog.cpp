@@ -0,0 +1,93 @@
+#include "BaselineLog.h"
+
+namespace Victor::Components {
+
+  static_assert(sizeof(BaselineRecord) == 8, "baseline record must stay 8 bytes");
+
+  BaselineLog::BaselineLog(const char* filePath) {
+    _filePath = filePath;
+  }
+
+  bool BaselineLog::read(uint16_t& co2, uint16_t& voc) {
+    auto file = LittleFS.open(_filePath, "r");
+    if (!file) {
+      return false;
+    }
+    auto found = false;
+    BaselineRecord record;
+    // normally the very last record, older ones only after a torn write
+    for (auto offset = file.size() / sizeof(record); offset > 0 && !found; offset--) {
+      file.seek((offset - 1) * sizeof(record), SeekSet);
+      found = (
+        file.read(reinterpret_cast<uint8_t*>(&record), sizeof(record)) == sizeof(record) &&
+        _isValid(record)
+      );
+    }
+    file.close();
+    if (found) {
+      co2 = record.co2;
+      voc = record.voc;
+    }
+    return found;
+  }
+
+  bool BaselineLog::append(const uint16_t co2, const uint16_t voc) {
+    BaselineRecord record;
+    record.co2 = co2;
+    record.voc = voc;
+    record.crc = crc16(reinterpret_cast<const uint8_t*>(&record), offsetof(BaselineRecord, crc));
+    const auto size = _size();
+    // full, or a torn tail that would misalign every later record
+    if (size / sizeof(record) >= BASELINE_LOG_CAPACITY || size % sizeof(record) != 0) {
+      return _compact(record);
+    }
+    auto file = LittleFS.open(_filePath, "a");
+    if (!file) {
+      return false;
+    }
+    const auto written = file.write(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+    file.close();
+    return written == sizeof(record);
+  }
+
+  size_t BaselineLog::count() {
+    return _size() / sizeof(BaselineRecord);
+  }
+
+  size_t BaselineLog::_size() {
+    auto file = LittleFS.open(_filePath, "r");
+    if (!file) {
+      return 0;
+    }
+    const auto size = file.size();
+    file.close();
+    return size;
+  }
+
+  bool BaselineLog::_compact(const BaselineRecord& latest) {
+    // write aside then rename over, littlefs renames atomically
+    // so a power cut keeps either the old or the new log
+    const auto tempPath = String(_filePath) + F(".tmp");
+    auto file = LittleFS.open(tempPath.c_str(), "w");
+    if (!file) {
+      return false;
+    }
+    const auto written = file.write(reinterpret_cast<const uint8_t*>(&latest), sizeof(latest));
+    file.close();
+    if (written != sizeof(latest)) {
+      return false;
+    }
+    return LittleFS.rename(tempPath.c_str(), _filePath);
+  }
+
+  bool BaselineLog::_isValid(const BaselineRecord& record) {
+    return (
+      record.magic == BASELINE_RECORD_MAGIC &&
+      record.crc == crc16(reinterpret_cast<const uint8_t*>(&record), offsetof(BaselineRecord, crc))
+    );
+  }
+
+  // global
+  BaselineLog baselineLog;
+
+} // namespace Victor::Components
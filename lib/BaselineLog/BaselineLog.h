@@ -0,0 +1,48 @@
+#ifndef BaselineLog_h
+#define BaselineLog_h
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "Crc16.h"
+
+// records kept before the log is compacted down to the latest one
+#ifndef BASELINE_LOG_CAPACITY
+#define BASELINE_LOG_CAPACITY 64
+#endif
+
+#define BASELINE_RECORD_MAGIC 0xB1
+
+namespace Victor::Components {
+
+  struct BaselineRecord {
+    uint8_t magic = BASELINE_RECORD_MAGIC;
+    uint8_t reserved = 0;
+    uint16_t co2 = 0;
+    uint16_t voc = 0;
+    uint16_t crc = 0; // crc16 of the bytes before
+  };
+
+  // append-only log of SGP30 IAQ baselines
+  // the latest record sits at the end of the file, so boot reads one record;
+  // a torn or corrupted tail is skipped by walking back over crc failures
+  class BaselineLog {
+   public:
+    BaselineLog(const char* filePath = "/baseline.log");
+    // latest valid record, false if there is none
+    bool read(uint16_t& co2, uint16_t& voc);
+    bool append(const uint16_t co2, const uint16_t voc);
+    size_t count();
+
+   private:
+    const char* _filePath;
+    size_t _size();
+    bool _compact(const BaselineRecord& latest);
+    static bool _isValid(const BaselineRecord& record);
+  };
+
+  // global
+  extern BaselineLog baselineLog;
+
+} // namespace Victor::Components
+
+#endif // BaselineLog_h
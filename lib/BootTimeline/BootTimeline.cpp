@@ -0,0 +1,66 @@
+#include "BootTimeline.h"
+
+namespace Victor::Components {
+
+  void BootTimeline::mark(const __FlashStringHelper* name) {
+    const BootMark mark = { .name = name, .micros = micros() };
+    if (_size > 0 && _marks[_size - 1].name == name) {
+      _marks[_size - 1] = mark;
+    } else if (_size < BOOT_TIMELINE_CAPACITY) {
+      _marks[_size++] = mark;
+    } else {
+      _marks[_size - 1] = mark;
+      _dropped++;
+    }
+  }
+
+  size_t BootTimeline::size() const {
+    return _size;
+  }
+
+  size_t BootTimeline::getDropped() const {
+    return _dropped;
+  }
+
+  const BootMark& BootTimeline::at(const size_t index) const {
+    return _marks[index];
+  }
+
+  void BootTimeline::clear() {
+    _size = 0;
+    _dropped = 0;
+  }
+
+  void BootTimeline::print() const {
+    for (size_t i = 0; i < _size; i++) {
+      const auto& mark = _marks[i];
+      const auto delta = mark.micros - (i > 0 ? _marks[i - 1].micros : 0);
+      console.log()
+        .bracket(F("boot"))
+        .section(mark.name, String(mark.micros / 1000) + F("ms +") + String(delta / 1000) + F("ms"));
+    }
+  }
+
+  size_t BootTimeline::writeCsv(size_t& cursor, char* buffer, const size_t size) const {
+    size_t length = 0;
+    while (cursor < _size) {
+      const auto& mark = _marks[cursor];
+      const auto delta = mark.micros - (cursor > 0 ? _marks[cursor - 1].micros : 0);
+      const auto name = String(mark.name);
+      const auto written = snprintf(
+        buffer + length, size - length, "%lu.%lu,%lu.%lu,%s\n",
+        mark.micros / 1000, (mark.micros / 100) % 10, delta / 1000, (delta / 100) % 10, name.c_str()
+      );
+      if (written < 0 || length + written >= size) {
+        break; // next chunk
+      }
+      length += written;
+      cursor++;
+    }
+    return length;
+  }
+
+  // global
+  BootTimeline bootTimeline;
+
+} // namespace Victor::Components
@@ -0,0 +1,47 @@
+#ifndef BootTimeline_h
+#define BootTimeline_h
+
+#include <Arduino.h>
+#include <Console.h>
+
+#ifndef BOOT_TIMELINE_CAPACITY
+#define BOOT_TIMELINE_CAPACITY 16
+#endif
+
+// at and delta in milliseconds since power on
+#define BOOT_TIMELINE_CSV_HEADER "at,delta,phase\n"
+
+namespace Victor::Components {
+
+  struct BootMark {
+    const __FlashStringHelper* name;
+    unsigned long micros;
+  };
+
+  // timestamps of boot phases, fixed capacity so it can run before anything is set up
+  class BootTimeline {
+   public:
+    // a phase marked again right after itself (a retry) moves its mark,
+    // once full the last mark is overwritten so the final phases stay in
+    void mark(const __FlashStringHelper* name);
+    size_t size() const;
+    // marks overwritten for lack of room
+    size_t getDropped() const;
+    const BootMark& at(const size_t index) const;
+    void clear();
+    void print() const;
+    // csv lines from cursor into buffer, returns bytes written, 0 when done
+    size_t writeCsv(size_t& cursor, char* buffer, const size_t size) const;
+
+   private:
+    BootMark _marks[BOOT_TIMELINE_CAPACITY];
+    size_t _size = 0;
+    size_t _dropped = 0;
+  };
+
+  // global
+  extern BootTimeline bootTimeline;
+
+} // namespace Victor::Components
+
+#endif // BootTimeline_h
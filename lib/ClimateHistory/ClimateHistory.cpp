@@ -0,0 +1,99 @@
+#include "ClimateHistory.h"
+
+namespace Victor::Components {
+
+  static_assert(sizeof(HistorySample) == 8, "history sample must stay 8 bytes");
+
+  void ClimateHistory::record(const HistoryReading& reading, const unsigned long now) {
+    _samples[_head] = pack(reading, now);
+    _head = (_head + 1) % HISTORY_CAPACITY;
+    if (_count < HISTORY_CAPACITY) {
+      _count++;
+    }
+  }
+
+  size_t ClimateHistory::size() const {
+    return _count;
+  }
+
+  void ClimateHistory::clear() {
+    _head = 0;
+    _count = 0;
+  }
+
+  const HistorySample& ClimateHistory::at(const size_t index) const {
+    const auto oldest = (_head + HISTORY_CAPACITY - _count) % HISTORY_CAPACITY;
+    return _samples[(oldest + index) % HISTORY_CAPACITY];
+  }
+
+  HistorySample ClimateHistory::pack(const HistoryReading& reading, const unsigned long now) {
+    HistorySample sample;
+    sample.minute = now / 60000;
+    if (reading.hasHT) {
+      sample.temperature = lroundf(std::max<float>(-300, std::min<float>(300, reading.temperature)) * 100);
+      sample.humidity = lroundf(std::max<float>(0, std::min<float>(100, reading.humidity)) * 2);
+    } else {
+      sample.temperature = HISTORY_NO_TEMPERATURE;
+      sample.humidity = HISTORY_NO_HUMIDITY;
+    }
+    uint16_t co2 = HISTORY_NO_GAS;
+    uint16_t voc = HISTORY_NO_GAS;
+    if (reading.hasAQ) {
+      co2 = std::min<long>(HISTORY_NO_GAS - 1, std::max<long>(0, lroundf(reading.co2 / 4)));
+      voc = std::min<long>(HISTORY_NO_GAS - 1, std::max<long>(0, lroundf(reading.voc)));
+    }
+    sample.gas[0] = co2 >> 4;
+    sample.gas[1] = ((co2 & 0x0F) << 4) | (voc >> 8);
+    sample.gas[2] = voc & 0xFF;
+    return sample;
+  }
+
+  HistoryReading ClimateHistory::unpack(const HistorySample& sample) {
+    HistoryReading reading;
+    reading.hasHT = sample.temperature != HISTORY_NO_TEMPERATURE;
+    if (reading.hasHT) {
+      reading.temperature = sample.temperature / 100.0f;
+      reading.humidity = sample.humidity / 2.0f;
+    }
+    const uint16_t co2 = (sample.gas[0] << 4) | (sample.gas[1] >> 4);
+    const uint16_t voc = ((sample.gas[1] & 0x0F) << 8) | sample.gas[2];
+    reading.hasAQ = co2 != HISTORY_NO_GAS;
+    if (reading.hasAQ) {
+      reading.co2 = co2 * 4;
+      reading.voc = voc;
+    }
+    return reading;
+  }
+
+  size_t ClimateHistory::writeCsv(size_t& cursor, char* buffer, const size_t size, const unsigned long now) const {
+    size_t length = 0;
+    const uint16_t nowMinute = now / 60000;
+    while (cursor < _count) {
+      const auto& sample = at(cursor);
+      const auto reading = unpack(sample);
+      const uint16_t age = nowMinute - sample.minute;
+      char line[48];
+      int lineLength;
+      if (reading.hasHT && reading.hasAQ) {
+        lineLength = snprintf(line, sizeof(line), "%u,%.2f,%.1f,%.0f,%.0f\n", age, reading.temperature, reading.humidity, reading.co2, reading.voc);
+      } else if (reading.hasHT) {
+        lineLength = snprintf(line, sizeof(line), "%u,%.2f,%.1f,,\n", age, reading.temperature, reading.humidity);
+      } else if (reading.hasAQ) {
+        lineLength = snprintf(line, sizeof(line), "%u,,,%.0f,%.0f\n", age, reading.co2, reading.voc);
+      } else {
+        lineLength = snprintf(line, sizeof(line), "%u,,,,\n", age);
+      }
+      if (length + lineLength >= size) {
+        break;
+      }
+      memcpy(buffer + length, line, lineLength);
+      length += lineLength;
+      cursor++;
+    }
+    return length;
+  }
+
+  // global
+  ClimateHistory climateHistory;
+
+} // namespace Victor::Components
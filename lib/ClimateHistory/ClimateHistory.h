@@ -0,0 +1,66 @@
+#ifndef ClimateHistory_h
+#define ClimateHistory_h
+
+#include <Arduino.h>
+
+// 720 samples x 8 bytes = 5.6KB of static RAM for 24 hours at one sample per 2 minutes
+#ifndef HISTORY_CAPACITY
+#define HISTORY_CAPACITY 720
+#endif
+#ifndef HISTORY_PERIOD_SECONDS
+#define HISTORY_PERIOD_SECONDS 120
+#endif
+
+// age in minutes
+#define HISTORY_CSV_HEADER "age,t,h,co2,voc\n"
+
+// sentinels of a channel without reading
+#define HISTORY_NO_TEMPERATURE INT16_MIN
+#define HISTORY_NO_HUMIDITY    0xFF
+#define HISTORY_NO_GAS         0xFFF
+
+namespace Victor::Components {
+
+  // 8 bytes, fixed-point
+  struct HistorySample {
+    uint16_t minute;     // minutes since boot (wraps after ~45 days)
+    int16_t temperature; // 0.01 °C
+    uint8_t humidity;    // 0.5 %RH
+    uint8_t gas[3];      // co2 (12 bit, 4 ppm) and voc (12 bit, 1 ppb)
+  };
+
+  struct HistoryReading {
+    bool hasHT = false;
+    float temperature = 0;
+    float humidity = 0;
+    bool hasAQ = false;
+    float co2 = 0;
+    float voc = 0;
+  };
+
+  // RAM ring buffer of timestamped readings
+  class ClimateHistory {
+   public:
+    void record(const HistoryReading& reading, const unsigned long now);
+    size_t size() const;
+    void clear();
+    // sample by age order, 0 = oldest
+    const HistorySample& at(const size_t index) const;
+    static HistorySample pack(const HistoryReading& reading, const unsigned long now);
+    static HistoryReading unpack(const HistorySample& sample);
+    // format samples from cursor (0 = oldest) as HISTORY_CSV_HEADER lines into buffer,
+    // advances cursor and returns bytes written, 0 when done
+    size_t writeCsv(size_t& cursor, char* buffer, const size_t size, const unsigned long now) const;
+
+   private:
+    HistorySample _samples[HISTORY_CAPACITY];
+    size_t _head = 0; // next write
+    size_t _count = 0;
+  };
+
+  // global
+  extern ClimateHistory climateHistory;
+
+} // namespace Victor::Components
+
+#endif // ClimateHistory_h
@@ -0,0 +1,75 @@
+#include "ClimateMath.h"
+
+namespace Victor::Components {
+
+  // saturation vapor density (g/m³ * 65536) for -20~60°C in 1°C steps
+  // 1000 * 100 * 6.11 * 10^(7.5T / (237.7 + T)) / ((T + 273) * 461.5)
+  static const uint32_t PROGMEM saturationDensity[] = {
+    70179, 76197, 82668, 89619, 97083, 105091, 113677, 122875,
+    132724, 143262, 154530, 166571, 179429, 193152, 207789, 223390,
+    240009, 257702, 276529, 296548, 317824, 340423, 364414, 389868,
+    416860, 445468, 475772, 507855, 541805, 577713, 615671, 655777,
+    698131, 742839, 790007, 839748, 892177, 947415, 1005585, 1066815,
+    1131238, 1198990, 1270211, 1345048, 1423651, 1506174, 1592777, 1683624,
+    1778886, 1878735, 1983352, 2092922, 2207635, 2327685, 2453275, 2584610,
+    2721902, 2865370, 3015236, 3171731, 3335090, 3505554, 3683372, 3868796,
+    4062087, 4263511, 4473342, 4691858, 4919346, 5156099, 5402416, 5658602,
+    5924972, 6201845, 6489548, 6788415, 7098788, 7421014, 7755450, 8102458,
+    8462410,
+  };
+  static constexpr int32_t saturationDensitySize = sizeof(saturationDensity) / sizeof(saturationDensity[0]);
+
+  uint16_t ClimateMath::absoluteHumidity(int32_t centiCelsius, int32_t centiHumidity) {
+    centiCelsius = clamp(centiCelsius, CLIMATE_MATH_MIN_CENTI_CELSIUS, CLIMATE_MATH_MAX_CENTI_CELSIUS);
+    centiHumidity = clamp(centiHumidity, 0, 10000);
+    // quadratic through the 3 table points from index, rem in centi °C past the first
+    const auto offset = centiCelsius - CLIMATE_MATH_MIN_CENTI_CELSIUS;
+    const auto index = std::min<int32_t>(offset / 100, saturationDensitySize - 3);
+    const auto rem = offset - index * 100;
+    const auto f0 = static_cast<int32_t>(pgm_read_dword(&saturationDensity[index]));
+    const auto f1 = static_cast<int32_t>(pgm_read_dword(&saturationDensity[index + 1]));
+    const auto f2 = static_cast<int32_t>(pgm_read_dword(&saturationDensity[index + 2]));
+    const auto density = f0 + rem * (f1 - f0) / 100 + rem * (rem - 100) * (f2 - 2 * f1 + f0) / 20000;
+    // %RH to a 16 bit fraction, 53687 / 8192 ~ 65536 / 10000
+    const auto fraction = (static_cast<uint32_t>(centiHumidity) * 53687) >> 13;
+    // g/m³ * 65536 * fraction / 65536 -> g/m³ * 256
+    return static_cast<uint16_t>((static_cast<uint64_t>(density) * fraction + (1UL << 23)) >> 24);
+  }
+
+  uint32_t ClimateMath::toMilligrams(const uint16_t absoluteHumidity) {
+    return (static_cast<uint32_t>(absoluteHumidity) * 1000 + 128) >> 8;
+  }
+
+  int32_t ClimateMath::clamp(const int32_t value, const int32_t min, const int32_t max) {
+    return value < min ? min : value > max ? max : value;
+  }
+
+  int32_t ClimateMath::toCenti(const float value) {
+    return lroundf(value * 100);
+  }
+
+  int32_t ClimateMath::roundTo(const int32_t value, const int32_t step) {
+    if (step <= 1) {
+      return value;
+    }
+    // ties to even, a value already rounded to centi would otherwise be rounded up twice
+    const auto magnitude = value < 0 ? -value : value;
+    auto steps = magnitude / step;
+    const auto rem = magnitude - steps * step;
+    if (rem * 2 > step || (rem * 2 == step && (steps & 1))) {
+      steps++;
+    }
+    return (value < 0 ? -steps : steps) * step;
+  }
+
+  int32_t ClimateMath::divide(const int32_t value, const int32_t count) {
+    return value < 0 ? (value - count / 2) / count : (value + count / 2) / count;
+  }
+
+  String ClimateMath::toString(const int32_t centi) {
+    const auto absolute = centi < 0 ? -centi : centi;
+    const auto fraction = absolute % 100;
+    return (centi < 0 ? F("-") : F("")) + String(absolute / 100) + (fraction < 10 ? F(".0") : F(".")) + String(fraction);
+  }
+
+} // namespace Victor::Components
@@ -0,0 +1,35 @@
+#ifndef ClimateMath_h
+#define ClimateMath_h
+
+#include <Arduino.h>
+
+// range of the saturation vapor density table, centi °C
+#define CLIMATE_MATH_MIN_CENTI_CELSIUS -2000
+#define CLIMATE_MATH_MAX_CENTI_CELSIUS 6000
+
+namespace Victor::Components {
+
+  // integer only sensor math, the esp8266 has no fpu so every float/double op is a soft-float call
+  // temperature in centi °C (0.01), humidity in centi %RH (0.01)
+  class ClimateMath {
+   public:
+    // absolute humidity in the sgp30 8.8 fixed-point format (g/m³ * 256)
+    // magnus formula + ideal gas law, tabulated per 1°C and interpolated quadratically,
+    // within 1 lsb of the double computation over -20~60°C 0~100%RH (clamped outside)
+    static uint16_t absoluteHumidity(int32_t centiCelsius, int32_t centiHumidity);
+    // 8.8 g/m³ to mg/m³
+    static uint32_t toMilligrams(const uint16_t absoluteHumidity);
+    static int32_t clamp(const int32_t value, const int32_t min, const int32_t max);
+    // float settings to centi units, once at setup
+    static int32_t toCenti(const float value);
+    // nearest multiple of step, ties to even
+    static int32_t roundTo(const int32_t value, const int32_t step);
+    // value / count to nearest, halves away from zero, count > 0
+    static int32_t divide(const int32_t value, const int32_t count);
+    // "-12.34" without going through float
+    static String toString(const int32_t centi);
+  };
+
+} // namespace Victor::Components
+
+#endif // ClimateMath_h
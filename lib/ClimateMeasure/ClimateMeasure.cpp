@@ -0,0 +1,257 @@
+#include "ClimateMeasure.h"
+
+namespace Victor::Components {
+
+  String toAirQualityName(const uint8_t state) {
+    return (
+      state == AIR_QUALITY_EXCELLENT ? F("Excellent") :
+      state == AIR_QUALITY_GOOD      ? F("Good") :
+      state == AIR_QUALITY_FAIR      ? F("Fair") :
+      state == AIR_QUALITY_INFERIOR  ? F("Inferior") :
+      state == AIR_QUALITY_POOR      ? F("Poor") : F("Unknown")
+    );
+  }
+
+  AirQuality toAirQuality(const int32_t value) {
+    // 0 ~ 49
+    if (value < 49) {
+      return AIR_QUALITY_EXCELLENT;
+    }
+    // 50 ~ 99
+    if (value < 99) {
+      return AIR_QUALITY_GOOD;
+    }
+    // 100 ~ 299
+    if (value < 399) {
+      return AIR_QUALITY_FAIR;
+    }
+    // 300 ~ 599
+    if (value < 599) {
+      return AIR_QUALITY_INFERIOR;
+    }
+    // 600 ~ 1000
+    return AIR_QUALITY_POOR;
+  }
+
+  ClimateMeasure::ClimateMeasure(const ClimateSetting* setting, HTFusion* ht, AQSensor* aq) : _compensation(aq) {
+    _setting = setting;
+    _ht = ht;
+    _aq = aq;
+    const auto& revise = setting->revise;
+    _reviseTemperature = ClimateMath::toCenti(revise.temperature);
+    _reviseHumidity    = ClimateMath::toCenti(revise.humidity);
+    _reviseCO2         = ClimateMath::toCenti(revise.co2);
+    _reviseVOC         = ClimateMath::toCenti(revise.voc);
+    const auto& filter = setting->filter;
+    _temperatureFilter.setup(filter.temperature.median, filter.temperature.emaShift);
+    _humidityFilter.setup(filter.humidity.median, filter.humidity.emaShift);
+    _co2Filter.setup(filter.co2.median, filter.co2.emaShift);
+    _vocFilter.setup(filter.voc.median, filter.voc.emaShift);
+    if (_ht != nullptr) {
+      _ht->setOversample(filter.oversample);
+    }
+    if (_aq != nullptr) {
+      // g/m³ to 8.8
+      _aq->setHumidityDelta(lroundf(setting->compensation.absoluteHumidity * 256));
+    }
+    _homekit.setup(setting->notify);
+    _bus.subscribe(&_metrics);
+    _bus.subscribe(&_homekit);
+    if (_aq != nullptr) {
+      _bus.subscribe(&_compensation);
+    }
+    _bus.subscribe(&_log);
+    _bus.subscribe(&_history);
+  }
+
+  bool ClimateMeasure::begin() {
+    const auto now = millis();
+    auto scheduled = true;
+    metrics.track(&temperatureState, F("temperature"));
+    metrics.track(&humidityState, F("humidity"));
+    metrics.track(&carbonDioxideState, F("co2"));
+    metrics.track(&vocDensityState, F("voc"));
+    metrics.track(&airQualityState, F("air_quality"));
+    metrics.track(&temperatureActiveState, F("temperature_active"));
+    metrics.track(&humidityActiveState, F("humidity_active"));
+    metrics.track(&airQualityActiveState, F("air_quality_active"));
+    metrics.sensorReset(METRIC_SENSOR_HT);
+    metrics.sensorReset(METRIC_SENSOR_AQ);
+    if (_ht != nullptr) {
+      const auto& query = _setting->htQuery;
+      if (query.loopSeconds > 0) {
+        const auto interval = query.loopSeconds * 1000UL;
+        scheduled &= _scheduler.every(JOB_HT_MEASURE, interval, now, 0);
+      }
+      if (query.resetHours > 0) {
+        const auto interval = query.resetHours * 60UL * 60 * 1000;
+        scheduled &= _scheduler.every(JOB_HT_RESET, interval, now, interval);
+      }
+    }
+    if (_aq != nullptr) {
+      const auto& query = _setting->aqQuery;
+      if (query.loopSeconds > 0) {
+        // sampled at 1Hz, reported on the configured cadence right after a sample was read
+        scheduled &= _scheduler.every(JOB_AQ_SAMPLE, AQ_SAMPLE_INTERVAL_MILLIS, now, 0);
+        const auto interval = query.loopSeconds * 1000UL;
+        scheduled &= _scheduler.every(JOB_AQ_MEASURE, interval, now, _aq->getWaitMillis() + 1);
+      }
+      if (query.resetHours > 0) {
+        const auto interval = query.resetHours * 60UL * 60 * 1000;
+        scheduled &= _scheduler.every(JOB_AQ_RESET, interval, now, interval);
+      }
+      // the baseline is only ever ready while sampling
+      if (_setting->baseline.storeHours > 0 && query.loopSeconds > 0) {
+        const auto interval = _setting->baseline.storeHours * 60UL * 60 * 1000;
+        scheduled &= _scheduler.every(JOB_AQ_STORE, interval, now, interval);
+      }
+    }
+    if (_ht != nullptr || _aq != nullptr) {
+      const auto interval = HISTORY_PERIOD_SECONDS * 1000UL;
+      scheduled &= _scheduler.every(JOB_HISTORY, interval, now, interval);
+    }
+    return scheduled;
+  }
+
+  unsigned long ClimateMeasure::loop(const bool notify) {
+    // bounded, a job rescheduling itself for "now" must not spin here
+    for (auto i = 0; i < SCHEDULER_CAPACITY; i++) {
+      const auto job = nextJob();
+      if (job == SCHEDULER_NONE) {
+        break;
+      }
+      runJob(job, notify);
+    }
+    return getIdleMillis();
+  }
+
+  uint8_t ClimateMeasure::nextJob() {
+    return _scheduler.next(millis());
+  }
+
+  void ClimateMeasure::runJob(const uint8_t job, const bool notify) {
+    switch (job) {
+      case JOB_HT_MEASURE:
+      case JOB_HT_COLLECT:
+        measureHT(notify);
+        break;
+      case JOB_HT_RESET:
+        _scheduler.cancel(JOB_HT_COLLECT);
+        _ht->reset();
+        metrics.sensorReset(METRIC_SENSOR_HT);
+        break;
+      case JOB_AQ_SAMPLE:
+        // after a stalled loop the next sample can come due before the last result was read,
+        // a second measure_iaq would hand that pending collect the wrong result, this one is skipped
+        if (_aq->isConverting()) {
+          break;
+        }
+        _aq->sample();
+        if (_aq->isConverting()) {
+          _scheduler.after(JOB_AQ_COLLECT, _aq->getWaitMillis(), millis());
+        }
+        break;
+      case JOB_AQ_COLLECT:
+        if (_aq->isConverting()) {
+          _aq->sample(); // reads the result
+        }
+        break;
+      case JOB_AQ_MEASURE:
+        measureAQ(notify);
+        break;
+      case JOB_AQ_RESET:
+        _scheduler.cancel(JOB_AQ_COLLECT);
+        _aq->reset();
+        metrics.sensorReset(METRIC_SENSOR_AQ);
+        break;
+      case JOB_AQ_STORE:
+        if (_aq->storeBaseline()) {
+          const auto interval = _setting->baseline.storeHours * 60UL * 60 * 1000;
+          _scheduler.every(JOB_AQ_STORE, interval, millis(), interval);
+        } else {
+          // baseline not ready yet, try again after the next measure, at least a sample apart
+          auto delay = _setting->aqQuery.loopSeconds * 1000UL;
+          if (delay < AQ_SAMPLE_INTERVAL_MILLIS) {
+            delay = AQ_SAMPLE_INTERVAL_MILLIS;
+          }
+          _scheduler.after(JOB_AQ_STORE, delay + 1, millis());
+        }
+        break;
+      case JOB_HISTORY:
+        recordHistory();
+        break;
+      default:
+        break;
+    }
+  }
+
+  unsigned long ClimateMeasure::getIdleMillis() {
+    return _scheduler.idleMillis(millis());
+  }
+
+  void ClimateMeasure::recordHistory() {
+    _history.record(millis());
+  }
+
+  void ClimateMeasure::flushNotify() {
+    _homekit.flush();
+  }
+
+  const NotifyBatch& ClimateMeasure::getNotifyBatch() {
+    return _homekit.getBatch();
+  }
+
+  uint32_t ClimateMeasure::getRevision() const {
+    return _homekit.getRevision();
+  }
+
+  SensorBus& ClimateMeasure::getBus() {
+    return _bus;
+  }
+
+  void ClimateMeasure::measureHT(const bool notify) {
+    const auto state = _ht->measure();
+    if (_ht->isConverting()) {
+      _scheduler.after(JOB_HT_COLLECT, _ht->getWaitMillis(), millis());
+    }
+    if (state == MEASURE_SKIPPED) { return; }
+    SensorReading reading;
+    reading.type = SENSOR_READING_HT;
+    reading.ok = state == MEASURE_SUCCESS;
+    reading.millis = millis();
+    if (!reading.ok) {
+      // stale history must not leak into the readings after recovery
+      _temperatureFilter.reset();
+      _humidityFilter.reset();
+    } else {
+      const auto temperature = _temperatureFilter.push(_ht->getCentiTemperature()) + _reviseTemperature;
+      reading.temperature = ClimateMath::clamp(temperature, 0, 10000); // 0~100
+      const auto humidity = _humidityFilter.push(_ht->getCentiHumidity()) + _reviseHumidity;
+      reading.humidity = ClimateMath::clamp(humidity, 0, 10000); // 0~100
+    }
+    _homekit.setNotify(notify);
+    _bus.publish(reading);
+  }
+
+  void ClimateMeasure::measureAQ(const bool notify) {
+    const auto state = _aq->measure();
+    if (state == MEASURE_SKIPPED) { return; }
+    SensorReading reading;
+    reading.type = SENSOR_READING_AQ;
+    reading.ok = state == MEASURE_SUCCESS;
+    reading.millis = millis();
+    if (!reading.ok) {
+      _co2Filter.reset();
+      _vocFilter.reset();
+    } else {
+      const auto co2 = _co2Filter.push(_aq->getCO2() * 100) + _reviseCO2;
+      reading.co2 = ClimateMath::clamp(co2, 0, 10000000); // 0~100000
+      const auto voc = _vocFilter.push(_aq->getTVOC() * 100) + _reviseVOC;
+      reading.voc = ClimateMath::clamp(voc, 0, 100000); // 0~1000
+      reading.airQuality = toAirQuality(reading.voc / 100);
+    }
+    _homekit.setNotify(notify);
+    _bus.publish(reading);
+  }
+
+} // namespace Victor::Components
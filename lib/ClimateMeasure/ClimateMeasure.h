@@ -0,0 +1,94 @@
+#ifndef ClimateMeasure_h
+#define ClimateMeasure_h
+
+#include <arduino_homekit_server.h>
+#include "HTFusion.h"
+#include "AQSensor.h"
+#include "DeadlineScheduler.h"
+#include "SignalFilter.h"
+#include "SensorBus.h"
+#include "ClimateSinks.h"
+
+namespace Victor::Components {
+
+  enum AirQuality {
+    AIR_QUALITY_UNKNOWN   = 0,
+    AIR_QUALITY_EXCELLENT = 1,
+    AIR_QUALITY_GOOD      = 2,
+    AIR_QUALITY_FAIR      = 3,
+    AIR_QUALITY_INFERIOR  = 4,
+    AIR_QUALITY_POOR      = 5,
+  };
+
+  String toAirQualityName(const uint8_t state);
+  AirQuality toAirQuality(const int32_t value);
+
+  enum SensorJob {
+    JOB_HT_MEASURE = 0,
+    JOB_HT_COLLECT = 1,
+    JOB_HT_RESET   = 2,
+    JOB_AQ_MEASURE = 3,
+    JOB_AQ_RESET   = 4,
+    JOB_AQ_STORE   = 5,
+    JOB_HISTORY    = 6,
+    JOB_AQ_SAMPLE  = 7,
+    JOB_AQ_COLLECT = 8,
+    JOB_COUNT      = 9,
+  };
+  static_assert(JOB_COUNT <= SCHEDULER_CAPACITY, "every sensor job needs a scheduler slot");
+
+  // drives the sensors from one deadline scheduler and publishes every finished measure
+  // on its bus: homekit, metrics, aq compensation, log and history are its first sinks
+  class ClimateMeasure {
+   public:
+    ClimateMeasure(const ClimateSetting* setting, HTFusion* ht, AQSensor* aq);
+    // register the periodic sensor jobs from setting, call once the sensors are up
+    // the first measures are due right away so a reading shows up without waiting an interval
+    // false when a job could not be scheduled
+    bool begin();
+    // run every due job, returns millis until the next deadline
+    unsigned long loop(const bool notify);
+    // pop the earliest due job, SCHEDULER_NONE when nothing is due
+    uint8_t nextJob();
+    void runJob(const uint8_t job, const bool notify);
+    unsigned long getIdleMillis();
+    // read ht sensor and publish the reading, notify is for the homekit sink
+    void measureHT(const bool notify);
+    // read aq sensor and publish the reading
+    void measureAQ(const bool notify);
+    // append the latest readings to climateHistory
+    void recordHistory();
+    // hand the notifications collected since the last flush to the server
+    void flushNotify();
+    const NotifyBatch& getNotifyBatch();
+    // moves whenever a characteristic value changes, for caches of the displayed values
+    uint32_t getRevision() const;
+    // more consumers of the readings subscribe here
+    SensorBus& getBus();
+
+   private:
+    const ClimateSetting* _setting;
+    HTFusion* _ht;
+    AQSensor* _aq;
+    DeadlineScheduler _scheduler;
+    SensorBus _bus;
+    HomeKitSink _homekit;
+    MetricsSink _metrics;
+    CompensationSink _compensation;
+    LogSink _log;
+    HistorySink _history;
+    // revise offsets in centi units, converted from the float settings once
+    int32_t _reviseTemperature = 0;
+    int32_t _reviseHumidity = 0;
+    int32_t _reviseCO2 = 0;
+    int32_t _reviseVOC = 0;
+    // smoothing of the raw readings, before revise
+    SignalFilter _temperatureFilter;
+    SignalFilter _humidityFilter;
+    SignalFilter _co2Filter;
+    SignalFilter _vocFilter;
+  };
+
+} // namespace Victor::Components
+
+#endif // ClimateMeasure_h
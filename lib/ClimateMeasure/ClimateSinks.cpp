@@ -0,0 +1,112 @@
+#include "ClimateSinks.h"
+
+namespace Victor::Components {
+
+  void HomeKitSink::setup(const NotifyConfig& notify) {
+    const auto minMillis = notify.minSeconds * 1000UL;
+    const auto maxMillis = notify.maxSeconds * 1000UL;
+    _temperature.setup(ClimateMath::toCenti(notify.temperature), minMillis, maxMillis);
+    _humidity.setup(ClimateMath::toCenti(notify.humidity), minMillis, maxMillis);
+    _co2.setup(ClimateMath::toCenti(notify.co2), minMillis, maxMillis);
+    _voc.setup(ClimateMath::toCenti(notify.voc), minMillis, maxMillis);
+  }
+
+  void HomeKitSink::setNotify(const bool notify) {
+    _notify = notify;
+  }
+
+  void HomeKitSink::onReading(const SensorReading& reading) {
+    if (reading.type == SENSOR_READING_HT) {
+      _write(&temperatureActiveState, reading.ok);
+      _write(&humidityActiveState, reading.ok);
+      if (reading.ok) {
+        _temperature.write(reading.temperature, _notify);
+        _humidity.write(reading.humidity, _notify);
+      }
+    } else if (reading.type == SENSOR_READING_AQ) {
+      _write(&airQualityActiveState, reading.ok);
+      if (reading.ok) {
+        _co2.write(reading.co2, _notify);
+        _voc.write(reading.voc, _notify);
+        if (airQualityState.value.uint8_value != reading.airQuality) {
+          airQualityState.value.uint8_value = reading.airQuality;
+          _changes++;
+          if (_notify) {
+            _batch.add(&airQualityState);
+          }
+        }
+      }
+    }
+  }
+
+  void HomeKitSink::flush() {
+    _batch.flush();
+  }
+
+  const NotifyBatch& HomeKitSink::getBatch() const {
+    return _batch;
+  }
+
+  uint32_t HomeKitSink::getRevision() const {
+    return _changes + _temperature.getChanges() + _humidity.getChanges() + _co2.getChanges() + _voc.getChanges();
+  }
+
+  void HomeKitSink::_write(homekit_characteristic_t* characteristic, const bool value) {
+    if (characteristic->value.bool_value != value) {
+      characteristic->value.bool_value = value;
+      _changes++;
+      if (_notify) {
+        _batch.add(characteristic);
+      }
+    }
+  }
+
+  void MetricsSink::onReading(const SensorReading& reading) {
+    metrics.measured(
+      reading.type == SENSOR_READING_HT ? METRIC_SENSOR_HT : METRIC_SENSOR_AQ,
+      reading.ok ? MEASURE_SUCCESS : MEASURE_FAILED
+    );
+  }
+
+  void LogSink::onReading(const SensorReading& reading) {
+    if (!reading.ok) {
+      return;
+    }
+    if (reading.type == SENSOR_READING_HT) {
+      EVENT_LOG_INFO(LOG_EVENT_HT_READING, reading.humidity, reading.temperature);
+    } else if (reading.type == SENSOR_READING_AQ) {
+      EVENT_LOG_INFO(LOG_EVENT_AQ_READING, reading.voc, reading.co2);
+    }
+  }
+
+  CompensationSink::CompensationSink(AQSensor* aq) {
+    _aq = aq;
+  }
+
+  void CompensationSink::onReading(const SensorReading& reading) {
+    if (reading.type == SENSOR_READING_HT && reading.ok && _aq != nullptr) {
+      _aq->setRelHumidity(reading.humidity, reading.temperature);
+    }
+  }
+
+  void HistorySink::onReading(const SensorReading& reading) {
+    if (reading.type == SENSOR_READING_HT) {
+      _latest.hasHT = reading.ok;
+      if (reading.ok) {
+        _latest.temperature = reading.temperature * 0.01f;
+        _latest.humidity = reading.humidity * 0.01f;
+      }
+    } else if (reading.type == SENSOR_READING_AQ) {
+      _latest.hasAQ = reading.ok;
+      if (reading.ok) {
+        _latest.co2 = reading.co2 * 0.01f;
+        _latest.voc = reading.voc * 0.01f;
+      }
+    }
+  }
+
+  void HistorySink::record(const unsigned long now) {
+    climateHistory.record(_latest, now);
+  }
+
+} // namespace Victor::Components
@@ -0,0 +1,87 @@
+#ifndef ClimateSinks_h
+#define ClimateSinks_h
+
+#include <arduino_homekit_server.h>
+#include "SensorBus.h"
+#include "NotifyBatch.h"
+#include "NotifyChannel.h"
+#include "AQSensor.h"
+#include "ClimateHistory.h"
+#include "Metrics.h"
+#include "EventLog.h"
+
+// temperature
+extern "C" homekit_characteristic_t temperatureState;
+extern "C" homekit_characteristic_t temperatureActiveState;
+// humidity
+extern "C" homekit_characteristic_t humidityState;
+extern "C" homekit_characteristic_t humidityActiveState;
+// air quality
+extern "C" homekit_characteristic_t carbonDioxideState;
+extern "C" homekit_characteristic_t vocDensityState;
+extern "C" homekit_characteristic_t airQualityState;
+extern "C" homekit_characteristic_t airQualityActiveState;
+
+namespace Victor::Components {
+
+  // readings into the homekit characteristics, notified through the channels in one batch
+  class HomeKitSink : public SensorSink {
+   public:
+    void setup(const NotifyConfig& notify);
+    // queue notifications for the changes, off while nobody can be notified
+    void setNotify(const bool notify);
+    void onReading(const SensorReading& reading) override;
+    // hand the notifications collected since the last flush to the server
+    void flush();
+    const NotifyBatch& getBatch() const;
+    // moves whenever a characteristic value changes
+    uint32_t getRevision() const;
+
+   private:
+    bool _notify = false;
+    NotifyBatch _batch;
+    // active and air quality state changes, the channels count their own
+    uint32_t _changes = 0;
+    // steps as displayed by homekit, centi units
+    NotifyChannel _temperature = NotifyChannel(&temperatureState, 10, &_batch);
+    NotifyChannel _humidity    = NotifyChannel(&humidityState, 100, &_batch);
+    NotifyChannel _co2         = NotifyChannel(&carbonDioxideState, 100, &_batch);
+    NotifyChannel _voc         = NotifyChannel(&vocDensityState, 100, &_batch);
+    void _write(homekit_characteristic_t* characteristic, const bool value);
+  };
+
+  // measure success/failure per sensor
+  class MetricsSink : public SensorSink {
+   public:
+    void onReading(const SensorReading& reading) override;
+  };
+
+  // readings into the deferred event log
+  class LogSink : public SensorSink {
+   public:
+    void onReading(const SensorReading& reading) override;
+  };
+
+  // ht readings feed the humidity compensation of the aq sensor
+  class CompensationSink : public SensorSink {
+   public:
+    CompensationSink(AQSensor* aq);
+    void onReading(const SensorReading& reading) override;
+
+   private:
+    AQSensor* _aq;
+  };
+
+  // the latest readings, appended to climateHistory on the history period
+  class HistorySink : public SensorSink {
+   public:
+    void onReading(const SensorReading& reading) override;
+    void record(const unsigned long now);
+
+   private:
+    HistoryReading _latest;
+  };
+
+} // namespace Victor::Components
+
+#endif // ClimateSinks_h
@@ -0,0 +1,41 @@
+#include "NotifyBatch.h"
+
+namespace Victor::Components {
+
+  void NotifyBatch::add(homekit_characteristic_t* characteristic) {
+    _stats.requested++;
+    for (uint8_t i = 0; i < _count; i++) {
+      if (_pending[i] == characteristic) {
+        _stats.saved++;
+        metrics.notifySaved();
+        return;
+      }
+    }
+    if (_count >= NOTIFY_BATCH_CAPACITY) {
+      flush();
+    }
+    _pending[_count++] = characteristic;
+  }
+
+  void NotifyBatch::flush() {
+    if (_count == 0) {
+      return;
+    }
+    for (uint8_t i = 0; i < _count; i++) {
+      homekit_characteristic_notify(_pending[i], _pending[i]->value);
+      metrics.notified(_pending[i]);
+    }
+    _stats.sent += _count;
+    _stats.flushes++;
+    _count = 0;
+  }
+
+  bool NotifyBatch::isEmpty() const {
+    return _count == 0;
+  }
+
+  const NotifyStats& NotifyBatch::getStats() const {
+    return _stats;
+  }
+
+} // namespace Victor::Components
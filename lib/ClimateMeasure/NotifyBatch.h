@@ -0,0 +1,46 @@
+#ifndef NotifyBatch_h
+#define NotifyBatch_h
+
+#include <arduino_homekit_server.h>
+#include <Arduino.h>
+#include "Metrics.h"
+
+#ifndef NOTIFY_BATCH_CAPACITY
+#define NOTIFY_BATCH_CAPACITY 8
+#endif
+
+namespace Victor::Components {
+
+  struct NotifyStats {
+    // notifications the measure cycle asked for
+    unsigned long requested = 0;
+    // characteristics handed to the server, repeats within a flush dropped
+    unsigned long sent = 0;
+    // notifies saved by batching, repeats of a characteristic already pending
+    // (requested = sent + saved + pending)
+    unsigned long saved = 0;
+    // flushes that carried at least one characteristic
+    unsigned long flushes = 0;
+  };
+
+  // collects changed characteristics during a measure cycle and notifies them
+  // at the end of the loop pass; repeated changes of one characteristic within
+  // a cycle collapse into its latest value
+  // the server still gets one homekit_characteristic_notify per characteristic,
+  // how those go out on the wire is up to its event queue
+  class NotifyBatch {
+   public:
+    void add(homekit_characteristic_t* characteristic);
+    void flush();
+    bool isEmpty() const;
+    const NotifyStats& getStats() const;
+
+   private:
+    homekit_characteristic_t* _pending[NOTIFY_BATCH_CAPACITY] = {};
+    uint8_t _count = 0;
+    NotifyStats _stats;
+  };
+
+} // namespace Victor::Components
+
+#endif // NotifyBatch_h
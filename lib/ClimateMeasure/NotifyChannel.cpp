@@ -0,0 +1,53 @@
+#include "NotifyChannel.h"
+
+namespace Victor::Components {
+
+  NotifyChannel::NotifyChannel(homekit_characteristic_t* characteristic, const int32_t step, NotifyBatch* batch) {
+    _characteristic = characteristic;
+    _step = step;
+    _batch = batch;
+  }
+
+  void NotifyChannel::setup(const int32_t deadband, const unsigned long minMillis, const unsigned long maxMillis) {
+    _deadband = deadband;
+    _minMillis = minMillis;
+    _maxMillis = maxMillis;
+  }
+
+  bool NotifyChannel::write(const int32_t value, const bool notify) {
+    const auto rounded = ClimateMath::roundTo(value, _step);
+    const auto stored = rounded * 0.01f;
+    if (_characteristic->value.float_value != stored) {
+      _characteristic->value.float_value = stored;
+      _changes++;
+    }
+    if (!notify) {
+      return false;
+    }
+    const auto now = millis();
+    if (_hasNotified) {
+      const auto delta = rounded > _notifiedValue ? rounded - _notifiedValue : _notifiedValue - rounded;
+      if (delta == 0) {
+        return false;
+      }
+      const auto elapsed = now - _notifiedMillis;
+      if (_minMillis > 0 && elapsed < _minMillis) {
+        return false;
+      }
+      const auto flush = _maxMillis > 0 && elapsed >= _maxMillis;
+      if (!flush && delta < _deadband) {
+        return false;
+      }
+    }
+    _notifiedValue = rounded;
+    _notifiedMillis = now;
+    _hasNotified = true;
+    _batch->add(_characteristic);
+    return true;
+  }
+
+  uint32_t NotifyChannel::getChanges() const {
+    return _changes;
+  }
+
+} // namespace Victor::Components
@@ -0,0 +1,39 @@
+#ifndef NotifyChannel_h
+#define NotifyChannel_h
+
+#include <arduino_homekit_server.h>
+#include <Arduino.h>
+#include "NotifyBatch.h"
+#include "ClimateMath.h"
+
+namespace Victor::Components {
+
+  // gate between a sensor value and its characteristic notifications, in centi units
+  // values are rounded to the step homekit displays, then notified only
+  // when moved out of the deadband around the last notified value (hysteresis)
+  // and no sooner than minMillis, with maxMillis flushing small drifts
+  class NotifyChannel {
+   public:
+    NotifyChannel(homekit_characteristic_t* characteristic, const int32_t step, NotifyBatch* batch);
+    void setup(const int32_t deadband, const unsigned long minMillis, const unsigned long maxMillis);
+    // store the value and queue a notify if it passes the gate, returns queued or not
+    bool write(const int32_t value, const bool notify);
+    // times the stored (rounded) value moved, notified or not
+    uint32_t getChanges() const;
+
+   private:
+    homekit_characteristic_t* _characteristic;
+    int32_t _step;
+    NotifyBatch* _batch;
+    int32_t _deadband = 0;
+    unsigned long _minMillis = 0;
+    unsigned long _maxMillis = 0;
+    int32_t _notifiedValue = 0;
+    unsigned long _notifiedMillis = 0;
+    bool _hasNotified = false;
+    uint32_t _changes = 0;
+  };
+
+} // namespace Victor::Components
+
+#endif // NotifyChannel_h
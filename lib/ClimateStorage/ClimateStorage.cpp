@@ -2,76 +2,184 @@
 
 namespace Victor::Components {
 
-  ClimateStorage::ClimateStorage(const char* filePath) : FileStorage(filePath) {
-    _maxSize = 512;
+  ClimateStorage::ClimateStorage(const char* filePath) {
+    _filePath = filePath;
   }
 
-  void ClimateStorage::_serializeTo(const ClimateSetting* model, DynamicJsonDocument& doc) {
-    // sensors
-    doc[F("hts")] = model->htSensor;
-    doc[F("aqs")] = model->aqSensor;
-    // button
-    const JsonArray buttonArr = doc.createNestedArray(F("button"));
-    buttonArr[0] = model->buttonPin;
-    buttonArr[1] = model->buttonTrueValue;
-    // ht query
-    const JsonObject htObj = doc.createNestedObject(F("ht"));
-    htObj[F("loop")]  = model->htQuery->loopSeconds;
-    htObj[F("reset")] = model->htQuery->resetHours;
-    // aq query
-    const JsonObject aqObj = doc.createNestedObject(F("aq"));
-    aqObj[F("loop")]  = model->aqQuery->loopSeconds;
-    aqObj[F("reset")] = model->aqQuery->resetHours;
-    // revise
-    const JsonObject reviseObj = doc.createNestedObject(F("revise"));
-    reviseObj[F("h")]   = model->revise->humidity;
-    reviseObj[F("t")]   = model->revise->temperature;
-    reviseObj[F("co2")] = model->revise->co2;
-    reviseObj[F("voc")] = model->revise->voc;
-    // baseline
-    const JsonObject baselineObj = doc.createNestedObject(F("baseline"));
-    baselineObj[F("load")]  = model->baseline->load ? 1 : 0;
-    baselineObj[F("store")] = model->baseline->storeHours;
-    baselineObj[F("co2")]   = model->baseline->co2;
-    baselineObj[F("voc")]   = model->baseline->voc;
+  const ClimateSetting& ClimateStorage::load() {
+    if (_loaded) {
+      return _setting;
+    }
+    const auto heapBefore = ESP.getFreeHeap();
+    _setting = ClimateSetting();
+    auto file = LittleFS.open(_filePath, "r");
+    if (file) {
+      // on the heap for the parse only, the 4KB loop stack can not spare it
+      DynamicJsonDocument doc(CLIMATE_JSON_CAPACITY);
+      const auto error = deserializeJson(doc, file); // streams, no file sized buffer
+      file.close();
+      if (error) {
+        console.error()
+          .bracket(F("climate"))
+          .section(F("deserialize failed"), error.c_str());
+      } else {
+        _deserializeFrom(_setting, doc);
+      }
+    }
+    _validate(_setting);
+    _loaded = true;
+    _loadHeapBytes = static_cast<int32_t>(heapBefore) - static_cast<int32_t>(ESP.getFreeHeap());
+    return _setting;
+  }
+
+  void ClimateStorage::use(const ClimateSetting& model) {
+    _setting = model;
+    _validate(_setting);
+    _loaded = true;
+    _loadHeapBytes = 0;
   }
 
-  void ClimateStorage::_deserializeFrom(ClimateSetting* model, const DynamicJsonDocument& doc) {
+  void ClimateStorage::invalidate() {
+    _loaded = false;
+  }
+
+  int32_t ClimateStorage::getLoadHeapBytes() const {
+    return _loadHeapBytes;
+  }
+
+  void ClimateStorage::_deserializeFrom(ClimateSetting& model, const JsonDocument& doc) {
     // sensors
-    model->htSensor = doc[F("hts")];
-    model->aqSensor = doc[F("aqs")];
+    model.htSensor = doc[F("hts")];
+    model.aqSensor = doc[F("aqs")];
     // button
     const auto buttonArr = doc[F("button")];
-    model->buttonPin = buttonArr[0];
-    model->buttonTrueValue = buttonArr[1];
+    model.buttonPin = buttonArr[0];
+    model.buttonTrueValue = buttonArr[1];
     // ht query
     const auto htObj = doc[F("ht")];
-    model->htQuery = new QueryConfig({
+    model.htQuery = QueryConfig{
       .loopSeconds = htObj[F("loop")],
       .resetHours  = htObj[F("reset")],
-    });
+    };
     // aq query
     const auto aqObj = doc[F("aq")];
-    model->aqQuery = new QueryConfig({
+    model.aqQuery = QueryConfig{
       .loopSeconds = aqObj[F("loop")],
       .resetHours  = aqObj[F("reset")],
-    });
+    };
     // revise
     const auto reviseObj = doc[F("revise")];
-    model->revise = new ReviseConfig({
+    model.revise = ReviseConfig{
       .humidity    = reviseObj[F("h")],
       .temperature = reviseObj[F("t")],
       .co2         = reviseObj[F("co2")],
       .voc         = reviseObj[F("voc")],
-    });
+    };
     // baseline
     const auto baselineObj = doc[F("baseline")];
-    model->baseline = new AQBaseline({
+    model.baseline = AQBaseline{
       .load       = baselineObj[F("load")] == 1,
       .storeHours = baselineObj[F("store")],
       .co2        = baselineObj[F("co2")],
       .voc        = baselineObj[F("voc")],
-    });
+    };
+    // notify, files written before it existed fall back to defaults
+    const auto notifyObj = doc[F("notify")];
+    const NotifyConfig notifyDefault;
+    model.notify = NotifyConfig{
+      .temperature = notifyObj[F("t")]   | notifyDefault.temperature,
+      .humidity    = notifyObj[F("h")]   | notifyDefault.humidity,
+      .co2         = notifyObj[F("co2")] | notifyDefault.co2,
+      .voc         = notifyObj[F("voc")] | notifyDefault.voc,
+      .minSeconds  = notifyObj[F("min")] | notifyDefault.minSeconds,
+      .maxSeconds  = notifyObj[F("max")] | notifyDefault.maxSeconds,
+    };
+    // compensation
+    const auto compensationObj = doc[F("comp")];
+    const CompensationConfig compensationDefault;
+    model.compensation = CompensationConfig{
+      .absoluteHumidity = compensationObj[F("ah")] | compensationDefault.absoluteHumidity,
+    };
+    // filter, missing channels stay unfiltered
+    const auto filterObj = doc[F("filter")];
+    const FilterSetting filterDefault;
+    model.filter = FilterSetting{
+      .oversample  = filterObj[F("os")] | filterDefault.oversample,
+      .temperature = _deserializeFilter(filterObj[F("t")]),
+      .humidity    = _deserializeFilter(filterObj[F("h")]),
+      .co2         = _deserializeFilter(filterObj[F("co2")]),
+      .voc         = _deserializeFilter(filterObj[F("voc")]),
+    };
+    // fusion
+    const auto fusionObj = doc[F("fusion")];
+    const FusionConfig fusionDefault;
+    model.fusion.scan = fusionObj[F("scan")] == 1;
+    model.fusion.mode = static_cast<FusionMode>(fusionObj[F("mode")] | static_cast<uint8_t>(fusionDefault.mode));
+    const auto weightsArr = fusionObj[F("w")];
+    for (auto i = 0; i < FUSION_HT_MAX; i++) {
+      model.fusion.weights[i] = weightsArr[i] | fusionDefault.weights[i];
+    }
+    // sht30
+    const auto sht30Obj = doc[F("sht30")];
+    const Sht30Config sht30Default;
+    model.sht30.rate = static_cast<HTRate>(sht30Obj[F("rate")] | static_cast<uint8_t>(sht30Default.rate));
+    model.sht30.repeatability = static_cast<HTRepeatability>(sht30Obj[F("rep")] | static_cast<uint8_t>(sht30Default.repeatability));
+    // telemetry
+    const auto telemetryObj = doc[F("telemetry")];
+    const auto ipArr = telemetryObj[F("ip")];
+    const TelemetryConfig telemetryDefault;
+    for (auto i = 0; i < 4; i++) {
+      model.telemetry.ip[i] = ipArr[i] | telemetryDefault.ip[i];
+    }
+    model.telemetry.port         = telemetryObj[F("port")]  | telemetryDefault.port;
+    model.telemetry.batch        = telemetryObj[F("batch")] | telemetryDefault.batch;
+    model.telemetry.flushSeconds = telemetryObj[F("flush")] | telemetryDefault.flushSeconds;
+  }
+
+  FilterConfig ClimateStorage::_deserializeFilter(JsonVariantConst arr) {
+    const FilterConfig filterDefault;
+    return FilterConfig{
+      .median   = arr[0] | filterDefault.median,
+      .emaShift = arr[1] | filterDefault.emaShift,
+    };
+  }
+
+  void ClimateStorage::_validate(ClimateSetting& model) {
+    if (model.htSensor > HT_SENSOR_SHT30) {
+      model.htSensor = HT_SENSOR_OFF;
+    }
+    if (model.aqSensor > AQ_SENSOR_SGP30) {
+      model.aqSensor = AQ_SENSOR_OFF;
+    }
+    model.buttonTrueValue = model.buttonTrueValue > 0 ? HIGH : LOW;
+    // homekit steps are the finest a deadband can usefully be
+    model.notify.temperature = std::max<float>(0.1, model.notify.temperature);
+    model.notify.humidity    = std::max<float>(1, model.notify.humidity);
+    model.notify.co2         = std::max<float>(1, model.notify.co2);
+    model.notify.voc         = std::max<float>(1, model.notify.voc);
+    if (model.notify.maxSeconds > 0 && model.notify.maxSeconds < model.notify.minSeconds) {
+      model.notify.maxSeconds = model.notify.minSeconds;
+    }
+    // the 8.8 register tops out at 256 g/m³
+    model.compensation.absoluteHumidity = std::max<float>(0, std::min<float>(255, model.compensation.absoluteHumidity));
+    if (model.fusion.mode > FUSION_MEDIAN) {
+      model.fusion.mode = FUSION_MEAN;
+    }
+    if (model.sht30.rate > HT_RATE_10_MPS) {
+      model.sht30.rate = HT_RATE_SINGLE_SHOT;
+    }
+    if (model.sht30.repeatability > HT_REPEATABILITY_HIGH) {
+      model.sht30.repeatability = HT_REPEATABILITY_HIGH;
+    }
+    // frames are sized at compile time
+    model.telemetry.batch = std::max<uint8_t>(1, std::min<uint8_t>(TELEMETRY_BATCH_MAX, model.telemetry.batch));
+    model.telemetry.flushSeconds = std::max<uint16_t>(1, model.telemetry.flushSeconds);
+    // filter state is sized at compile time
+    model.filter.oversample = std::max<uint8_t>(1, std::min<uint8_t>(FILTER_OVERSAMPLE_MAX, model.filter.oversample));
+    for (auto channel : { &model.filter.temperature, &model.filter.humidity, &model.filter.co2, &model.filter.voc }) {
+      channel->median   = std::max<uint8_t>(1, std::min<uint8_t>(FILTER_MEDIAN_MAX, channel->median | 1));
+      channel->emaShift = std::min<uint8_t>(FILTER_EMA_SHIFT_MAX, channel->emaShift);
+    }
   }
 
   // global
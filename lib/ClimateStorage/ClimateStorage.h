@@ -1,7 +1,17 @@
 #ifndef ClimateStorage_h
 #define ClimateStorage_h
 
-#include <FileStorage.h>
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+#include <Console.h>
+#include <SignalFilter.h>
+
+// capacity of the document climate.json is parsed into
+#define CLIMATE_JSON_CAPACITY 1024
+// ht sensors the bus scan knows: aht10 0x38, sht30 0x44, sht30 0x45
+#define FUSION_HT_MAX 3
+// readings per telemetry frame, one udp datagram
+#define TELEMETRY_BATCH_MAX 32
 
 namespace Victor::Components {
 
@@ -53,6 +63,90 @@ namespace Victor::Components {
     uint16_t voc = 0; // (0~65535)
   };
 
+  struct NotifyConfig {
+    // minimum change against the last notified value before notifying again
+    float temperature = 0.1; // °C
+    float humidity    = 1;   // %RH
+    float co2         = 10;  // ppm
+    float voc         = 5;   // ppb
+    // seconds to hold back a change after the last notify
+    // 0 = disabled
+    uint16_t minSeconds = 0; // (0~65535)
+    // seconds after which any displayed change is notified even inside the deadband
+    // 0 = disabled
+    uint16_t maxSeconds = 0; // (0~65535)
+  };
+
+  struct CompensationConfig {
+    // change of absolute humidity before the aq sensor compensation is written again
+    // 0 = write whenever it changed
+    float absoluteHumidity = 0.1; // g/m³
+  };
+
+  struct FilterConfig {
+    // median window over the last readings, odd
+    // 1 = disabled
+    uint8_t median = 1; // (1~7)
+    // exponential moving average, alpha = 1 / 2^emaShift
+    // 0 = disabled
+    uint8_t emaShift = 0; // (0~6)
+  };
+
+  struct FilterSetting {
+    // ht conversions averaged into one reading
+    // 1 = disabled
+    uint8_t oversample = 1; // (1~8)
+    FilterConfig temperature;
+    FilterConfig humidity;
+    FilterConfig co2;
+    FilterConfig voc;
+  };
+
+  enum FusionMode {
+    FUSION_MEAN   = 0, // weighted mean
+    FUSION_MEDIAN = 1,
+  };
+
+  struct FusionConfig {
+    // probe the bus at boot and use every known sensor found,
+    // hts/aqs are the fallback when it finds none of a kind
+    bool scan = false;
+    FusionMode mode = FUSION_MEAN;
+    // weight of each ht sensor in FUSION_HT_MAX order, 0 = ignored
+    uint8_t weights[FUSION_HT_MAX] = { 1, 1, 1 };
+  };
+
+  enum HTRate {
+    HT_RATE_SINGLE_SHOT = 0, // one conversion per reading
+    HT_RATE_0_5_MPS     = 1, // periodic, measurements per second
+    HT_RATE_1_MPS       = 2,
+    HT_RATE_2_MPS       = 3,
+    HT_RATE_4_MPS       = 4,
+    HT_RATE_10_MPS      = 5,
+  };
+
+  enum HTRepeatability {
+    HT_REPEATABILITY_LOW    = 0,
+    HT_REPEATABILITY_MEDIUM = 1,
+    HT_REPEATABILITY_HIGH   = 2,
+  };
+
+  struct Sht30Config {
+    // periodic mode measures on its own, a reading is one short fetch of the latest result
+    HTRate rate = HT_RATE_SINGLE_SHOT;
+    // lower repeatability converts faster with more noise
+    HTRepeatability repeatability = HT_REPEATABILITY_HIGH;
+  };
+
+  struct TelemetryConfig {
+    // udp listener the frames go to, port 0 = off
+    uint8_t ip[4] = { 0, 0, 0, 0 };
+    uint16_t port = 0;
+    // a frame goes out once batch readings are in or the oldest waited flushSeconds
+    uint8_t batch = 16;
+    uint16_t flushSeconds = 60;
+  };
+
   struct ClimateSetting {
     // button input pin
     // 0~127 = gpio
@@ -63,19 +157,40 @@ namespace Victor::Components {
     uint8_t buttonTrueValue = 0; // (0~255)
     HTSensorType htSensor = HT_SENSOR_AHT10;
     AQSensorType aqSensor = AQ_SENSOR_SGP30;
-    QueryConfig* htQuery = nullptr;
-    QueryConfig* aqQuery = nullptr;
-    ReviseConfig* revise = nullptr;
-    AQBaseline* baseline = nullptr;
+    QueryConfig htQuery;
+    QueryConfig aqQuery;
+    ReviseConfig revise;
+    AQBaseline baseline;
+    NotifyConfig notify;
+    CompensationConfig compensation;
+    FilterSetting filter;
+    FusionConfig fusion;
+    Sht30Config sht30;
+    TelemetryConfig telemetry;
   };
 
-  class ClimateStorage : public FileStorage<ClimateSetting> {
+  // climate.json parsed once into one flat cached setting, the document is freed
+  // right after, so loading neither fragments the heap nor leaks per-section objects
+  class ClimateStorage {
    public:
     ClimateStorage(const char* filePath = "/climate.json");
+    // parsed and validated on first call, the cached instance afterwards
+    const ClimateSetting& load();
+    // adopt a setting decoded elsewhere (the binary config image) as the cache
+    void use(const ClimateSetting& model);
+    // drop the cache, next load parses the file again
+    void invalidate();
+    // free heap consumed across the first load (heap before - heap after)
+    int32_t getLoadHeapBytes() const;
 
    protected:
-    void _serializeTo(const ClimateSetting* model, DynamicJsonDocument& doc) override;
-    void _deserializeFrom(ClimateSetting* model, const DynamicJsonDocument& doc) override;
+    const char* _filePath;
+    ClimateSetting _setting;
+    bool _loaded = false;
+    int32_t _loadHeapBytes = 0;
+    void _deserializeFrom(ClimateSetting& model, const JsonDocument& doc);
+    void _validate(ClimateSetting& model);
+    static FilterConfig _deserializeFilter(JsonVariantConst arr);
   };
 
   // global
@@ -0,0 +1,334 @@
+#include "ConfigImage.h"
+
+namespace Victor::Components {
+
+  static_assert(sizeof(ConfigImageHeader) == 12, "config image header must stay 12 bytes");
+
+  namespace {
+
+    // fields go out little-endian in declaration order, later versions only ever append
+    struct ImageWriter {
+      uint8_t* buffer;
+      size_t size;
+      size_t length = 0;
+      template <typename T>
+      void put(const T value) {
+        if (length + sizeof(T) <= size) {
+          memcpy(buffer + length, &value, sizeof(T));
+        }
+        length += sizeof(T);
+      }
+    };
+
+    struct ImageReader {
+      const uint8_t* buffer;
+      size_t length;
+      size_t position = 0;
+      template <typename T>
+      bool get(T& value) {
+        if (position + sizeof(T) > length) {
+          return false;
+        }
+        memcpy(&value, buffer + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+      }
+    };
+
+  } // namespace
+
+  ConfigImage::ConfigImage(const char* filePath, const char* climatePath, const char* i2cPath) {
+    _filePath = filePath;
+    _climatePath = climatePath;
+    _i2cPath = i2cPath;
+  }
+
+  const ConfigImageModel& ConfigImage::load() {
+    if (_source != CONFIG_SOURCE_NONE) {
+      return _model;
+    }
+    const auto begin = micros();
+    if (_read() && _sourceVersion == CONFIG_IMAGE_VERSION) {
+      _source = CONFIG_SOURCE_IMAGE;
+      climateStorage.use(_model.climate);
+    } else {
+      // no valid image, or one of an older version whose missing fields are only in the json,
+      // _sourceVersion keeps telling a migration (older version) from a first boot (0)
+      _source = CONFIG_SOURCE_JSON;
+      _loadJson();
+      if (!_write(_sourceCrc())) {
+        console.error()
+          .bracket(F("config"))
+          .section(F("image write failed"));
+      }
+    }
+    _loadMicros = micros() - begin;
+    return _model;
+  }
+
+  bool ConfigImage::verify() {
+    if (_source != CONFIG_SOURCE_IMAGE) {
+      return true; // just generated from json
+    }
+    const auto sourceCrc = _sourceCrc();
+    if (sourceCrc == _imageSourceCrc) {
+      return true;
+    }
+    console.log()
+      .bracket(F("config"))
+      .section(F("json changed"));
+    const auto loaded = _model;
+    _loadJson();
+    const auto written = _write(sourceCrc);
+    // keep serving what this boot started with
+    _model = loaded;
+    climateStorage.use(_model.climate);
+    if (!written) {
+      // the old image would mismatch again on the next boot, no restart until a new one is in place
+      console.error()
+        .bracket(F("config"))
+        .section(F("image write failed"));
+      return true;
+    }
+    return false;
+  }
+
+  void ConfigImage::invalidate() {
+    _source = CONFIG_SOURCE_NONE;
+  }
+
+  ConfigSource ConfigImage::getSource() const {
+    return _source;
+  }
+
+  uint8_t ConfigImage::getSourceVersion() const {
+    return _sourceVersion;
+  }
+
+  unsigned long ConfigImage::getLoadMicros() const {
+    return _loadMicros;
+  }
+
+  size_t ConfigImage::encode(const ConfigImageModel& model, uint8_t* buffer, const size_t size, const uint8_t version) {
+    ImageWriter writer = { .buffer = buffer, .size = size };
+    const auto& climate = model.climate;
+    // version 1
+    writer.put<uint8_t>(climate.htSensor);
+    writer.put<uint8_t>(climate.aqSensor);
+    writer.put<int8_t>(climate.buttonPin);
+    writer.put<uint8_t>(climate.buttonTrueValue);
+    writer.put<uint8_t>(climate.htQuery.loopSeconds);
+    writer.put<uint8_t>(climate.htQuery.resetHours);
+    writer.put<uint8_t>(climate.aqQuery.loopSeconds);
+    writer.put<uint8_t>(climate.aqQuery.resetHours);
+    writer.put<float>(climate.revise.humidity);
+    writer.put<float>(climate.revise.temperature);
+    writer.put<float>(climate.revise.co2);
+    writer.put<float>(climate.revise.voc);
+    writer.put<uint8_t>(climate.baseline.load ? 1 : 0);
+    writer.put<uint8_t>(climate.baseline.storeHours);
+    writer.put<uint16_t>(climate.baseline.co2);
+    writer.put<uint16_t>(climate.baseline.voc);
+    writer.put<int8_t>(model.i2c.sdaPin);
+    writer.put<int8_t>(model.i2c.sclPin);
+    writer.put<int8_t>(model.i2c.enablePin);
+    writer.put<uint8_t>(model.i2c.enableTrueValue);
+    // version 2
+    if (version >= 2) {
+      writer.put<float>(climate.notify.temperature);
+      writer.put<float>(climate.notify.humidity);
+      writer.put<float>(climate.notify.co2);
+      writer.put<float>(climate.notify.voc);
+      writer.put<uint16_t>(climate.notify.minSeconds);
+      writer.put<uint16_t>(climate.notify.maxSeconds);
+    }
+    // version 3
+    if (version >= 3) {
+      writer.put<float>(climate.compensation.absoluteHumidity);
+    }
+    // version 4
+    if (version >= 4) {
+      writer.put<uint8_t>(climate.filter.oversample);
+      for (const auto channel : { &climate.filter.temperature, &climate.filter.humidity, &climate.filter.co2, &climate.filter.voc }) {
+        writer.put<uint8_t>(channel->median);
+        writer.put<uint8_t>(channel->emaShift);
+      }
+    }
+    // version 5
+    if (version >= 5) {
+      writer.put<uint8_t>(climate.fusion.scan ? 1 : 0);
+      writer.put<uint8_t>(climate.fusion.mode);
+      for (const auto weight : climate.fusion.weights) {
+        writer.put<uint8_t>(weight);
+      }
+    }
+    // version 6
+    if (version >= 6) {
+      writer.put<uint8_t>(climate.sht30.rate);
+      writer.put<uint8_t>(climate.sht30.repeatability);
+    }
+    // version 7
+    if (version >= 7) {
+      for (const auto octet : climate.telemetry.ip) {
+        writer.put<uint8_t>(octet);
+      }
+      writer.put<uint16_t>(climate.telemetry.port);
+      writer.put<uint8_t>(climate.telemetry.batch);
+      writer.put<uint16_t>(climate.telemetry.flushSeconds);
+    }
+    return writer.length <= size ? writer.length : 0;
+  }
+
+  bool ConfigImage::decode(ConfigImageModel& model, const uint8_t* buffer, const size_t length, const uint8_t version) {
+    if (version == 0 || version > CONFIG_IMAGE_VERSION) {
+      return false;
+    }
+    ImageReader reader = { .buffer = buffer, .length = length };
+    model = ConfigImageModel();
+    auto& climate = model.climate;
+    uint8_t htSensor = 0, aqSensor = 0, baselineLoad = 0;
+    auto ok = (
+      reader.get(htSensor) &&
+      reader.get(aqSensor) &&
+      reader.get(climate.buttonPin) &&
+      reader.get(climate.buttonTrueValue) &&
+      reader.get(climate.htQuery.loopSeconds) &&
+      reader.get(climate.htQuery.resetHours) &&
+      reader.get(climate.aqQuery.loopSeconds) &&
+      reader.get(climate.aqQuery.resetHours) &&
+      reader.get(climate.revise.humidity) &&
+      reader.get(climate.revise.temperature) &&
+      reader.get(climate.revise.co2) &&
+      reader.get(climate.revise.voc) &&
+      reader.get(baselineLoad) &&
+      reader.get(climate.baseline.storeHours) &&
+      reader.get(climate.baseline.co2) &&
+      reader.get(climate.baseline.voc) &&
+      reader.get(model.i2c.sdaPin) &&
+      reader.get(model.i2c.sclPin) &&
+      reader.get(model.i2c.enablePin) &&
+      reader.get(model.i2c.enableTrueValue)
+    );
+    if (ok && version >= 2) {
+      ok = (
+        reader.get(climate.notify.temperature) &&
+        reader.get(climate.notify.humidity) &&
+        reader.get(climate.notify.co2) &&
+        reader.get(climate.notify.voc) &&
+        reader.get(climate.notify.minSeconds) &&
+        reader.get(climate.notify.maxSeconds)
+      );
+    }
+    if (ok && version >= 3) {
+      ok = reader.get(climate.compensation.absoluteHumidity);
+    }
+    if (ok && version >= 4) {
+      ok = reader.get(climate.filter.oversample);
+      for (const auto channel : { &climate.filter.temperature, &climate.filter.humidity, &climate.filter.co2, &climate.filter.voc }) {
+        ok = ok && reader.get(channel->median) && reader.get(channel->emaShift);
+      }
+    }
+    uint8_t fusionScan = 0, fusionMode = 0;
+    if (ok && version >= 5) {
+      ok = reader.get(fusionScan) && reader.get(fusionMode);
+      for (auto& weight : climate.fusion.weights) {
+        ok = ok && reader.get(weight);
+      }
+    }
+    uint8_t sht30Rate = 0, sht30Repeatability = 0;
+    if (ok && version >= 6) {
+      ok = reader.get(sht30Rate) && reader.get(sht30Repeatability);
+    }
+    if (ok && version >= 7) {
+      for (auto& octet : climate.telemetry.ip) {
+        ok = ok && reader.get(octet);
+      }
+      ok = ok && reader.get(climate.telemetry.port) && reader.get(climate.telemetry.batch) && reader.get(climate.telemetry.flushSeconds);
+    }
+    climate.htSensor = static_cast<HTSensorType>(htSensor);
+    climate.aqSensor = static_cast<AQSensorType>(aqSensor);
+    climate.baseline.load = baselineLoad == 1;
+    if (version >= 5) {
+      climate.fusion.scan = fusionScan == 1;
+      climate.fusion.mode = static_cast<FusionMode>(fusionMode);
+    }
+    if (version >= 6) {
+      climate.sht30.rate = static_cast<HTRate>(sht30Rate);
+      climate.sht30.repeatability = static_cast<HTRepeatability>(sht30Repeatability);
+    }
+    return ok && reader.position == length;
+  }
+
+  uint16_t ConfigImage::_sourceCrc() {
+    uint16_t crc = CRC16_INIT;
+    uint8_t buffer[64];
+    for (const auto path : { _climatePath, _i2cPath }) {
+      auto file = LittleFS.open(path, "r");
+      if (!file) {
+        continue;
+      }
+      size_t length;
+      while ((length = file.read(buffer, sizeof(buffer))) > 0) {
+        crc = crc16(buffer, length, crc);
+      }
+      file.close();
+    }
+    return crc;
+  }
+
+  void ConfigImage::_loadJson() {
+    climateStorage.invalidate();
+    _model.climate = climateStorage.load();
+    I2cStorage i2cStorage(_i2cPath);
+    const auto i2c = i2cStorage.load();
+    _model.i2c = *i2c;
+    delete i2c;
+  }
+
+  bool ConfigImage::_read() {
+    auto file = LittleFS.open(_filePath, "r");
+    if (!file) {
+      return false;
+    }
+    ConfigImageHeader header;
+    uint8_t payload[CONFIG_IMAGE_PAYLOAD_MAX];
+    auto ok = file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header);
+    ok = ok && header.magic == CONFIG_IMAGE_MAGIC && header.length <= sizeof(payload);
+    ok = ok && file.read(payload, header.length) == header.length;
+    file.close();
+    ok = ok && header.crc == crc16(payload, header.length);
+    ok = ok && decode(_model, payload, header.length, header.version);
+    _sourceVersion = ok ? header.version : 0;
+    _imageSourceCrc = header.sourceCrc;
+    return ok;
+  }
+
+  bool ConfigImage::_write(const uint16_t sourceCrc) {
+    uint8_t payload[CONFIG_IMAGE_PAYLOAD_MAX];
+    ConfigImageHeader header;
+    header.length = encode(_model, payload, sizeof(payload));
+    header.sourceCrc = sourceCrc;
+    header.crc = crc16(payload, header.length);
+    if (header.length == 0) {
+      return false;
+    }
+    _imageSourceCrc = sourceCrc;
+    // written aside and renamed over, a power cut never leaves half an image behind
+    const auto tempPath = String(_filePath) + F(".tmp");
+    auto file = LittleFS.open(tempPath.c_str(), "w");
+    if (!file) {
+      return false;
+    }
+    auto written = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    written += file.write(payload, header.length);
+    file.close();
+    if (written != sizeof(header) + header.length) {
+      return false;
+    }
+    return LittleFS.rename(tempPath.c_str(), _filePath);
+  }
+
+  // global
+  ConfigImage configImage;
+
+} // namespace Victor::Components
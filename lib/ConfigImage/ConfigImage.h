@@ -0,0 +1,87 @@
+#ifndef ConfigImage_h
+#define ConfigImage_h
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Console.h>
+#include <I2cStorage/I2cStorage.h>
+#include "Crc16.h"
+#include "ClimateStorage.h"
+
+#define CONFIG_IMAGE_MAGIC 0x47464356 // "VCFG"
+// 1 = sensors, button, queries, revise, baseline
+// 2 = + notify
+// 3 = + compensation
+// 4 = + filter
+// 5 = + fusion
+// 6 = + sht30 rate/repeatability
+// 7 = + telemetry
+#define CONFIG_IMAGE_VERSION 7
+// encoded payload upper bound
+#define CONFIG_IMAGE_PAYLOAD_MAX 96
+
+namespace Victor::Components {
+
+  enum ConfigSource {
+    CONFIG_SOURCE_NONE  = 0,
+    CONFIG_SOURCE_IMAGE = 1, // decoded from the binary image
+    CONFIG_SOURCE_JSON  = 2, // parsed from json, image (re)generated
+  };
+
+  struct ConfigImageHeader {
+    uint32_t magic = CONFIG_IMAGE_MAGIC;
+    uint8_t version = CONFIG_IMAGE_VERSION;
+    uint8_t reserved = 0;
+    uint16_t length = 0;    // payload bytes
+    uint16_t sourceCrc = 0; // crc16 of the json files the image was generated from
+    uint16_t crc = 0;       // crc16 of the payload
+  };
+
+  struct ConfigImageModel {
+    ClimateSetting climate;
+    I2cSetting i2c;
+  };
+
+  // versioned binary encoding of climate.json and i2c.json
+  // json stays the editable source, boot decodes a few dozen bytes instead of running two json parses
+  // and the json bytes are checked against the image once setup is through
+  class ConfigImage {
+   public:
+    ConfigImage(const char* filePath = "/config.bin", const char* climatePath = "/climate.json", const char* i2cPath = "/i2c.json");
+    // a valid image as is, otherwise the json files (image regenerated)
+    // primes climateStorage with the climate setting
+    const ConfigImageModel& load();
+    // false when the json changed since the image was generated, the image is regenerated then
+    // and the new settings apply from the next boot; true when the new image could not be written,
+    // this boot keeps going on the current one
+    bool verify();
+    void invalidate();
+    ConfigSource getSource() const;
+    // version found in the image, lower than CONFIG_IMAGE_VERSION means it was migrated
+    uint8_t getSourceVersion() const;
+    unsigned long getLoadMicros() const;
+    // encode/decode the payload of a given schema version
+    static size_t encode(const ConfigImageModel& model, uint8_t* buffer, const size_t size, const uint8_t version = CONFIG_IMAGE_VERSION);
+    static bool decode(ConfigImageModel& model, const uint8_t* buffer, const size_t length, const uint8_t version);
+
+   private:
+    const char* _filePath;
+    const char* _climatePath;
+    const char* _i2cPath;
+    ConfigImageModel _model;
+    ConfigSource _source = CONFIG_SOURCE_NONE;
+    uint8_t _sourceVersion = 0;
+    uint16_t _imageSourceCrc = 0;
+    unsigned long _loadMicros = 0;
+    uint16_t _sourceCrc();
+    bool _read();
+    void _loadJson();
+    bool _write(const uint16_t sourceCrc);
+  };
+
+  // global
+  extern ConfigImage configImage;
+
+} // namespace Victor::Components
+
+#endif // ConfigImage_h
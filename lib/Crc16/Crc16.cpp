@@ -0,0 +1,15 @@
+#include "Crc16.h"
+
+namespace Victor::Components {
+
+  uint16_t crc16(const uint8_t* data, const size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; i++) {
+      crc ^= static_cast<uint16_t>(data[i]) << 8;
+      for (auto bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+      }
+    }
+    return crc;
+  }
+
+} // namespace Victor::Components
@@ -0,0 +1,15 @@
+#ifndef Crc16_h
+#define Crc16_h
+
+#include <Arduino.h>
+
+#define CRC16_INIT 0xFFFF
+
+namespace Victor::Components {
+
+  // CRC-16/CCITT-FALSE, pass the previous result as crc to continue over several buffers
+  uint16_t crc16(const uint8_t* data, const size_t length, uint16_t crc = CRC16_INIT);
+
+} // namespace Victor::Components
+
+#endif // Crc16_h
@@ -0,0 +1,128 @@
+#include <limits.h>
+#include "DeadlineScheduler.h"
+
+namespace Victor::Components {
+
+  bool DeadlineScheduler::every(const uint8_t id, const unsigned long interval, const unsigned long now, const unsigned long delay) {
+    cancel(id);
+    return _push({
+      .deadline = now + delay,
+      .interval = interval,
+      .id = id,
+    });
+  }
+
+  bool DeadlineScheduler::after(const uint8_t id, const unsigned long delay, const unsigned long now) {
+    cancel(id);
+    return _push({
+      .deadline = now + delay,
+      .interval = 0,
+      .id = id,
+    });
+  }
+
+  void DeadlineScheduler::cancel(const uint8_t id) {
+    const auto index = _indexOf(id);
+    if (index >= 0) {
+      _removeAt(index);
+    }
+  }
+
+  bool DeadlineScheduler::has(const uint8_t id) const {
+    return _indexOf(id) >= 0;
+  }
+
+  uint8_t DeadlineScheduler::next(const unsigned long now) {
+    if (_size == 0 || _before(now, _heap[0].deadline)) {
+      return SCHEDULER_NONE;
+    }
+    auto job = _heap[0];
+    _removeAt(0);
+    if (job.interval > 0) {
+      // keep the cadence fixed, drop whole periods when running late
+      do {
+        job.deadline += job.interval;
+      } while (!_before(now, job.deadline));
+      _push(job);
+    }
+    return job.id;
+  }
+
+  unsigned long DeadlineScheduler::idleMillis(const unsigned long now) const {
+    if (_size == 0) {
+      return ULONG_MAX;
+    }
+    return _before(now, _heap[0].deadline) ? _heap[0].deadline - now : 0;
+  }
+
+  size_t DeadlineScheduler::size() const {
+    return _size;
+  }
+
+  bool DeadlineScheduler::_push(const DeadlineJob& job) {
+    if (_size >= SCHEDULER_CAPACITY) {
+      // a lost job silently stops a sensor, never expected
+      console.error()
+        .bracket(F("scheduler"))
+        .section(F("full, job dropped"), String(job.id));
+      return false;
+    }
+    _heap[_size] = job;
+    _siftUp(_size++);
+    return true;
+  }
+
+  void DeadlineScheduler::_removeAt(const size_t index) {
+    _size--;
+    if (index == _size) {
+      return;
+    }
+    _heap[index] = _heap[_size];
+    _siftDown(index);
+    _siftUp(index);
+  }
+
+  int DeadlineScheduler::_indexOf(const uint8_t id) const {
+    for (size_t i = 0; i < _size; i++) {
+      if (_heap[i].id == id) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  void DeadlineScheduler::_siftUp(size_t index) {
+    while (index > 0) {
+      const auto parent = (index - 1) / 2;
+      if (!_before(_heap[index].deadline, _heap[parent].deadline)) {
+        break;
+      }
+      std::swap(_heap[index], _heap[parent]);
+      index = parent;
+    }
+  }
+
+  void DeadlineScheduler::_siftDown(size_t index) {
+    while (true) {
+      const auto left = index * 2 + 1;
+      const auto right = left + 1;
+      auto smallest = index;
+      if (left < _size && _before(_heap[left].deadline, _heap[smallest].deadline)) {
+        smallest = left;
+      }
+      if (right < _size && _before(_heap[right].deadline, _heap[smallest].deadline)) {
+        smallest = right;
+      }
+      if (smallest == index) {
+        break;
+      }
+      std::swap(_heap[index], _heap[smallest]);
+      index = smallest;
+    }
+  }
+
+  bool DeadlineScheduler::_before(const unsigned long a, const unsigned long b) {
+    return static_cast<long>(a - b) < 0;
+  }
+
+} // namespace Victor::Components
@@ -0,0 +1,54 @@
+#ifndef DeadlineScheduler_h
+#define DeadlineScheduler_h
+
+#include <Arduino.h>
+#include <Console.h>
+
+// one slot per job id, owners check their job count against it at compile time
+#ifndef SCHEDULER_CAPACITY
+#define SCHEDULER_CAPACITY 12
+#endif
+
+#define SCHEDULER_NONE 0xFF
+
+namespace Victor::Components {
+
+  struct DeadlineJob {
+    unsigned long deadline = 0;
+    // 0 = one-shot
+    unsigned long interval = 0;
+    uint8_t id = SCHEDULER_NONE;
+  };
+
+  // fixed capacity min-heap of job deadlines (millis)
+  // deadlines compare wrap-safe, so they must stay within ~24 days of each other
+  class DeadlineScheduler {
+   public:
+    // periodic job, first due after delay; replaces a pending job with the same id
+    // false (and logged) when the scheduler is full
+    bool every(const uint8_t id, const unsigned long interval, const unsigned long now, const unsigned long delay);
+    // one-shot job; replaces a pending job with the same id, false when full
+    bool after(const uint8_t id, const unsigned long delay, const unsigned long now);
+    void cancel(const uint8_t id);
+    bool has(const uint8_t id) const;
+    // pop the earliest due job, SCHEDULER_NONE when nothing is due
+    // periodic jobs are pushed back on their fixed cadence
+    uint8_t next(const unsigned long now);
+    // millis until the earliest deadline, 0 = due, ULONG_MAX = empty
+    unsigned long idleMillis(const unsigned long now) const;
+    size_t size() const;
+
+   private:
+    DeadlineJob _heap[SCHEDULER_CAPACITY];
+    size_t _size = 0;
+    bool _push(const DeadlineJob& job);
+    void _removeAt(const size_t index);
+    int _indexOf(const uint8_t id) const;
+    void _siftUp(size_t index);
+    void _siftDown(size_t index);
+    static bool _before(const unsigned long a, const unsigned long b);
+  };
+
+} // namespace Victor::Components
+
+#endif // DeadlineScheduler_h
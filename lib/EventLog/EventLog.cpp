@@ -0,0 +1,82 @@
+#include "EventLog.h"
+
+namespace Victor::Components {
+
+  struct LogEventFormat {
+    const char* tag;
+    const char* names[2];
+  };
+
+  // indexed by LogEvent, the same text console.log() printed before
+  static const char htTag[] PROGMEM = "ht";
+  static const char aqTag[] PROGMEM = "aq";
+  static const char hName[] PROGMEM = "h";
+  static const char tName[] PROGMEM = "t";
+  static const char vocName[] PROGMEM = "voc";
+  static const char co2Name[] PROGMEM = "co2";
+  static const LogEventFormat formats[LOG_EVENT_COUNT] = {
+    { .tag = htTag, .names = { hName, tName } },
+    { .tag = aqTag, .names = { vocName, co2Name } },
+  };
+
+  const char* EventLog::formatCenti(char* buffer, const size_t size, const int32_t centi) {
+    const uint32_t absolute = centi < 0 ? -static_cast<int64_t>(centi) : centi;
+    snprintf(buffer, size, "%s%lu.%02lu", centi < 0 ? "-" : "", static_cast<unsigned long>(absolute / 100), static_cast<unsigned long>(absolute % 100));
+    return buffer;
+  }
+
+  void EventLog::write(const LogEvent event, const uint8_t level, const int32_t a, const int32_t b) {
+    const auto index = (_head + _size) % EVENT_LOG_CAPACITY;
+    if (_size < EVENT_LOG_CAPACITY) {
+      _size++;
+    } else {
+      _head = (_head + 1) % EVENT_LOG_CAPACITY;
+      _dropped++;
+    }
+    auto& entry = _entries[index];
+    entry.millis = millis();
+    entry.event = event;
+    entry.level = level;
+    entry.args[0] = a;
+    entry.args[1] = b;
+  }
+
+  uint8_t EventLog::flush(const uint8_t max) {
+    uint8_t printed = 0;
+    char value[16];
+    while (_size > 0 && printed < max) {
+      const auto& entry = _entries[_head];
+      _head = (_head + 1) % EVENT_LOG_CAPACITY;
+      _size--;
+      printed++;
+      if (entry.event >= LOG_EVENT_COUNT) {
+        continue;
+      }
+      const auto& format = formats[entry.event];
+      auto& line = entry.level == EVENT_LOG_LEVEL_ERROR ? console.error() : console.log();
+      line.bracket(FPSTR(format.tag));
+      for (auto i = 0; i < 2; i++) {
+        line.section(FPSTR(format.names[i]), formatCenti(value, sizeof(value), entry.args[i]));
+      }
+    }
+    return printed;
+  }
+
+  uint8_t EventLog::size() const {
+    return _size;
+  }
+
+  uint32_t EventLog::getDropped() const {
+    return _dropped;
+  }
+
+  void EventLog::clear() {
+    _head = 0;
+    _size = 0;
+    _dropped = 0;
+  }
+
+  // global
+  EventLog eventLog;
+
+} // namespace Victor::Components
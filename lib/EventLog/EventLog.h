@@ -0,0 +1,78 @@
+#ifndef EventLog_h
+#define EventLog_h
+
+#include <Arduino.h>
+#include <Console.h>
+
+#define EVENT_LOG_LEVEL_NONE  0
+#define EVENT_LOG_LEVEL_ERROR 1
+#define EVENT_LOG_LEVEL_INFO  2
+// events above the level compile to nothing, release builds keep errors only
+#ifndef EVENT_LOG_LEVEL
+#if defined(VICTOR_RELEASE)
+#define EVENT_LOG_LEVEL EVENT_LOG_LEVEL_ERROR
+#else
+#define EVENT_LOG_LEVEL EVENT_LOG_LEVEL_INFO
+#endif
+#endif
+// entries held until the loop is idle, the oldest is overwritten when full
+#ifndef EVENT_LOG_CAPACITY
+#define EVENT_LOG_CAPACITY 16
+#endif
+// entries formatted per idle loop pass
+#define EVENT_LOG_FLUSH_MAX 4
+
+#if EVENT_LOG_LEVEL >= EVENT_LOG_LEVEL_ERROR
+#define EVENT_LOG_ERROR(event, a, b) eventLog.write(event, EVENT_LOG_LEVEL_ERROR, a, b)
+#else
+#define EVENT_LOG_ERROR(event, a, b) do {} while (0)
+#endif
+#if EVENT_LOG_LEVEL >= EVENT_LOG_LEVEL_INFO
+#define EVENT_LOG_INFO(event, a, b) eventLog.write(event, EVENT_LOG_LEVEL_INFO, a, b)
+#else
+#define EVENT_LOG_INFO(event, a, b) do {} while (0)
+#endif
+
+namespace Victor::Components {
+
+  // what happened, the tag and argument names live in flash (see EventLog.cpp)
+  enum LogEvent {
+    LOG_EVENT_HT_READING = 0, // centi %RH, centi °C
+    LOG_EVENT_AQ_READING = 1, // centi ppb voc, centi ppm co2
+    LOG_EVENT_COUNT      = 2,
+  };
+
+  struct LogEntry {
+    uint32_t millis;
+    uint8_t event;
+    uint8_t level;
+    int32_t args[2];
+  };
+
+  // binary ring of events with fixed-point arguments: a write is a struct copy,
+  // the text is built later by flush() when the loop has nothing due
+  class EventLog {
+   public:
+    void write(const LogEvent event, const uint8_t level, const int32_t a, const int32_t b);
+    // format and print up to max entries, oldest first, returns entries printed
+    uint8_t flush(const uint8_t max = EVENT_LOG_FLUSH_MAX);
+    uint8_t size() const;
+    // overwritten before they were flushed
+    uint32_t getDropped() const;
+    void clear();
+    // centi value as "-12.34" into buffer, no String in between
+    static const char* formatCenti(char* buffer, const size_t size, const int32_t centi);
+
+   private:
+    LogEntry _entries[EVENT_LOG_CAPACITY];
+    uint8_t _head = 0;
+    uint8_t _size = 0;
+    uint32_t _dropped = 0;
+  };
+
+  // global
+  extern EventLog eventLog;
+
+} // namespace Victor::Components
+
+#endif // EventLog_h
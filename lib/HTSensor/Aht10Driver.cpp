@@ -0,0 +1,56 @@
+#include "Aht10Driver.h"
+
+#if !defined(VICTOR_HT_SHT30)
+
+namespace Victor::Components {
+
+  Aht10Driver::Aht10Driver(const HTSensorType type, const uint8_t address)
+    : _address(address > 0 ? address : AHT10_ADDRESS_0X38), _aht10(_address) {}
+
+  bool Aht10Driver::begin() {
+    return _aht10.begin();
+  }
+
+  void Aht10Driver::reset() {
+    _aht10.softReset();
+  }
+
+  bool Aht10Driver::trigger(unsigned long& waitMillis) {
+    _busyRetries = 0;
+    waitMillis = HT_AHT10_CONVERSION_MILLIS;
+    // AHT10 datasheet 5.4: trigger measurement 0xAC 0x33 0x00
+    Wire.beginTransmission(_address);
+    Wire.write(0xAC);
+    Wire.write(0x33);
+    Wire.write(0x00);
+    return Wire.endTransmission(true) == 0;
+  }
+
+  MeasureState Aht10Driver::collect(HTSample& sample, unsigned long& waitMillis) {
+    uint8_t data[6];
+    if (Wire.requestFrom(_address, static_cast<uint8_t>(6), true) != 6) {
+      return MEASURE_FAILED;
+    }
+    for (auto i = 0; i < 6; i++) {
+      data[i] = Wire.read();
+    }
+    // status bit[7] busy
+    if (data[0] & 0x80) {
+      if (++_busyRetries > HT_AHT10_BUSY_RETRY_LIMIT) {
+        return MEASURE_FAILED;
+      }
+      waitMillis = HT_AHT10_BUSY_RETRY_MILLIS;
+      return MEASURE_SKIPPED;
+    }
+    // 20 bit humidity followed by 20 bit temperature
+    const uint32_t rawHumidity = (static_cast<uint32_t>(data[1]) << 12) | (static_cast<uint32_t>(data[2]) << 4) | (data[3] >> 4);
+    const uint32_t rawTemperature = (static_cast<uint32_t>(data[3] & 0x0F) << 16) | (static_cast<uint32_t>(data[4]) << 8) | data[5];
+    // rh = 100 * raw / 2^20, t = 200 * raw / 2^20 - 50, in centi: 10000 / 2^20 = 625 / 2^16
+    sample.humidity = (rawHumidity * 625 + 0x8000) >> 16;
+    sample.temperature = static_cast<int32_t>((rawTemperature * 625 + 0x4000) >> 15) - 5000;
+    return MEASURE_SUCCESS;
+  }
+
+} // namespace Victor::Components
+
+#endif // !VICTOR_HT_SHT30
@@ -0,0 +1,43 @@
+#ifndef Aht10Driver_h
+#define Aht10Driver_h
+
+#if !defined(VICTOR_HT_SHT30)
+
+#include <Wire.h>
+#include <AHT10.h>
+#include "HTDriver.h"
+
+// datasheet conversion time of one aht10 measurement
+#define HT_AHT10_CONVERSION_MILLIS 80
+// wait again when aht10 still reports busy on collect
+#define HT_AHT10_BUSY_RETRY_MILLIS 10
+#define HT_AHT10_BUSY_RETRY_LIMIT  5
+
+namespace Victor::Components {
+
+  // register level aht10, the library is only used to bring it up and reset it
+  class Aht10Driver {
+   public:
+    // the type is fixed, callers check supports() against the setting
+    // address 0 = AHT10_ADDRESS_0X38
+    explicit Aht10Driver(const HTSensorType type = HT_SENSOR_AHT10, const uint8_t address = 0);
+    static bool supports(const HTSensorType type) { return type == HT_SENSOR_AHT10; }
+    uint8_t getAddress() const { return _address; }
+    // one fixed mode, nothing to configure
+    void configure(const Sht30Config& config) {}
+    bool begin();
+    void reset();
+    bool trigger(unsigned long& waitMillis);
+    MeasureState collect(HTSample& sample, unsigned long& waitMillis);
+
+   private:
+    uint8_t _address;
+    AHT10 _aht10;
+    uint8_t _busyRetries = 0;
+  };
+
+} // namespace Victor::Components
+
+#endif // !VICTOR_HT_SHT30
+
+#endif // Aht10Driver_h
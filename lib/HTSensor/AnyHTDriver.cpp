@@ -0,0 +1,52 @@
+#include "AnyHTDriver.h"
+
+#if !defined(VICTOR_HT_AHT10) && !defined(VICTOR_HT_SHT30)
+
+namespace Victor::Components {
+
+  AnyHTDriver::AnyHTDriver(const HTSensorType type, const uint8_t address) {
+    if (type == HT_SENSOR_AHT10) {
+      _driver = new HTDriverAdapter<Aht10Driver>(type, address);
+    } else if (type == HT_SENSOR_SHT30) {
+      _driver = new HTDriverAdapter<Sht30Driver>(type, address);
+    }
+  }
+
+  AnyHTDriver::~AnyHTDriver() {
+    if (_driver != nullptr) {
+      delete _driver;
+      _driver = nullptr;
+    }
+  }
+
+  uint8_t AnyHTDriver::getAddress() const {
+    return _driver != nullptr ? _driver->getAddress() : 0;
+  }
+
+  void AnyHTDriver::configure(const Sht30Config& config) {
+    if (_driver != nullptr) {
+      _driver->configure(config);
+    }
+  }
+
+  bool AnyHTDriver::begin() {
+    return _driver != nullptr && _driver->begin();
+  }
+
+  void AnyHTDriver::reset() {
+    if (_driver != nullptr) {
+      _driver->reset();
+    }
+  }
+
+  bool AnyHTDriver::trigger(unsigned long& waitMillis) {
+    return _driver != nullptr && _driver->trigger(waitMillis);
+  }
+
+  MeasureState AnyHTDriver::collect(HTSample& sample, unsigned long& waitMillis) {
+    return _driver != nullptr ? _driver->collect(sample, waitMillis) : MEASURE_FAILED;
+  }
+
+} // namespace Victor::Components
+
+#endif // !VICTOR_HT_AHT10 && !VICTOR_HT_SHT30
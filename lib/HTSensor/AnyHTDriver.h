@@ -0,0 +1,36 @@
+#ifndef AnyHTDriver_h
+#define AnyHTDriver_h
+
+#if !defined(VICTOR_HT_AHT10) && !defined(VICTOR_HT_SHT30)
+
+#include "Aht10Driver.h"
+#include "Sht30Driver.h"
+
+namespace Victor::Components {
+
+  // generic builds: the driver named by climate.json behind a virtual call
+  class AnyHTDriver {
+   public:
+    explicit AnyHTDriver(const HTSensorType type, const uint8_t address = 0);
+    ~AnyHTDriver();
+    // owns the driver, one delete per instance
+    AnyHTDriver(const AnyHTDriver&) = delete;
+    AnyHTDriver& operator=(const AnyHTDriver&) = delete;
+    static bool supports(const HTSensorType type) { return Aht10Driver::supports(type) || Sht30Driver::supports(type); }
+    // 0 without a driver
+    uint8_t getAddress() const;
+    void configure(const Sht30Config& config);
+    bool begin();
+    void reset();
+    bool trigger(unsigned long& waitMillis);
+    MeasureState collect(HTSample& sample, unsigned long& waitMillis);
+
+   private:
+    HTDriver* _driver = nullptr;
+  };
+
+} // namespace Victor::Components
+
+#endif // !VICTOR_HT_AHT10 && !VICTOR_HT_SHT30
+
+#endif // AnyHTDriver_h
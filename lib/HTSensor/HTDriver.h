@@ -0,0 +1,55 @@
+#ifndef HTDriver_h
+#define HTDriver_h
+
+#include <Arduino.h>
+#include "ClimateStorage.h"
+
+// VICTOR_HT_AHT10 / VICTOR_HT_SHT30 pin the ht driver at compile time,
+// without either flag both drivers are built and climate.json picks one at runtime
+#if defined(VICTOR_HT_AHT10) && defined(VICTOR_HT_SHT30)
+#error "define only one of VICTOR_HT_AHT10 and VICTOR_HT_SHT30"
+#endif
+
+namespace Victor::Components {
+
+  // one conversion, centi %RH / centi °C
+  struct HTSample {
+    int32_t humidity    = 0;
+    int32_t temperature = 0;
+  };
+
+  // what HTSensorT expects from a driver, concrete drivers implement it without virtuals
+  // so a pinned build inlines them; this interface only backs the runtime choice
+  class HTDriver {
+   public:
+    virtual ~HTDriver() {}
+    virtual uint8_t getAddress() const = 0;
+    // measuring mode, applied by the next begin()
+    virtual void configure(const Sht30Config& config) = 0;
+    virtual bool begin() = 0;
+    virtual void reset() = 0;
+    // start a conversion, waitMillis until it is worth collecting
+    virtual bool trigger(unsigned long& waitMillis) = 0;
+    // read a finished conversion, skipped with a new waitMillis while the sensor is still busy
+    virtual MeasureState collect(HTSample& sample, unsigned long& waitMillis) = 0;
+  };
+
+  // a concrete driver behind the virtual interface
+  template <class Driver>
+  class HTDriverAdapter : public HTDriver {
+   public:
+    HTDriverAdapter(const HTSensorType type, const uint8_t address) : _driver(type, address) {}
+    uint8_t getAddress() const override { return _driver.getAddress(); }
+    void configure(const Sht30Config& config) override { _driver.configure(config); }
+    bool begin() override { return _driver.begin(); }
+    void reset() override { _driver.reset(); }
+    bool trigger(unsigned long& waitMillis) override { return _driver.trigger(waitMillis); }
+    MeasureState collect(HTSample& sample, unsigned long& waitMillis) override { return _driver.collect(sample, waitMillis); }
+
+   private:
+    Driver _driver;
+  };
+
+} // namespace Victor::Components
+
+#endif // HTDriver_h
@@ -1,30 +1,243 @@
 #ifndef HTSensor_h
 #define HTSensor_h
 
-#include <AHT10.h>
-#include <SHT31.h>
-#include <Timer/IntervalOverAuto.h>
-#include "ClimateStorage.h"
+#include "HTDriver.h"
+#include "ClimateMath.h"
+#include "I2cBus.h"
+#if defined(VICTOR_HT_AHT10)
+#include "Aht10Driver.h"
+#elif defined(VICTOR_HT_SHT30)
+#include "Sht30Driver.h"
+#else
+#include "AnyHTDriver.h"
+#endif
 
 namespace Victor::Components {
 
-  class HTSensor {
+  enum HTPhase {
+    HT_PHASE_IDLE       = 0,
+    HT_PHASE_CONVERTING = 1,
+    HT_PHASE_RETRY      = 2, // backing off after a failed bus step
+  };
+
+  // split-phase measuring over one driver, the driver calls resolve at compile time
+  template <class Driver>
+  class HTSensorT {
    public:
-    HTSensor(HTSensorType type, QueryConfig* query);
-    ~HTSensor();
+    // address 0 = the driver default
+    HTSensorT(HTSensorType type, const uint8_t address = 0);
+    // whether this build carries a driver for the type
+    static bool supports(const HTSensorType type);
+    // sht30 single shot or periodic mode, applied by the next begin()
+    void configure(const Sht30Config& config);
     bool begin();
     void reset();
+    // split-phase: an idle sensor starts a conversion and returns skipped,
+    // a converting one collects the result once the conversion time has passed
+    // a failed bus step is retried with backoff, then once more after recovering
+    // the bus and the device, before the reading counts as failed
     MeasureState measure();
-    float getHumidity();
-    float getTemperature();
+    // a conversion or a retry is pending
+    bool isConverting();
+    // conversions averaged into one reading, run back to back, 1 = off
+    void setOversample(const uint8_t count);
+    // millis until a converting sensor is worth collecting
+    unsigned long getWaitMillis();
+    // last collected values, centi %RH / centi °C
+    int32_t getCentiHumidity();
+    int32_t getCentiTemperature();
+    // worst-case time spent inside measure() on the bus
+    unsigned long getMaxBlockMicros();
+    void resetMaxBlock();
 
    private:
-    IntervalOverAuto* _measureInterval = nullptr;
-    IntervalOverAuto* _resetInterval = nullptr;
-    AHT10* _aht10 = nullptr;
-    SHT31* _sht30 = nullptr;
+    Driver _driver;
+    HTPhase _phase = HT_PHASE_IDLE;
+    unsigned long _triggerMillis = 0;
+    unsigned long _waitMillis = 0;
+    // last conversion
+    HTSample _sample;
+    // last reading, averaged over the burst
+    int32_t _humidity = 0;
+    int32_t _temperature = 0;
+    uint8_t _oversample = 1;
+    uint8_t _burstCount = 0;
+    int32_t _burstHumidity = 0;
+    int32_t _burstTemperature = 0;
+    uint8_t _retries = 0;
+    bool _recovered = false;
+    unsigned long _maxBlockMicros = 0;
+    bool _trigger(unsigned long now);
+    MeasureState _collect(unsigned long now);
+    MeasureState _accumulate(unsigned long now);
+    MeasureState _retry(unsigned long now);
   };
 
+  template <class Driver>
+  HTSensorT<Driver>::HTSensorT(HTSensorType type, const uint8_t address) : _driver(type, address) {}
+
+  template <class Driver>
+  bool HTSensorT<Driver>::supports(const HTSensorType type) {
+    return Driver::supports(type);
+  }
+
+  template <class Driver>
+  void HTSensorT<Driver>::configure(const Sht30Config& config) {
+    _driver.configure(config);
+  }
+
+  template <class Driver>
+  bool HTSensorT<Driver>::begin() {
+    return _driver.begin();
+  }
+
+  template <class Driver>
+  void HTSensorT<Driver>::reset() {
+    _phase = HT_PHASE_IDLE;
+    _burstCount = 0;
+    _retries = 0;
+    _recovered = false;
+    _driver.reset();
+  }
+
+  template <class Driver>
+  MeasureState HTSensorT<Driver>::measure() {
+    const auto now = millis();
+    if (_phase != HT_PHASE_IDLE && now - _triggerMillis < _waitMillis) {
+      return MEASURE_SKIPPED;
+    }
+    const auto start = micros();
+    auto state = MEASURE_SKIPPED;
+    if (_phase == HT_PHASE_CONVERTING) {
+      state = _collect(now);
+    } else if (!_trigger(now)) {
+      state = MEASURE_FAILED;
+    }
+    i2cBus.record(_driver.getAddress(), state != MEASURE_FAILED, micros() - start);
+    if (state == MEASURE_SUCCESS) {
+      state = _accumulate(now);
+    } else if (state == MEASURE_FAILED) {
+      state = _retry(now);
+    }
+    _maxBlockMicros = std::max<unsigned long>(_maxBlockMicros, micros() - start);
+    return state;
+  }
+
+  template <class Driver>
+  bool HTSensorT<Driver>::isConverting() {
+    return _phase != HT_PHASE_IDLE;
+  }
+
+  template <class Driver>
+  void HTSensorT<Driver>::setOversample(const uint8_t count) {
+    _oversample = std::max<uint8_t>(1, count);
+    _burstCount = 0;
+  }
+
+  template <class Driver>
+  unsigned long HTSensorT<Driver>::getWaitMillis() {
+    if (_phase == HT_PHASE_IDLE) {
+      return 0;
+    }
+    const auto elapsed = millis() - _triggerMillis;
+    return elapsed < _waitMillis ? _waitMillis - elapsed : 0;
+  }
+
+  template <class Driver>
+  bool HTSensorT<Driver>::_trigger(unsigned long now) {
+    _triggerMillis = now;
+    _phase = _driver.trigger(_waitMillis) ? HT_PHASE_CONVERTING : HT_PHASE_IDLE;
+    return _phase == HT_PHASE_CONVERTING;
+  }
+
+  template <class Driver>
+  MeasureState HTSensorT<Driver>::_collect(unsigned long now) {
+    const auto state = _driver.collect(_sample, _waitMillis);
+    if (state == MEASURE_SKIPPED) {
+      // still busy, the driver set the next wait
+      _triggerMillis = now;
+    } else {
+      _phase = HT_PHASE_IDLE;
+    }
+    return state;
+  }
+
+  template <class Driver>
+  MeasureState HTSensorT<Driver>::_accumulate(unsigned long now) {
+    if (_burstCount == 0) {
+      _burstHumidity = 0;
+      _burstTemperature = 0;
+    }
+    _burstHumidity += _sample.humidity;
+    _burstTemperature += _sample.temperature;
+    _burstCount++;
+    // next conversion of the burst, a failed trigger settles for what was collected
+    if (_burstCount < _oversample && _trigger(now)) {
+      return MEASURE_SKIPPED;
+    }
+    _humidity = ClimateMath::divide(_burstHumidity, _burstCount);
+    _temperature = ClimateMath::divide(_burstTemperature, _burstCount);
+    _burstCount = 0;
+    _retries = 0;
+    _recovered = false;
+    return MEASURE_SUCCESS;
+  }
+
+  template <class Driver>
+  MeasureState HTSensorT<Driver>::_retry(unsigned long now) {
+    const auto address = _driver.getAddress();
+    if (_retries >= I2C_BUS_RETRY_LIMIT) {
+      if (_recovered) {
+        // recovery did not help either, give up until the next reading
+        _phase = HT_PHASE_IDLE;
+        _burstCount = 0;
+        _retries = 0;
+        _recovered = false;
+        return MEASURE_FAILED;
+      }
+      // most likely a slave stuck mid-byte, clear the bus and bring the device up again
+      i2cBus.clear();
+      _driver.begin();
+      i2cBus.recovered(address);
+      _recovered = true;
+      _retries = 0;
+    }
+    i2cBus.retried(address);
+    _phase = HT_PHASE_RETRY;
+    _triggerMillis = now;
+    _waitMillis = I2cBus::backoffMillis(_retries++);
+    return MEASURE_SKIPPED;
+  }
+
+  template <class Driver>
+  int32_t HTSensorT<Driver>::getCentiHumidity() {
+    return _humidity;
+  }
+
+  template <class Driver>
+  int32_t HTSensorT<Driver>::getCentiTemperature() {
+    return _temperature;
+  }
+
+  template <class Driver>
+  unsigned long HTSensorT<Driver>::getMaxBlockMicros() {
+    return _maxBlockMicros;
+  }
+
+  template <class Driver>
+  void HTSensorT<Driver>::resetMaxBlock() {
+    _maxBlockMicros = 0;
+  }
+
+  // the driver this build uses, see HTDriver.h
+#if defined(VICTOR_HT_AHT10)
+  typedef HTSensorT<Aht10Driver> HTSensor;
+#elif defined(VICTOR_HT_SHT30)
+  typedef HTSensorT<Sht30Driver> HTSensor;
+#else
+  typedef HTSensorT<AnyHTDriver> HTSensor;
+#endif
+
 } // namespace Victor::Components
 
 #endif // HTSensor_h
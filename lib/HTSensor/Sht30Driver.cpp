@@ -0,0 +1,133 @@
+#include "Sht30Driver.h"
+
+#if !defined(VICTOR_HT_AHT10)
+
+namespace Victor::Components {
+
+  // SHT3x datasheet 4.3 / 4.5, [repeatability low, medium, high]
+  static const uint16_t singleShotCommands[] PROGMEM = { 0x2416, 0x240B, 0x2400 };
+  static const uint16_t periodicCommands[][3] PROGMEM = {
+    { 0x202F, 0x2024, 0x2032 }, // 0.5 mps
+    { 0x212D, 0x2126, 0x2130 }, // 1 mps
+    { 0x222B, 0x2220, 0x2236 }, // 2 mps
+    { 0x2329, 0x2322, 0x2334 }, // 4 mps
+    { 0x272A, 0x2721, 0x2737 }, // 10 mps
+  };
+
+  // crc-8 0x31, init 0xFF over each 2 byte word
+  static uint8_t crc8(const uint8_t* data) {
+    uint8_t crc = 0xFF;
+    for (auto i = 0; i < 2; i++) {
+      crc ^= data[i];
+      for (auto bit = 0; bit < 8; bit++) {
+        crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+      }
+    }
+    return crc;
+  }
+
+  Sht30Driver::Sht30Driver(const HTSensorType type, const uint8_t address)
+    : _address(address > 0 ? address : SHT_DEFAULT_ADDRESS) {}
+
+  void Sht30Driver::configure(const Sht30Config& config) {
+    _config = config;
+  }
+
+  bool Sht30Driver::begin() {
+    // the soft reset the library begins with is ignored by a periodic mode left running
+    // from before a warm restart, _restart() breaks it first
+    _sht30.begin(_address);
+    return _restart();
+  }
+
+  void Sht30Driver::reset() {
+    _restart();
+  }
+
+  bool Sht30Driver::trigger(unsigned long& waitMillis) {
+    _fetchRetries = 0;
+    const auto period = periodMillis(_config.rate);
+    if (period > 0) {
+      // nothing to start, wait for the next result unless one is already due
+      const auto elapsed = millis() - _fetchMillis;
+      waitMillis = elapsed < period ? period - elapsed : 0;
+      return true;
+    }
+    waitMillis = conversionMillis(_config.repeatability);
+    return _command(pgm_read_word(&singleShotCommands[_config.repeatability]));
+  }
+
+  MeasureState Sht30Driver::collect(HTSample& sample, unsigned long& waitMillis) {
+    const auto period = periodMillis(_config.rate);
+    if (period > 0 && !_command(0xE000)) { // fetch data
+      return MEASURE_FAILED;
+    }
+    uint8_t data[6];
+    if (Wire.requestFrom(_address, static_cast<uint8_t>(6), true) != 6) {
+      // periodic mode NACKs until the next result, the sensor clock runs a few % off
+      if (period > 0 && ++_fetchRetries <= HT_SHT30_FETCH_RETRY_LIMIT) {
+        waitMillis = period / 10;
+        return MEASURE_SKIPPED;
+      }
+      return MEASURE_FAILED;
+    }
+    for (auto i = 0; i < 6; i++) {
+      data[i] = Wire.read();
+    }
+    if (crc8(data) != data[2] || crc8(data + 3) != data[5]) {
+      return MEASURE_FAILED;
+    }
+    if (period > 0) {
+      _fetchMillis = millis();
+    }
+    const uint32_t rawTemperature = (static_cast<uint32_t>(data[0]) << 8) | data[1];
+    const uint32_t rawHumidity = (static_cast<uint32_t>(data[3]) << 8) | data[4];
+    // rh = 100 * raw / 2^16, t = 175 * raw / 2^16 - 45
+    sample.humidity = (rawHumidity * 10000 + 0x8000) >> 16;
+    sample.temperature = static_cast<int32_t>((rawTemperature * 17500 + 0x8000) >> 16) - 4500;
+    return MEASURE_SUCCESS;
+  }
+
+  unsigned long Sht30Driver::conversionMillis(const HTRepeatability repeatability) {
+    // 4.5 / 6.5 / 15.5 ms rounded up, plus a millis() tick as the wait starts before the command
+    return repeatability == HT_REPEATABILITY_LOW ? 6 : repeatability == HT_REPEATABILITY_MEDIUM ? 8 : 17;
+  }
+
+  unsigned long Sht30Driver::periodMillis(const HTRate rate) {
+    switch (rate) {
+      case HT_RATE_0_5_MPS: return 2000;
+      case HT_RATE_1_MPS:   return 1000;
+      case HT_RATE_2_MPS:   return 500;
+      case HT_RATE_4_MPS:   return 250;
+      case HT_RATE_10_MPS:  return 100;
+      default:              return 0;
+    }
+  }
+
+  bool Sht30Driver::_command(const uint16_t command) {
+    Wire.beginTransmission(_address);
+    Wire.write(static_cast<uint8_t>(command >> 8));
+    Wire.write(static_cast<uint8_t>(command & 0xFF));
+    return Wire.endTransmission(true) == 0;
+  }
+
+  bool Sht30Driver::_restart() {
+    // break (datasheet 4.7) ends periodic mode, the sensor takes 1ms before the next command
+    _command(0x3093);
+    delay(1);
+    return _sht30.reset() && _startPeriodic();
+  }
+
+  bool Sht30Driver::_startPeriodic() {
+    if (_config.rate == HT_RATE_SINGLE_SHOT) {
+      return true;
+    }
+    const auto started = _command(pgm_read_word(&periodicCommands[_config.rate - 1][_config.repeatability]));
+    // the first result is one period away
+    _fetchMillis = millis();
+    return started;
+  }
+
+} // namespace Victor::Components
+
+#endif // !VICTOR_HT_AHT10
@@ -0,0 +1,52 @@
+#ifndef Sht30Driver_h
+#define Sht30Driver_h
+
+#if !defined(VICTOR_HT_AHT10)
+
+#include <Wire.h>
+#include <SHT31.h>
+#include "HTDriver.h"
+
+// fetches NACKed in periodic mode before a result counts as missing
+#define HT_SHT30_FETCH_RETRY_LIMIT 5
+
+namespace Victor::Components {
+
+  // register level sht30, the library is only used to bring it up and reset it
+  // single shot without clock stretching, or periodic mode fetching the latest result
+  class Sht30Driver {
+   public:
+    // the type is fixed, callers check supports() against the setting
+    // address 0 = SHT_DEFAULT_ADDRESS
+    explicit Sht30Driver(const HTSensorType type = HT_SENSOR_SHT30, const uint8_t address = 0);
+    static bool supports(const HTSensorType type) { return type == HT_SENSOR_SHT30; }
+    uint8_t getAddress() const { return _address; }
+    // applied by the next begin()
+    void configure(const Sht30Config& config);
+    bool begin();
+    void reset();
+    bool trigger(unsigned long& waitMillis);
+    MeasureState collect(HTSample& sample, unsigned long& waitMillis);
+    // datasheet max conversion time of one measurement
+    static unsigned long conversionMillis(const HTRepeatability repeatability);
+    // 0 in single shot mode
+    static unsigned long periodMillis(const HTRate rate);
+
+   private:
+    uint8_t _address;
+    SHT31 _sht30;
+    Sht30Config _config;
+    // last periodic result fetched, or periodic mode started
+    unsigned long _fetchMillis = 0;
+    uint8_t _fetchRetries = 0;
+    bool _command(const uint16_t command);
+    // break, soft reset, then periodic mode again when configured
+    bool _restart();
+    bool _startPeriodic();
+  };
+
+} // namespace Victor::Components
+
+#endif // !VICTOR_HT_AHT10
+
+#endif // Sht30Driver_h
@@ -0,0 +1,151 @@
+#include "I2cBus.h"
+
+namespace Victor::Components {
+
+  static const uint32_t latencyBounds[I2C_BUS_LATENCY_BUCKETS - 1] PROGMEM = {
+    100, 200, 500, 1000, 2000, 5000, 10000,
+  };
+
+  void I2cBus::begin(const int8_t sdaPin, const int8_t sclPin) {
+    _sdaPin = sdaPin;
+    _sclPin = sclPin;
+    _wire();
+  }
+
+  void I2cBus::record(const uint8_t address, const bool ok, const unsigned long micros) {
+    const auto device = _slot(address);
+    if (device == nullptr) {
+      return;
+    }
+    device->transactions++;
+    device->errors += ok ? 0 : 1;
+    device->maxMicros = std::max<uint32_t>(device->maxMicros, micros);
+    uint8_t bucket = 0;
+    while (bucket < I2C_BUS_LATENCY_BUCKETS - 1 && micros >= pgm_read_dword(&latencyBounds[bucket])) {
+      bucket++;
+    }
+    device->latency[bucket]++;
+  }
+
+  void I2cBus::retried(const uint8_t address) {
+    const auto device = _slot(address);
+    if (device != nullptr) {
+      device->retries++;
+    }
+  }
+
+  void I2cBus::recovered(const uint8_t address) {
+    const auto device = _slot(address);
+    if (device != nullptr) {
+      device->recoveries++;
+    }
+  }
+
+  unsigned long I2cBus::backoffMillis(const uint8_t retry) {
+    return static_cast<unsigned long>(I2C_BUS_BACKOFF_MILLIS) << retry;
+  }
+
+  bool I2cBus::clear() {
+    _clears++;
+    if (_sdaPin < 0 || _sclPin < 0) {
+      return false;
+    }
+    // take the pins from the wire, both open drain so nothing is ever driven high
+    pinMode(_sdaPin, INPUT_PULLUP);
+    pinMode(_sclPin, OUTPUT_OPEN_DRAIN);
+    digitalWrite(_sclPin, HIGH);
+    for (auto i = 0; i < I2C_BUS_CLEAR_CLOCKS && digitalRead(_sdaPin) == LOW; i++) {
+      digitalWrite(_sclPin, LOW);
+      delayMicroseconds(5); // 100kHz
+      digitalWrite(_sclPin, HIGH);
+      delayMicroseconds(5);
+    }
+    const auto released = digitalRead(_sdaPin) == HIGH;
+    // STOP: sda rises while scl is high
+    pinMode(_sdaPin, OUTPUT_OPEN_DRAIN);
+    digitalWrite(_sdaPin, LOW);
+    delayMicroseconds(5);
+    digitalWrite(_sdaPin, HIGH);
+    delayMicroseconds(5);
+    _wire();
+    console.error()
+      .bracket(F("i2c"))
+      .section(F("bus clear"), released ? F("released") : F("still held"));
+    return released;
+  }
+
+  uint32_t I2cBus::getClears() const {
+    return _clears;
+  }
+
+  uint8_t I2cBus::size() const {
+    return _size;
+  }
+
+  const I2cDeviceStats& I2cBus::at(const uint8_t index) const {
+    return _devices[index];
+  }
+
+  const I2cDeviceStats* I2cBus::find(const uint8_t address) const {
+    for (uint8_t i = 0; i < _size; i++) {
+      if (_devices[i].address == address) {
+        return &_devices[i];
+      }
+    }
+    return nullptr;
+  }
+
+  size_t I2cBus::writeCsv(size_t& cursor, char* buffer, const size_t size) const {
+    size_t length = 0;
+    while (cursor < _size) {
+      const auto& device = _devices[cursor];
+      const auto& latency = device.latency;
+      const auto written = snprintf(
+        buffer + length, size - length, "0x%02x,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+        device.address,
+        static_cast<unsigned long>(device.transactions), static_cast<unsigned long>(device.errors),
+        static_cast<unsigned long>(device.retries), static_cast<unsigned long>(device.recoveries),
+        static_cast<unsigned long>(device.maxMicros),
+        static_cast<unsigned long>(latency[0]), static_cast<unsigned long>(latency[1]),
+        static_cast<unsigned long>(latency[2]), static_cast<unsigned long>(latency[3]),
+        static_cast<unsigned long>(latency[4]), static_cast<unsigned long>(latency[5]),
+        static_cast<unsigned long>(latency[6]), static_cast<unsigned long>(latency[7])
+      );
+      if (written < 0 || length + written >= size) {
+        break; // next chunk
+      }
+      length += written;
+      cursor++;
+    }
+    return length;
+  }
+
+  void I2cBus::clearStats() {
+    _size = 0;
+    _clears = 0;
+  }
+
+  I2cDeviceStats* I2cBus::_slot(const uint8_t address) {
+    for (uint8_t i = 0; i < _size; i++) {
+      if (_devices[i].address == address) {
+        return &_devices[i];
+      }
+    }
+    if (_size >= I2C_BUS_DEVICE_MAX) {
+      return nullptr;
+    }
+    auto& device = _devices[_size++];
+    device = I2cDeviceStats();
+    device.address = address;
+    return &device;
+  }
+
+  void I2cBus::_wire() {
+    Wire.begin(_sdaPin, _sclPin);
+    Wire.setClockStretchLimit(I2C_BUS_STRETCH_LIMIT_MICROS);
+  }
+
+  // global
+  I2cBus i2cBus;
+
+} // namespace Victor::Components
@@ -0,0 +1,73 @@
+#ifndef I2cBus_h
+#define I2cBus_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Console.h>
+
+// devices tracked, one slot per address seen
+#define I2C_BUS_DEVICE_MAX 4
+// transaction latency buckets, upper bounds in micros, the last one is open ended
+#define I2C_BUS_LATENCY_BUCKETS 8
+// clock stretching bound, a slave holding scl longer fails the transaction
+#define I2C_BUS_STRETCH_LIMIT_MICROS 2000
+// retries of a failed bus step before the device is recovered
+#define I2C_BUS_RETRY_LIMIT 3
+// wait before the first retry, doubled for each one after
+#define I2C_BUS_BACKOFF_MILLIS 20
+// clocks that let any slave finish the byte it is shifting out
+#define I2C_BUS_CLEAR_CLOCKS 9
+#define I2C_BUS_CSV_HEADER "address,transactions,errors,retries,recoveries,max_us,lt100us,lt200us,lt500us,lt1ms,lt2ms,lt5ms,lt10ms,ge10ms\n"
+
+namespace Victor::Components {
+
+  struct I2cDeviceStats {
+    uint8_t address = 0;
+    uint32_t transactions = 0;
+    uint32_t errors = 0;
+    uint32_t retries = 0;
+    // bus cleared and device re-initialized
+    uint32_t recoveries = 0;
+    uint32_t maxMicros = 0;
+    uint32_t latency[I2C_BUS_LATENCY_BUCKETS] = {};
+  };
+
+  // owns the wire setup and keeps per device health: latency histogram, errors, retries
+  // the drivers report each bus step and ask for backoff and recovery here
+  class I2cBus {
+   public:
+    void begin(const int8_t sdaPin, const int8_t sclPin);
+    // one bus step of a device, how long it held the bus
+    void record(const uint8_t address, const bool ok, const unsigned long micros);
+    void retried(const uint8_t address);
+    void recovered(const uint8_t address);
+    // millis to wait before retry number n (0 based)
+    static unsigned long backoffMillis(const uint8_t retry);
+    // clock scl until a slave holding sda low lets go, send a STOP and restart the wire,
+    // true when sda is free afterwards
+    bool clear();
+    uint32_t getClears() const;
+    uint8_t size() const;
+    const I2cDeviceStats& at(const uint8_t index) const;
+    // nullptr when the address never showed up
+    const I2cDeviceStats* find(const uint8_t address) const;
+    // csv rows from cursor on that fit into buffer, 0 when done
+    size_t writeCsv(size_t& cursor, char* buffer, const size_t size) const;
+    void clearStats();
+
+   private:
+    int8_t _sdaPin = -1;
+    int8_t _sclPin = -1;
+    uint32_t _clears = 0;
+    I2cDeviceStats _devices[I2C_BUS_DEVICE_MAX];
+    uint8_t _size = 0;
+    I2cDeviceStats* _slot(const uint8_t address);
+    void _wire();
+  };
+
+  // global
+  extern I2cBus i2cBus;
+
+} // namespace Victor::Components
+
+#endif // I2cBus_h
@@ -0,0 +1,133 @@
+#include "LoopProfiler.h"
+
+namespace Victor::Components {
+
+  void LoopProfiler::setSlowMillis(const uint32_t millis) {
+    _slowMicros = millis * 1000;
+  }
+
+  void LoopProfiler::begin() {
+    if (_cyclesPerMicro == 0) {
+      _cyclesPerMicro = ESP.getCpuFreqMHz();
+    }
+    _busyMicros = 0;
+    _longestMicros = 0;
+    _markCycles = ESP.getCycleCount();
+  }
+
+  void LoopProfiler::mark(const LoopPhase phase) {
+    const auto cycles = ESP.getCycleCount();
+    // unsigned difference survives the counter wrapping
+    const uint32_t elapsed = (cycles - _markCycles) / _cyclesPerMicro;
+    _markCycles = cycles;
+    auto& stats = _phases[phase];
+    stats.minMicros = stats.calls == 0 ? elapsed : std::min(stats.minMicros, elapsed);
+    stats.maxMicros = std::max(stats.maxMicros, elapsed);
+    stats.sumMicros += elapsed;
+    stats.calls++;
+    const uint8_t bucket = elapsed < 2 ? 0 : 31 - __builtin_clz(elapsed);
+    stats.histogram[std::min<uint8_t>(bucket, LOOP_PROFILER_BUCKETS - 1)]++;
+    if (phase == LOOP_PHASE_SLEEP) {
+      return;
+    }
+    _busyMicros += elapsed;
+    if (elapsed >= _longestMicros) {
+      _longestMicros = elapsed;
+      _longestPhase = phase;
+    }
+  }
+
+  void LoopProfiler::end() {
+    _iterations++;
+    _maxMicros = std::max(_maxMicros, _busyMicros);
+    if (_slowMicros == 0 || _busyMicros <= _slowMicros) {
+      return;
+    }
+    _slowIterations++;
+    _slowPhase = _longestPhase;
+    _lastSlowMicros = _busyMicros;
+    console.error()
+      .bracket(F("loop"))
+      .section(F("slow"), String(_busyMicros / 1000) + F("ms"))
+      .section(name(_longestPhase), String(_longestMicros / 1000) + F("ms"));
+    // the log line itself is not the next iteration's cost
+    _markCycles = ESP.getCycleCount();
+  }
+
+  const LoopPhaseStats& LoopProfiler::at(const LoopPhase phase) const {
+    return _phases[phase];
+  }
+
+  const __FlashStringHelper* LoopProfiler::name(const LoopPhase phase) {
+    switch (phase) {
+      case LOOP_PHASE_HOMEKIT: return F("homekit");
+      case LOOP_PHASE_SENSOR:  return F("sensor");
+      case LOOP_PHASE_PORTAL:  return F("portal");
+      case LOOP_PHASE_DATA:    return F("data");
+      case LOOP_PHASE_LOG:     return F("log");
+      case LOOP_PHASE_SLEEP:   return F("sleep");
+      case LOOP_PHASE_BUTTON:  return F("button");
+      case LOOP_PHASE_NOTIFY:  return F("notify");
+      default:                 return F("unknown");
+    }
+  }
+
+  uint32_t LoopProfiler::getIterations() const {
+    return _iterations;
+  }
+
+  uint32_t LoopProfiler::getMaxMicros() const {
+    return _maxMicros;
+  }
+
+  uint32_t LoopProfiler::getSlowIterations() const {
+    return _slowIterations;
+  }
+
+  LoopPhase LoopProfiler::getSlowPhase() const {
+    return _slowPhase;
+  }
+
+  uint32_t LoopProfiler::getSlowMicros() const {
+    return _lastSlowMicros;
+  }
+
+  size_t LoopProfiler::writeCsv(size_t& cursor, char* buffer, const size_t size) const {
+    size_t length = 0;
+    while (cursor < LOOP_PHASE_COUNT) {
+      const auto phase = static_cast<LoopPhase>(cursor);
+      const auto& stats = _phases[phase];
+      const auto phaseName = String(name(phase));
+      auto written = snprintf(
+        buffer + length, size - length, "%s,%lu,%lu,%lu,%lu",
+        phaseName.c_str(), static_cast<unsigned long>(stats.calls), static_cast<unsigned long>(stats.minMicros),
+        static_cast<unsigned long>(stats.avgMicros()), static_cast<unsigned long>(stats.maxMicros)
+      );
+      for (auto i = 0; i < LOOP_PROFILER_BUCKETS && written > 0 && length + written < size; i++) {
+        const auto bucket = snprintf(buffer + length + written, size - length - written, ",%lu", static_cast<unsigned long>(stats.histogram[i]));
+        written = bucket < 0 ? bucket : written + bucket;
+      }
+      if (written < 0 || length + written + 1 >= size) {
+        break; // next chunk
+      }
+      buffer[length + written] = '\n';
+      length += written + 1;
+      cursor++;
+    }
+    return length;
+  }
+
+  void LoopProfiler::clear() {
+    for (auto& stats : _phases) {
+      stats = LoopPhaseStats();
+    }
+    _iterations = 0;
+    _maxMicros = 0;
+    _slowIterations = 0;
+    _lastSlowMicros = 0;
+  }
+
+  // global
+  LoopProfiler loopProfiler;
+
+} // namespace Victor::Components
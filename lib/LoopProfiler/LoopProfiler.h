@@ -0,0 +1,89 @@
+#ifndef LoopProfiler_h
+#define LoopProfiler_h
+
+#include <Arduino.h>
+#include <Console.h>
+
+// log2 micros buckets: <2us, <4us, ... <32ms, the last one open ended
+#define LOOP_PROFILER_BUCKETS 16
+// busy iterations longer than this are logged with the phase that took longest
+// 0 = disabled
+#ifndef LOOP_PROFILER_SLOW_MILLIS
+#define LOOP_PROFILER_SLOW_MILLIS 50
+#endif
+#define LOOP_PROFILER_CSV_HEADER "phase,calls,min_us,avg_us,max_us,lt2us,lt4us,lt8us,lt16us,lt32us,lt64us,lt128us,lt256us,lt512us,lt1ms,lt2ms,lt4ms,lt8ms,lt16ms,lt32ms,ge32ms\n"
+
+namespace Victor::Components {
+
+  // the steps of loop() in the order they run
+  enum LoopPhase {
+    LOOP_PHASE_HOMEKIT = 0,
+    LOOP_PHASE_SENSOR  = 1,
+    LOOP_PHASE_PORTAL  = 2,
+    LOOP_PHASE_DATA    = 3,
+    LOOP_PHASE_LOG     = 4, // deferred log lines printed while idle
+    LOOP_PHASE_SLEEP   = 5, // intended, left out of the busy time
+    LOOP_PHASE_BUTTON  = 6,
+    LOOP_PHASE_NOTIFY  = 7,
+    LOOP_PHASE_COUNT   = 8,
+  };
+
+  struct LoopPhaseStats {
+    uint32_t calls = 0;
+    uint32_t minMicros = 0;
+    uint32_t maxMicros = 0;
+    uint64_t sumMicros = 0;
+    uint32_t histogram[LOOP_PROFILER_BUCKETS] = {};
+    uint32_t avgMicros() const {
+      return calls > 0 ? sumMicros / calls : 0;
+    }
+  };
+
+  // attributes the cpu cycles of each loop() iteration to its phases,
+  // two cycle counter reads per phase and no allocation
+  class LoopProfiler {
+   public:
+    // busy iterations longer than this are logged, 0 = disabled
+    void setSlowMillis(const uint32_t millis);
+    // an iteration starts
+    void begin();
+    // the time since begin() or the previous mark() went to phase
+    void mark(const LoopPhase phase);
+    // the iteration is over, checks it against the slow threshold
+    void end();
+    const LoopPhaseStats& at(const LoopPhase phase) const;
+    static const __FlashStringHelper* name(const LoopPhase phase);
+    uint32_t getIterations() const;
+    // busy time of the longest iteration
+    uint32_t getMaxMicros() const;
+    uint32_t getSlowIterations() const;
+    // phase that took longest in the last slow iteration, and how long the iteration was busy
+    LoopPhase getSlowPhase() const;
+    uint32_t getSlowMicros() const;
+    // csv rows from cursor on that fit into buffer, 0 when done
+    size_t writeCsv(size_t& cursor, char* buffer, const size_t size) const;
+    void clear();
+
+   private:
+    uint32_t _slowMicros = LOOP_PROFILER_SLOW_MILLIS * 1000UL;
+    uint32_t _cyclesPerMicro = 0;
+    uint32_t _markCycles = 0;
+    // current iteration
+    uint32_t _busyMicros = 0;
+    LoopPhase _longestPhase = LOOP_PHASE_HOMEKIT;
+    uint32_t _longestMicros = 0;
+    // totals
+    LoopPhaseStats _phases[LOOP_PHASE_COUNT];
+    uint32_t _iterations = 0;
+    uint32_t _maxMicros = 0;
+    uint32_t _slowIterations = 0;
+    LoopPhase _slowPhase = LOOP_PHASE_HOMEKIT;
+    uint32_t _lastSlowMicros = 0;
+  };
+
+  // global
+  extern LoopProfiler loopProfiler;
+
+} // namespace Victor::Components
+
+#endif // LoopProfiler_h
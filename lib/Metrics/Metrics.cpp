@@ -0,0 +1,154 @@
+#include "Metrics.h"
+
+// rows before the per characteristic notify counters
+#define METRICS_FIXED_ROWS 13
+
+namespace Victor::Components {
+
+  void Metrics::loop() {
+    _loops++;
+    const auto now = millis();
+    if (!_sampled) {
+      _sample(now);
+      _loops = 0;
+    } else if (now - _sampleMillis >= METRICS_SAMPLE_MILLIS) {
+      _loopRate = static_cast<uint64_t>(_loops) * 1000 / (now - _sampleMillis);
+      _loops = 0;
+      _sample(now);
+    }
+  }
+
+  void Metrics::track(const homekit_characteristic_t* characteristic, const __FlashStringHelper* name) {
+    for (uint8_t i = 0; i < _size; i++) {
+      if (_characteristics[i].characteristic == characteristic) {
+        return;
+      }
+    }
+    if (_size < METRICS_CHARACTERISTIC_MAX) {
+      auto& tracked = _characteristics[_size++];
+      tracked.characteristic = characteristic;
+      tracked.name = name;
+      tracked.notified = 0;
+    }
+  }
+
+  void Metrics::notified(const homekit_characteristic_t* characteristic) {
+    // a handful of pointers, cheaper than any map
+    for (uint8_t i = 0; i < _size; i++) {
+      if (_characteristics[i].characteristic == characteristic) {
+        _characteristics[i].notified++;
+        return;
+      }
+    }
+  }
+
+  void Metrics::notifySaved() {
+    _notifySaved++;
+  }
+
+  uint32_t Metrics::getNotifySaved() const {
+    return _notifySaved;
+  }
+
+  void Metrics::measured(const MetricSensor sensor, const MeasureState state) {
+    auto& metrics = _sensors[sensor];
+    if (state == MEASURE_SUCCESS) {
+      metrics.success++;
+    } else if (state == MEASURE_FAILED) {
+      metrics.failure++;
+    }
+  }
+
+  void Metrics::sensorReset(const MetricSensor sensor) {
+    _sensors[sensor].resetMillis = millis();
+  }
+
+  const HeapMetrics& Metrics::getHeap() const {
+    return _heap;
+  }
+
+  uint32_t Metrics::getLoopRate() const {
+    return _loopRate;
+  }
+
+  const SensorMetrics& Metrics::getSensor(const MetricSensor sensor) const {
+    return _sensors[sensor];
+  }
+
+  unsigned long Metrics::getSensorUptime(const MetricSensor sensor) const {
+    return (millis() - _sensors[sensor].resetMillis) / 1000;
+  }
+
+  uint8_t Metrics::size() const {
+    return _size;
+  }
+
+  const CharacteristicMetrics& Metrics::at(const uint8_t index) const {
+    return _characteristics[index];
+  }
+
+  size_t Metrics::writeCsv(size_t& cursor, char* buffer, const size_t size) const {
+    size_t length = 0;
+    while (cursor < static_cast<size_t>(METRICS_FIXED_ROWS + _size)) {
+      const auto& ht = _sensors[METRIC_SENSOR_HT];
+      const auto& aq = _sensors[METRIC_SENSOR_AQ];
+      String name;
+      uint32_t value = 0;
+      switch (cursor) {
+        case 0:  name = F("uptime_s");       value = millis() / 1000; break;
+        case 1:  name = F("heap_free");      value = _heap.free; break;
+        case 2:  name = F("heap_free_min");  value = _heap.freeMin; break;
+        case 3:  name = F("heap_max_block"); value = _heap.maxBlock; break;
+        case 4:  name = F("heap_frag_pct");  value = _heap.fragmentation; break;
+        case 5:  name = F("loop_hz");        value = _loopRate; break;
+        case 6:  name = F("ht_success");     value = ht.success; break;
+        case 7:  name = F("ht_failure");     value = ht.failure; break;
+        case 8:  name = F("ht_uptime_s");    value = getSensorUptime(METRIC_SENSOR_HT); break;
+        case 9:  name = F("aq_success");     value = aq.success; break;
+        case 10: name = F("aq_failure");     value = aq.failure; break;
+        case 11: name = F("aq_uptime_s");    value = getSensorUptime(METRIC_SENSOR_AQ); break;
+        case 12: name = F("notify_saved");   value = _notifySaved; break;
+        default: {
+          const auto& tracked = _characteristics[cursor - METRICS_FIXED_ROWS];
+          name = String(F("notify_")) + tracked.name;
+          value = tracked.notified;
+          break;
+        }
+      }
+      const auto written = snprintf(buffer + length, size - length, "%s,%lu\n", name.c_str(), static_cast<unsigned long>(value));
+      if (written < 0 || length + written >= size) {
+        break; // next chunk
+      }
+      length += written;
+      cursor++;
+    }
+    return length;
+  }
+
+  void Metrics::clear() {
+    _sampled = false;
+    _loops = 0;
+    _loopRate = 0;
+    _heap = HeapMetrics();
+    _notifySaved = 0;
+    for (auto& sensor : _sensors) {
+      sensor = SensorMetrics();
+    }
+    for (uint8_t i = 0; i < _size; i++) {
+      _characteristics[i].notified = 0;
+    }
+  }
+
+  void Metrics::_sample(const unsigned long now) {
+    _sampleMillis = now;
+    _heap.free = ESP.getFreeHeap();
+    _heap.freeMin = _sampled ? std::min(_heap.freeMin, _heap.free) : _heap.free;
+    _heap.maxBlock = ESP.getMaxFreeBlockSize();
+    _heap.fragmentation = ESP.getHeapFragmentation();
+    _sampled = true;
+  }
+
+  // global
+  Metrics metrics;
+
+} // namespace Victor::Components
@@ -0,0 +1,88 @@
+#ifndef Metrics_h
+#define Metrics_h
+
+#include <Arduino.h>
+#include <arduino_homekit_server.h>
+#include "ClimateStorage.h"
+
+// characteristics with their own notify counter
+#define METRICS_CHARACTERISTIC_MAX 8
+// heap walks are not free, sampled once per interval together with the loop rate
+#define METRICS_SAMPLE_MILLIS 1000
+#define METRICS_CSV_HEADER "metric,value\n"
+
+namespace Victor::Components {
+
+  enum MetricSensor {
+    METRIC_SENSOR_HT    = 0,
+    METRIC_SENSOR_AQ    = 1,
+    METRIC_SENSOR_COUNT = 2,
+  };
+
+  struct SensorMetrics {
+    uint32_t success = 0;
+    uint32_t failure = 0;
+    // millis of begin or the last soft reset
+    unsigned long resetMillis = 0;
+  };
+
+  struct CharacteristicMetrics {
+    const homekit_characteristic_t* characteristic = nullptr;
+    const __FlashStringHelper* name = nullptr;
+    uint32_t notified = 0;
+  };
+
+  struct HeapMetrics {
+    uint32_t free = 0;
+    // lowest free heap sampled since boot
+    uint32_t freeMin = 0;
+    uint32_t maxBlock = 0;
+    // 0~100 %
+    uint8_t fragmentation = 0;
+  };
+
+  // runtime counters for the portal and /metrics, every update is a few increments
+  class Metrics {
+   public:
+    // once per loop(), samples heap and loop rate every METRICS_SAMPLE_MILLIS
+    void loop();
+    // give a characteristic its own notify counter, ignored once full or when known
+    void track(const homekit_characteristic_t* characteristic, const __FlashStringHelper* name);
+    void notified(const homekit_characteristic_t* characteristic);
+    // a notify dropped as a repeat of one already pending in the batch
+    void notifySaved();
+    uint32_t getNotifySaved() const;
+    // a finished (not skipped) measure
+    void measured(const MetricSensor sensor, const MeasureState state);
+    void sensorReset(const MetricSensor sensor);
+    const HeapMetrics& getHeap() const;
+    // loop() passes per second over the last sample interval
+    uint32_t getLoopRate() const;
+    const SensorMetrics& getSensor(const MetricSensor sensor) const;
+    // seconds since begin or the last soft reset of the sensor
+    unsigned long getSensorUptime(const MetricSensor sensor) const;
+    uint8_t size() const;
+    const CharacteristicMetrics& at(const uint8_t index) const;
+    // "metric,value" rows from cursor on that fit into buffer, 0 when done
+    size_t writeCsv(size_t& cursor, char* buffer, const size_t size) const;
+    void clear();
+
+   private:
+    HeapMetrics _heap;
+    unsigned long _sampleMillis = 0;
+    bool _sampled = false;
+    uint32_t _loops = 0;
+    uint32_t _loopRate = 0;
+    SensorMetrics _sensors[METRIC_SENSOR_COUNT];
+    CharacteristicMetrics _characteristics[METRICS_CHARACTERISTIC_MAX];
+    uint8_t _size = 0;
+    uint32_t _notifySaved = 0;
+    void _sample(const unsigned long now);
+  };
+
+  // global
+  extern Metrics metrics;
+
+} // namespace Victor::Components
+
+#endif // Metrics_h
@@ -0,0 +1,138 @@
+#include "PortalSnapshot.h"
+
+namespace Victor::Components {
+
+  bool PortalSnapshot::refresh(const uint32_t revision) {
+    const auto now = millis();
+    if (_rendered && revision == _revision && now - _renderMillis < PORTAL_SNAPSHOT_MAX_AGE_MILLIS) {
+      return false;
+    }
+    const auto start = micros();
+    _size = 0;
+    _dropped = 0;
+    _used = 0;
+    if (onRender != nullptr) {
+      onRender(*this);
+    }
+    _rendered = true;
+    _revision = revision;
+    _renderMillis = now;
+    _renders++;
+    _renderMicros = micros() - start;
+    return true;
+  }
+
+  void PortalSnapshot::invalidate() {
+    _rendered = false;
+  }
+
+  bool PortalSnapshot::add(const __FlashStringHelper* text, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const auto added = _add(text, nullptr, format, args);
+    va_end(args);
+    return added;
+  }
+
+  bool PortalSnapshot::add(const __FlashStringHelper* text, const __FlashStringHelper* suffix, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const auto added = _add(text, suffix, format, args);
+    va_end(args);
+    return added;
+  }
+
+  bool PortalSnapshot::addCenti(const __FlashStringHelper* text, const int32_t centi, const __FlashStringHelper* unit) {
+    const uint32_t absolute = centi < 0 ? -static_cast<int64_t>(centi) : centi;
+    // %s can not read flash, the unit is copied out first
+    char unitBuffer[16] = {};
+    strncpy_P(unitBuffer, reinterpret_cast<const char*>(unit), sizeof(unitBuffer) - 1);
+    return add(
+      text, PSTR("%s%lu.%02lu%s"), centi < 0 ? "-" : "",
+      static_cast<unsigned long>(absolute / 100), static_cast<unsigned long>(absolute % 100), unitBuffer
+    );
+  }
+
+  uint8_t PortalSnapshot::size() const {
+    return _size;
+  }
+
+  const char* PortalSnapshot::textAt(const uint8_t index) const {
+    return _buffer + _rows[index].text;
+  }
+
+  const char* PortalSnapshot::valueAt(const uint8_t index) const {
+    return _buffer + _rows[index].value;
+  }
+
+  size_t PortalSnapshot::getUsed() const {
+    return _used;
+  }
+
+  uint8_t PortalSnapshot::getDropped() const {
+    return _dropped;
+  }
+
+  uint32_t PortalSnapshot::getRenders() const {
+    return _renders;
+  }
+
+  unsigned long PortalSnapshot::getRenderMicros() const {
+    return _renderMicros;
+  }
+
+  size_t PortalSnapshot::writeCsv(size_t& cursor, char* buffer, const size_t size) const {
+    size_t length = 0;
+    while (cursor < _size) {
+      // values hold commas ("3 ok, 0 failed"), quoted
+      const auto written = snprintf(buffer + length, size - length, "%s,\"%s\"\n", textAt(cursor), valueAt(cursor));
+      if (written < 0 || length + written >= size) {
+        break; // next chunk
+      }
+      length += written;
+      cursor++;
+    }
+    return length;
+  }
+
+  void PortalSnapshot::clear() {
+    _size = 0;
+    _dropped = 0;
+    _used = 0;
+    _rendered = false;
+    _revision = 0;
+    _renderMillis = 0;
+    _renders = 0;
+    _renderMicros = 0;
+  }
+
+  bool PortalSnapshot::_add(const __FlashStringHelper* text, const __FlashStringHelper* suffix, const char* format, va_list args) {
+    const auto textLength = strlen_P(reinterpret_cast<const char*>(text));
+    const auto suffixLength = suffix != nullptr ? strlen_P(reinterpret_cast<const char*>(suffix)) : 0;
+    auto used = _used + textLength + suffixLength + 1;
+    if (_size >= PORTAL_SNAPSHOT_ROW_MAX || used >= PORTAL_SNAPSHOT_BUFFER_SIZE) {
+      _dropped++;
+      return false;
+    }
+    auto& row = _rows[_size];
+    row.text = _used;
+    memcpy_P(_buffer + _used, text, textLength);
+    if (suffixLength > 0) {
+      memcpy_P(_buffer + _used + textLength, suffix, suffixLength);
+    }
+    _buffer[used - 1] = '\0';
+    row.value = used;
+    const auto written = vsnprintf_P(_buffer + used, PORTAL_SNAPSHOT_BUFFER_SIZE - used, format, args);
+    if (written < 0 || used + written >= PORTAL_SNAPSHOT_BUFFER_SIZE) {
+      _dropped++;
+      return false; // the offsets taken are left behind and overwritten by the next row
+    }
+    _used = used + written + 1;
+    _size++;
+    return true;
+  }
+
+  // global
+  PortalSnapshot portalSnapshot;
+
+} // namespace Victor::Components
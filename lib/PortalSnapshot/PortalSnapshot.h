@@ -0,0 +1,74 @@
+#ifndef PortalSnapshot_h
+#define PortalSnapshot_h
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// rows and text bytes of one snapshot, a row that does not fit is dropped
+#define PORTAL_SNAPSHOT_ROW_MAX 40
+#define PORTAL_SNAPSHOT_BUFFER_SIZE 1536
+// diagnostics (heap, loop, counters) move without any reading changing,
+// rendered again no sooner than this when the readings stay put
+#ifndef PORTAL_SNAPSHOT_MAX_AGE_MILLIS
+#define PORTAL_SNAPSHOT_MAX_AGE_MILLIS 5000
+#endif
+#define PORTAL_SNAPSHOT_CSV_HEADER "state,value\n"
+
+namespace Victor::Components {
+
+  // offsets of the text and the value into the buffer
+  struct PortalRow {
+    uint16_t text = 0;
+    uint16_t value = 0;
+  };
+
+  // the portal states rendered once into a fixed buffer and served as is to every request,
+  // instead of concatenating fresh strings per request
+  class PortalSnapshot {
+   public:
+    // fills the rows with add(), called from refresh() only
+    typedef std::function<void(PortalSnapshot& snapshot)> TRenderHandler;
+    TRenderHandler onRender = nullptr;
+    // render again when revision moved since the last render or the snapshot is older than max age,
+    // returns rendered or not
+    bool refresh(const uint32_t revision);
+    // the next refresh renders whatever the revision
+    void invalidate();
+    // one row, text from flash (with an optional flash suffix), value printf style from a PSTR format
+    bool add(const __FlashStringHelper* text, const char* format, ...);
+    bool add(const __FlashStringHelper* text, const __FlashStringHelper* suffix, const char* format, ...);
+    // centi units as "12.34" followed by unit
+    bool addCenti(const __FlashStringHelper* text, const int32_t centi, const __FlashStringHelper* unit);
+    uint8_t size() const;
+    const char* textAt(const uint8_t index) const;
+    const char* valueAt(const uint8_t index) const;
+    // buffer bytes taken by the last render
+    size_t getUsed() const;
+    // rows dropped by the last render for lack of room
+    uint8_t getDropped() const;
+    uint32_t getRenders() const;
+    unsigned long getRenderMicros() const;
+    // "state,value" rows from cursor on that fit into buffer, 0 when done
+    size_t writeCsv(size_t& cursor, char* buffer, const size_t size) const;
+    void clear();
+
+   private:
+    char _buffer[PORTAL_SNAPSHOT_BUFFER_SIZE] = {};
+    PortalRow _rows[PORTAL_SNAPSHOT_ROW_MAX];
+    uint8_t _size = 0;
+    uint8_t _dropped = 0;
+    size_t _used = 0;
+    bool _rendered = false;
+    uint32_t _revision = 0;
+    unsigned long _renderMillis = 0;
+    uint32_t _renders = 0;
+    unsigned long _renderMicros = 0;
+    bool _add(const __FlashStringHelper* text, const __FlashStringHelper* suffix, const char* format, va_list args);
+  };
+
+  // global
+  extern PortalSnapshot portalSnapshot;
+
+} // namespace Victor::Components
+
+#endif // PortalSnapshot_h
@@ -0,0 +1,147 @@
+#include "SensorBoot.h"
+
+namespace Victor::Components {
+
+  SensorBoot::SensorBoot(const I2cSetting& i2c, const ClimateSetting* climate, SensorRegistry* registry)
+    : _i2c(i2c), _climate(climate), _registry(registry) {
+    _dueMillis = millis();
+  }
+
+  unsigned long SensorBoot::loop() {
+    if (_phase == SENSOR_BOOT_DONE) {
+      return 0;
+    }
+    const auto now = millis();
+    if (static_cast<long>(now - _dueMillis) < 0) {
+      return _dueMillis - now;
+    }
+    switch (_phase) {
+      case SENSOR_BOOT_POWER_OFF: {
+        if (_i2c.enablePin > -1) {
+          pinMode(_i2c.enablePin, OUTPUT);
+          _power(false);
+          _next(SENSOR_BOOT_POWER_ON, SENSOR_BOOT_POWER_MILLIS);
+        } else {
+          _next(SENSOR_BOOT_BUS);
+        }
+        bootTimeline.mark(F("sensor power off"));
+        break;
+      }
+      case SENSOR_BOOT_POWER_ON: {
+        _power(true);
+        _next(SENSOR_BOOT_BUS, SENSOR_BOOT_POWER_MILLIS);
+        bootTimeline.mark(F("sensor power on"));
+        break;
+      }
+      case SENSOR_BOOT_BUS: {
+        // wire with a bounded clock stretch, and the pins kept for clearing a stuck bus
+        i2cBus.begin( // https://zhuanlan.zhihu.com/p/137568249
+          _i2c.sdaPin, // Inter-Integrated Circuit - Serial Data (I2C-SDA)
+          _i2c.sclPin  // Inter-Integrated Circuit - Serial Clock (I2C-SCL)
+        );
+        _next(SENSOR_BOOT_SCAN);
+        bootTimeline.mark(F("i2c bus"));
+        break;
+      }
+      case SENSOR_BOOT_SCAN: {
+        if (_climate->fusion.scan) {
+          const auto found = _registry->scan();
+          bootTimeline.mark(F("i2c scan"));
+          if (found == 0 && _retry()) {
+            break;
+          }
+        }
+        _registry->create(*_climate);
+        _next(SENSOR_BOOT_HT);
+        break;
+      }
+      case SENSOR_BOOT_HT: {
+        const auto ht = _registry->getHT();
+        if (ht != nullptr) {
+          _hasHT = ht->begin();
+          if (!_hasHT && _retry()) {
+            break;
+          }
+          if (!_hasHT) {
+            console.error()
+              .bracket(F("ht"))
+              .section(F("notfound"));
+          }
+          bootTimeline.mark(F("ht begin"));
+        }
+        _next(SENSOR_BOOT_AQ);
+        break;
+      }
+      case SENSOR_BOOT_AQ: {
+        const auto aq = _registry->getAQ();
+        if (aq != nullptr) {
+          _hasAQ = aq->begin();
+          if (!_hasAQ && _retry()) {
+            break;
+          }
+          if (!_hasAQ) {
+            console.error()
+              .bracket(F("aq"))
+              .section(F("notfound"));
+          }
+          bootTimeline.mark(F("aq begin"));
+        }
+        _next(SENSOR_BOOT_BASELINE);
+        break;
+      }
+      case SENSOR_BOOT_BASELINE: {
+        const auto aq = _registry->getAQ();
+        if (aq != nullptr) {
+          aq->loadBaseline(_climate->baseline);
+          bootTimeline.mark(F("aq baseline"));
+        }
+        _next(SENSOR_BOOT_DONE);
+        break;
+      }
+      default:
+        break;
+    }
+    const auto wait = static_cast<long>(_dueMillis - millis());
+    return _phase == SENSOR_BOOT_DONE || wait < 0 ? 0 : wait;
+  }
+
+  bool SensorBoot::isDone() const {
+    return _phase == SENSOR_BOOT_DONE;
+  }
+
+  bool SensorBoot::isCreated() const {
+    return _phase > SENSOR_BOOT_SCAN;
+  }
+
+  SensorBootPhase SensorBoot::getPhase() const {
+    return _phase;
+  }
+
+  bool SensorBoot::hasHT() const {
+    return _hasHT;
+  }
+
+  bool SensorBoot::hasAQ() const {
+    return _hasAQ;
+  }
+
+  void SensorBoot::_power(const bool on) {
+    const auto high = (_i2c.enableTrueValue > 0) == on;
+    digitalWrite(_i2c.enablePin, high ? HIGH : LOW);
+  }
+
+  void SensorBoot::_next(const SensorBootPhase phase, const unsigned long waitMillis) {
+    _phase = phase;
+    _dueMillis = millis() + waitMillis;
+    _attempts = 0;
+  }
+
+  bool SensorBoot::_retry() {
+    if (++_attempts >= SENSOR_BOOT_ATTEMPTS) {
+      return false;
+    }
+    _dueMillis = millis() + SENSOR_BOOT_RETRY_MILLIS;
+    return true;
+  }
+
+} // namespace Victor::Components
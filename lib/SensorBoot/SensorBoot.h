@@ -0,0 +1,68 @@
+#ifndef SensorBoot_h
+#define SensorBoot_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Console.h>
+#include <I2cStorage/I2cStorage.h>
+#include "SensorRegistry.h"
+#include "BootTimeline.h"
+
+// enable pin held off, then settling after power on
+#ifndef SENSOR_BOOT_POWER_MILLIS
+#define SENSOR_BOOT_POWER_MILLIS 200
+#endif
+// a scan finding nothing or a sensor not answering begin() is tried again,
+// a part slow to come up after power on is not taken for missing
+#define SENSOR_BOOT_ATTEMPTS 3
+#define SENSOR_BOOT_RETRY_MILLIS 100
+
+namespace Victor::Components {
+
+  enum SensorBootPhase {
+    SENSOR_BOOT_POWER_OFF = 0,
+    SENSOR_BOOT_POWER_ON  = 1,
+    SENSOR_BOOT_BUS       = 2,
+    SENSOR_BOOT_SCAN      = 3,
+    SENSOR_BOOT_HT        = 4,
+    SENSOR_BOOT_AQ        = 5,
+    SENSOR_BOOT_BASELINE  = 6,
+    SENSOR_BOOT_DONE      = 7,
+  };
+
+  // sensor bring-up as a state machine driven from loop(), one short phase per call,
+  // so the power cycle waits overlap wifi and homekit startup instead of blocking setup()
+  class SensorBoot {
+   public:
+    // the registry gets its sensors once the bus is up
+    SensorBoot(const I2cSetting& i2c, const ClimateSetting* climate, SensorRegistry* registry);
+    // runs the phase that is due, returns millis until the next one, 0 when done
+    unsigned long loop();
+    bool isDone() const;
+    // past the scan, the registry holds its sensors and the accessory layout is known,
+    // begin and baseline may still be running
+    bool isCreated() const;
+    SensorBootPhase getPhase() const;
+    // the sensor was created and answered its begin(), one that did not is still measured
+    // (failing, StatusActive off) and probed again on a backoff
+    bool hasHT() const;
+    bool hasAQ() const;
+
+   private:
+    const I2cSetting _i2c;
+    const ClimateSetting* _climate;
+    SensorRegistry* _registry;
+    SensorBootPhase _phase = SENSOR_BOOT_POWER_OFF;
+    unsigned long _dueMillis = 0;
+    uint8_t _attempts = 0;
+    bool _hasHT = false;
+    bool _hasAQ = false;
+    void _power(const bool on);
+    void _next(const SensorBootPhase phase, const unsigned long waitMillis = 0);
+    // the same phase again a little later, false once out of attempts
+    bool _retry();
+  };
+
+} // namespace Victor::Components
+
+#endif // SensorBoot_h
@@ -0,0 +1,46 @@
+#include "SensorBus.h"
+
+namespace Victor::Components {
+
+  bool SensorBus::subscribe(SensorSink* sink) {
+    for (uint8_t i = 0; i < _size; i++) {
+      if (_sinks[i] == sink) {
+        return true;
+      }
+    }
+    if (sink == nullptr || _size >= SENSOR_BUS_SINK_MAX) {
+      return false;
+    }
+    _sinks[_size++] = sink;
+    return true;
+  }
+
+  void SensorBus::unsubscribe(SensorSink* sink) {
+    for (uint8_t i = 0; i < _size; i++) {
+      if (_sinks[i] == sink) {
+        // keep the order of the rest
+        for (uint8_t j = i + 1; j < _size; j++) {
+          _sinks[j - 1] = _sinks[j];
+        }
+        _sinks[--_size] = nullptr;
+        return;
+      }
+    }
+  }
+
+  void SensorBus::publish(const SensorReading& reading) {
+    _published++;
+    for (uint8_t i = 0; i < _size; i++) {
+      _sinks[i]->onReading(reading);
+    }
+  }
+
+  uint8_t SensorBus::size() const {
+    return _size;
+  }
+
+  uint32_t SensorBus::getPublished() const {
+    return _published;
+  }
+
+} // namespace Victor::Components
@@ -0,0 +1,59 @@
+#ifndef SensorBus_h
+#define SensorBus_h
+
+#include <Arduino.h>
+
+// sinks one bus fans out to, subscribe fails once full
+#ifndef SENSOR_BUS_SINK_MAX
+#define SENSOR_BUS_SINK_MAX 8
+#endif
+
+namespace Victor::Components {
+
+  enum SensorReadingType {
+    SENSOR_READING_HT = 0,
+    SENSOR_READING_AQ = 1,
+  };
+
+  // one finished measure, converted once by the publisher:
+  // filtered, revised and clamped, in centi units
+  struct SensorReading {
+    SensorReadingType type = SENSOR_READING_HT;
+    // false = the sensor failed, values are 0
+    bool ok = false;
+    unsigned long millis = 0;
+    // SENSOR_READING_HT
+    int32_t temperature = 0;
+    int32_t humidity = 0;
+    // SENSOR_READING_AQ
+    int32_t co2 = 0;
+    int32_t voc = 0;
+    uint8_t airQuality = 0;
+  };
+
+  // a consumer of readings, called in subscribe order from inside the measure job
+  class SensorSink {
+   public:
+    virtual ~SensorSink() {}
+    virtual void onReading(const SensorReading& reading) = 0;
+  };
+
+  // fixed list of sinks, publishing is a walk over a few pointers
+  class SensorBus {
+   public:
+    // returns false when full, subscribing a sink again is a no-op
+    bool subscribe(SensorSink* sink);
+    void unsubscribe(SensorSink* sink);
+    void publish(const SensorReading& reading);
+    uint8_t size() const;
+    uint32_t getPublished() const;
+
+   private:
+    SensorSink* _sinks[SENSOR_BUS_SINK_MAX] = {};
+    uint8_t _size = 0;
+    uint32_t _published = 0;
+  };
+
+} // namespace Victor::Components
+
+#endif // SensorBus_h
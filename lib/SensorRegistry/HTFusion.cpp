@@ -0,0 +1,211 @@
+#include "HTFusion.h"
+
+namespace Victor::Components {
+
+  bool HTFusion::add(HTSensor* sensor, const uint8_t weight) {
+    if (sensor == nullptr || _size >= FUSION_HT_MAX) {
+      return false;
+    }
+    _sensors[_size] = sensor;
+    _weights[_size] = weight;
+    _size++;
+    return true;
+  }
+
+  uint8_t HTFusion::size() const {
+    return _size;
+  }
+
+  HTSensor* HTFusion::at(const uint8_t index) const {
+    return index < _size ? _sensors[index] : nullptr;
+  }
+
+  void HTFusion::setMode(const FusionMode mode) {
+    _mode = mode;
+  }
+
+  bool HTFusion::begin() {
+    const auto now = millis();
+    auto found = false;
+    _inRound = false;
+    _current = 0;
+    for (uint8_t i = 0; i < _size; i++) {
+      _absent[i] = !_sensors[i]->begin();
+      _probeMillis[i] = now;
+      _probeBackoff[i] = HT_FUSION_PROBE_MIN_MILLIS;
+      found = !_absent[i] || found;
+    }
+    return found;
+  }
+
+  bool HTFusion::isPresent(const uint8_t index) const {
+    return index < _size && !_absent[index];
+  }
+
+  uint32_t HTFusion::getProbes() const {
+    return _probes;
+  }
+
+  void HTFusion::reset() {
+    _inRound = false;
+    _current = 0;
+    for (uint8_t i = 0; i < _size; i++) {
+      if (!_absent[i]) {
+        _sensors[i]->reset();
+      }
+    }
+  }
+
+  MeasureState HTFusion::measure() {
+    if (_size == 0) {
+      return MEASURE_FAILED;
+    }
+    if (!_inRound) {
+      _probe(millis());
+      _current = _nextPresent(0);
+      if (_current >= _size) {
+        // nobody to measure, no bus traffic until a probe finds one
+        _current = 0;
+        _fusedCount = 0;
+        return MEASURE_FAILED;
+      }
+      for (uint8_t i = 0; i < _size; i++) {
+        _ok[i] = false;
+      }
+      _inRound = true;
+    }
+    const auto state = _sensors[_current]->measure();
+    if (state == MEASURE_SKIPPED) {
+      return MEASURE_SKIPPED;
+    }
+    _ok[_current] = state == MEASURE_SUCCESS;
+    _current = _nextPresent(_current + 1);
+    if (_current < _size) {
+      // the next sensor starts on the next pass, getWaitMillis() is 0 until then
+      return MEASURE_SKIPPED;
+    }
+    _current = 0;
+    _inRound = false;
+    return _finishRound();
+  }
+
+  bool HTFusion::isConverting() {
+    return _inRound;
+  }
+
+  void HTFusion::configure(const Sht30Config& config) {
+    for (uint8_t i = 0; i < _size; i++) {
+      _sensors[i]->configure(config);
+    }
+  }
+
+  void HTFusion::setOversample(const uint8_t count) {
+    for (uint8_t i = 0; i < _size; i++) {
+      _sensors[i]->setOversample(count);
+    }
+  }
+
+  unsigned long HTFusion::getWaitMillis() {
+    return _inRound ? _sensors[_current]->getWaitMillis() : 0;
+  }
+
+  int32_t HTFusion::getCentiHumidity() {
+    return _humidity;
+  }
+
+  int32_t HTFusion::getCentiTemperature() {
+    return _temperature;
+  }
+
+  uint8_t HTFusion::getFusedCount() {
+    return _fusedCount;
+  }
+
+  unsigned long HTFusion::getMaxBlockMicros() {
+    unsigned long maxBlock = 0;
+    for (uint8_t i = 0; i < _size; i++) {
+      maxBlock = std::max<unsigned long>(maxBlock, _sensors[i]->getMaxBlockMicros());
+    }
+    return maxBlock;
+  }
+
+  void HTFusion::resetMaxBlock() {
+    for (uint8_t i = 0; i < _size; i++) {
+      _sensors[i]->resetMaxBlock();
+    }
+  }
+
+  int32_t HTFusion::fuse(const FusionMode mode, const int32_t* values, const uint8_t* weights, const uint8_t count) {
+    int32_t picked[FUSION_HT_MAX];
+    uint8_t size = 0;
+    int32_t weighted = 0;
+    int32_t weightSum = 0;
+    for (uint8_t i = 0; i < count && i < FUSION_HT_MAX; i++) {
+      if (weights[i] == 0) {
+        continue;
+      }
+      weighted += values[i] * weights[i];
+      weightSum += weights[i];
+      // insertion sort for the median
+      auto j = size++;
+      for (; j > 0 && picked[j - 1] > values[i]; j--) {
+        picked[j] = picked[j - 1];
+      }
+      picked[j] = values[i];
+    }
+    if (size == 0) {
+      return 0;
+    }
+    if (mode == FUSION_MEDIAN) {
+      return size % 2 == 1 ? picked[size / 2] : ClimateMath::divide(picked[size / 2 - 1] + picked[size / 2], 2);
+    }
+    return ClimateMath::divide(weighted, weightSum);
+  }
+
+  MeasureState HTFusion::_finishRound() {
+    int32_t humidities[FUSION_HT_MAX];
+    int32_t temperatures[FUSION_HT_MAX];
+    uint8_t weights[FUSION_HT_MAX];
+    _fusedCount = 0;
+    for (uint8_t i = 0; i < _size; i++) {
+      humidities[i] = _sensors[i]->getCentiHumidity();
+      temperatures[i] = _sensors[i]->getCentiTemperature();
+      // a failed or absent sensor sits out this round
+      weights[i] = _ok[i] ? _weights[i] : 0;
+      _fusedCount += weights[i] > 0 ? 1 : 0;
+    }
+    if (_fusedCount == 0) {
+      return MEASURE_FAILED;
+    }
+    _humidity = fuse(_mode, humidities, weights, _size);
+    _temperature = fuse(_mode, temperatures, weights, _size);
+    return MEASURE_SUCCESS;
+  }
+
+  void HTFusion::_probe(const unsigned long now) {
+    for (uint8_t i = 0; i < _size; i++) {
+      if (!_absent[i] || now - _probeMillis[i] < _probeBackoff[i]) {
+        continue;
+      }
+      _probes++;
+      _probeMillis[i] = now;
+      if (_sensors[i]->begin()) {
+        _absent[i] = false;
+        console.log()
+          .bracket(F("ht"))
+          .section(F("probe"), F("answered"))
+          .section(F("sensor"), String(i));
+      } else {
+        _probeBackoff[i] = std::min<unsigned long>(_probeBackoff[i] * 2, HT_FUSION_PROBE_MAX_MILLIS);
+      }
+    }
+  }
+
+  uint8_t HTFusion::_nextPresent(uint8_t index) const {
+    while (index < _size && _absent[index]) {
+      index++;
+    }
+    return index;
+  }
+
+} // namespace Victor::Components
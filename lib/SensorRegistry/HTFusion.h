@@ -0,0 +1,73 @@
+#ifndef HTFusion_h
+#define HTFusion_h
+
+#include "HTSensor.h"
+
+// a sensor whose begin() failed sits out the rounds and is probed with a plain begin()
+// on a doubling backoff, no bus clear; sensors that began fine recover within a round
+#define HT_FUSION_PROBE_MIN_MILLIS 15000
+#define HT_FUSION_PROBE_MAX_MILLIS 480000
+
+namespace Victor::Components {
+
+  // several ht sensors read as one: measured one after the other so only one of them
+  // is on the bus at a time, the readings of a round fused into one value
+  class HTFusion {
+   public:
+    // ignored once FUSION_HT_MAX sensors are in
+    bool add(HTSensor* sensor, const uint8_t weight = 1);
+    uint8_t size() const;
+    HTSensor* at(const uint8_t index) const;
+    void setMode(const FusionMode mode);
+    // applied to every sensor, before begin()
+    void configure(const Sht30Config& config);
+    // begins every sensor, true when at least one answered
+    bool begin();
+    // began, or answered a later probe
+    bool isPresent(const uint8_t index) const;
+    // probes sent to absent sensors
+    uint32_t getProbes() const;
+    void reset();
+    // split-phase over the round: skipped until every sensor has been measured,
+    // then success when at least one of them succeeded
+    MeasureState measure();
+    // a round is in progress
+    bool isConverting();
+    void setOversample(const uint8_t count);
+    unsigned long getWaitMillis();
+    // fused values of the last round, centi %RH / centi °C
+    int32_t getCentiHumidity();
+    int32_t getCentiTemperature();
+    // sensors that contributed to the last round
+    uint8_t getFusedCount();
+    unsigned long getMaxBlockMicros();
+    void resetMaxBlock();
+    // fuse values with weights, 0 weights are left out; median ignores weights
+    static int32_t fuse(const FusionMode mode, const int32_t* values, const uint8_t* weights, const uint8_t count);
+
+   private:
+    HTSensor* _sensors[FUSION_HT_MAX] = {};
+    uint8_t _weights[FUSION_HT_MAX] = {};
+    uint8_t _size = 0;
+    FusionMode _mode = FUSION_MEAN;
+    // absent sensors and when they are probed next
+    bool _absent[FUSION_HT_MAX] = {};
+    unsigned long _probeMillis[FUSION_HT_MAX] = {};
+    unsigned long _probeBackoff[FUSION_HT_MAX] = {};
+    uint32_t _probes = 0;
+    // round state
+    bool _inRound = false;
+    uint8_t _current = 0;
+    bool _ok[FUSION_HT_MAX] = {};
+    int32_t _humidity = 0;
+    int32_t _temperature = 0;
+    uint8_t _fusedCount = 0;
+    MeasureState _finishRound();
+    void _probe(const unsigned long now);
+    // index of the first present sensor from index on, _size when none
+    uint8_t _nextPresent(uint8_t index) const;
+  };
+
+} // namespace Victor::Components
+
+#endif // HTFusion_h
@@ -0,0 +1,110 @@
+#include "SensorRegistry.h"
+
+namespace Victor::Components {
+
+  const KnownSensor knownSensors[SENSOR_REGISTRY_KNOWN_COUNT] = {
+    { .address = 0x38, .ht = HT_SENSOR_AHT10, .aq = AQ_SENSOR_OFF },
+    { .address = 0x44, .ht = HT_SENSOR_SHT30, .aq = AQ_SENSOR_OFF }, // ADDR low
+    { .address = 0x45, .ht = HT_SENSOR_SHT30, .aq = AQ_SENSOR_OFF }, // ADDR high
+    { .address = SENSOR_REGISTRY_SGP30_ADDRESS, .ht = HT_SENSOR_OFF, .aq = AQ_SENSOR_SGP30 },
+  };
+
+  SensorRegistry::~SensorRegistry() {
+    for (uint8_t i = 0; i < _ht.size(); i++) {
+      delete _ht.at(i);
+    }
+    if (_aq != nullptr) {
+      delete _aq;
+      _aq = nullptr;
+    }
+  }
+
+  uint8_t SensorRegistry::scan() {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < SENSOR_REGISTRY_KNOWN_COUNT; i++) {
+      // empty write, the device acks its address
+      Wire.beginTransmission(knownSensors[i].address);
+      _found[i] = Wire.endTransmission(true) == 0;
+      count += _found[i] ? 1 : 0;
+    }
+    console.log()
+      .bracket(F("i2c"))
+      .section(F("scan"), describe());
+    return count;
+  }
+
+  bool SensorRegistry::isFound(const uint8_t address) const {
+    for (uint8_t i = 0; i < SENSOR_REGISTRY_KNOWN_COUNT; i++) {
+      if (knownSensors[i].address == address) {
+        return _found[i];
+      }
+    }
+    return false;
+  }
+
+  void SensorRegistry::create(const ClimateSetting& setting) {
+    if (_created) {
+      return;
+    }
+    _created = true;
+    _ht.setMode(setting.fusion.mode);
+    if (setting.fusion.scan) {
+      for (uint8_t i = 0; i < SENSOR_REGISTRY_KNOWN_COUNT; i++) {
+        const auto& known = knownSensors[i];
+        if (!_found[i]) {
+          continue;
+        }
+        // a kind switched off in climate.json stays off, whatever answers on the bus
+        if (known.ht != HT_SENSOR_OFF) {
+          if (setting.htSensor == HT_SENSOR_OFF) {
+            continue;
+          }
+          if (HTSensor::supports(known.ht)) {
+            _ht.add(new HTSensor(known.ht, known.address), setting.fusion.weights[i]);
+          } else {
+            console.error()
+              .bracket(F("ht"))
+              .section(F("driver not built in"), String(known.ht));
+          }
+        } else if (known.aq != AQ_SENSOR_OFF && setting.aqSensor != AQ_SENSOR_OFF && _aq == nullptr) {
+          _aq = new AQSensor(known.aq);
+        }
+      }
+    }
+    if (_ht.size() == 0 && setting.htSensor != HT_SENSOR_OFF) {
+      if (HTSensor::supports(setting.htSensor)) {
+        _ht.add(new HTSensor(setting.htSensor));
+      } else {
+        console.error()
+          .bracket(F("ht"))
+          .section(F("driver not built in"), String(setting.htSensor));
+      }
+    }
+    if (_aq == nullptr && setting.aqSensor != AQ_SENSOR_OFF) {
+      _aq = new AQSensor(setting.aqSensor);
+    }
+    _ht.configure(setting.sht30);
+  }
+
+  HTFusion* SensorRegistry::getHT() {
+    return _ht.size() > 0 ? &_ht : nullptr;
+  }
+
+  AQSensor* SensorRegistry::getAQ() {
+    return _aq;
+  }
+
+  String SensorRegistry::describe() const {
+    String found;
+    for (uint8_t i = 0; i < SENSOR_REGISTRY_KNOWN_COUNT; i++) {
+      if (_found[i]) {
+        found += (found.length() > 0 ? F(" 0x") : F("0x")) + String(knownSensors[i].address, HEX);
+      }
+    }
+    return found.length() > 0 ? found : String(F("none"));
+  }
+
+  // global
+  SensorRegistry sensorRegistry;
+
+} // namespace Victor::Components
@@ -0,0 +1,54 @@
+#ifndef SensorRegistry_h
+#define SensorRegistry_h
+
+#include <Wire.h>
+#include <Console.h>
+#include "HTFusion.h"
+#include "AQSensor.h"
+
+// sgp30 answers on a fixed address
+#define SENSOR_REGISTRY_SGP30_ADDRESS AQ_SGP30_ADDRESS
+// addresses the scan probes, FUSION_HT_MAX ht sensors and the sgp30
+#define SENSOR_REGISTRY_KNOWN_COUNT 4
+
+namespace Victor::Components {
+
+  struct KnownSensor {
+    uint8_t address;
+    HTSensorType ht;
+    AQSensorType aq;
+  };
+
+  // what may sit on the bus, ht entries first in FUSION_HT_MAX (weights) order
+  extern const KnownSensor knownSensors[SENSOR_REGISTRY_KNOWN_COUNT];
+
+  // the sensors of this device, found by a bus scan at boot or taken from hts/aqs
+  class SensorRegistry {
+   public:
+    ~SensorRegistry();
+    // probe every known address, after Wire.begin(), returns how many answered
+    uint8_t scan();
+    bool isFound(const uint8_t address) const;
+    // create the sensors once: everything scan() found when fusion.scan is on,
+    // the configured hts/aqs at their default address for a kind it found none of
+    void create(const ClimateSetting& setting);
+    // nullptr without an ht sensor
+    HTFusion* getHT();
+    // nullptr without an aq sensor
+    AQSensor* getAQ();
+    // "0x44 0x45 0x58", the addresses that answered the scan
+    String describe() const;
+
+   private:
+    bool _found[SENSOR_REGISTRY_KNOWN_COUNT] = {};
+    bool _created = false;
+    HTFusion _ht;
+    AQSensor* _aq = nullptr;
+  };
+
+  // global
+  extern SensorRegistry sensorRegistry;
+
+} // namespace Victor::Components
+
+#endif // SensorRegistry_h
@@ -0,0 +1,50 @@
+#include "SignalFilter.h"
+
+namespace Victor::Components {
+
+  void SignalFilter::setup(const uint8_t median, const uint8_t emaShift) {
+    _median = std::max<uint8_t>(1, std::min<uint8_t>(FILTER_MEDIAN_MAX, median | 1));
+    _emaShift = std::min<uint8_t>(FILTER_EMA_SHIFT_MAX, emaShift);
+    reset();
+  }
+
+  int32_t SignalFilter::push(const int32_t value) {
+    const auto median = _median > 1 ? _pushMedian(value) : value;
+    if (_emaShift == 0) {
+      return median;
+    }
+    const int32_t half = 1 << (_emaShift - 1);
+    if (!_hasEma) {
+      _ema = median * (1 << _emaShift);
+      _hasEma = true;
+    } else {
+      // ema += (x - ema) / 2^shift, the rounded ema lets a step settle exactly on x in both directions
+      _ema += median - ((_ema + half) >> _emaShift);
+    }
+    return (_ema + half) >> _emaShift;
+  }
+
+  void SignalFilter::reset() {
+    _size = 0;
+    _next = 0;
+    _hasEma = false;
+  }
+
+  int32_t SignalFilter::_pushMedian(const int32_t value) {
+    _window[_next] = value;
+    _next = (_next + 1) % _median;
+    _size = std::min<uint8_t>(_median, _size + 1);
+    // insertion sort of at most 7 values on the stack
+    int32_t sorted[FILTER_MEDIAN_MAX];
+    for (uint8_t i = 0; i < _size; i++) {
+      auto j = i;
+      for (; j > 0 && sorted[j - 1] > _window[i]; j--) {
+        sorted[j] = sorted[j - 1];
+      }
+      sorted[j] = _window[i];
+    }
+    // until the window fills up, the middle of what is there
+    return sorted[_size / 2];
+  }
+
+} // namespace Victor::Components
@@ -0,0 +1,39 @@
+#ifndef SignalFilter_h
+#define SignalFilter_h
+
+#include <Arduino.h>
+
+// largest median window, odd
+#define FILTER_MEDIAN_MAX 7
+// most ht conversions averaged into one reading
+#define FILTER_OVERSAMPLE_MAX 8
+// largest ema shift, alpha = 1 / 2^shift
+#define FILTER_EMA_SHIFT_MAX 6
+
+namespace Victor::Components {
+
+  // median-of-N followed by an exponential moving average, integers only
+  // state is a fixed ring buffer, no allocation after construction
+  class SignalFilter {
+   public:
+    // median 1 = off, ema shift 0 = off
+    void setup(const uint8_t median, const uint8_t emaShift);
+    // feed one sample, returns the filtered value
+    int32_t push(const int32_t value);
+    void reset();
+
+   private:
+    int32_t _window[FILTER_MEDIAN_MAX] = {};
+    uint8_t _median = 1;
+    uint8_t _size = 0;
+    uint8_t _next = 0;
+    uint8_t _emaShift = 0;
+    // ema scaled by 2^shift to keep the fraction
+    int32_t _ema = 0;
+    bool _hasEma = false;
+    int32_t _pushMedian(const int32_t value);
+  };
+
+} // namespace Victor::Components
+
+#endif // SignalFilter_h
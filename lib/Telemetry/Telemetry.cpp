@@ -0,0 +1,125 @@
+#include "Telemetry.h"
+
+namespace Victor::Components {
+
+  namespace {
+
+    void putU16(uint8_t* buffer, const uint16_t value) {
+      buffer[0] = value;
+      buffer[1] = value >> 8;
+    }
+
+    void putU32(uint8_t* buffer, const uint32_t value) {
+      putU16(buffer, value);
+      putU16(buffer + 2, value >> 16);
+    }
+
+    uint16_t getU16(const uint8_t* buffer) {
+      return buffer[0] | (buffer[1] << 8);
+    }
+
+    uint32_t getU32(const uint8_t* buffer) {
+      return getU16(buffer) | (static_cast<uint32_t>(getU16(buffer + 2)) << 16);
+    }
+
+  } // namespace
+
+  TelemetryExporter::TelemetryExporter(const TelemetryConfig& config) {
+    _config = config;
+  }
+
+  bool TelemetryExporter::isEnabled() const {
+    return _config.port > 0;
+  }
+
+  void TelemetryExporter::onReading(const SensorReading& reading) {
+    if (_count >= TELEMETRY_BATCH_MAX) {
+      _stats.overflows++;
+      return;
+    }
+    if (_count == 0) {
+      _firstMillis = reading.millis;
+    }
+    auto sample = _frame + TELEMETRY_HEADER_SIZE + _count * TELEMETRY_SAMPLE_SIZE;
+    sample[0] = (reading.type == SENSOR_READING_AQ ? TELEMETRY_FLAG_AQ : 0) | (reading.ok ? TELEMETRY_FLAG_OK : 0);
+    putU16(sample + 1, std::min<unsigned long>(UINT16_MAX, (reading.millis - _firstMillis) / 1000));
+    if (reading.type == SENSOR_READING_AQ) {
+      putU16(sample + 3, std::min<int32_t>(UINT16_MAX, reading.co2 / 100));
+      putU16(sample + 5, std::min<int32_t>(UINT16_MAX, reading.voc / 10));
+    } else {
+      putU16(sample + 3, static_cast<int16_t>(std::max<int32_t>(INT16_MIN, std::min<int32_t>(INT16_MAX, reading.temperature))));
+      putU16(sample + 5, std::min<int32_t>(UINT16_MAX, reading.humidity));
+    }
+    _count++;
+  }
+
+  bool TelemetryExporter::loop() {
+    if (_count == 0) {
+      return false;
+    }
+    if (_count < _config.batch && millis() - _firstMillis < _config.flushSeconds * 1000UL) {
+      return false;
+    }
+    return flush();
+  }
+
+  bool TelemetryExporter::flush() {
+    if (_count == 0 || !isEnabled()) {
+      return false;
+    }
+    putU16(_frame, TELEMETRY_FRAME_MAGIC);
+    _frame[2] = TELEMETRY_FRAME_VERSION;
+    _frame[3] = _count;
+    putU32(_frame + 4, _sequence);
+    putU32(_frame + 8, _firstMillis / 1000);
+    const size_t length = TELEMETRY_HEADER_SIZE + _count * TELEMETRY_SAMPLE_SIZE;
+    const IPAddress ip(_config.ip[0], _config.ip[1], _config.ip[2], _config.ip[3]);
+    const auto sent = (
+      _udp.beginPacket(ip, _config.port) == 1 &&
+      _udp.write(_frame, length) == length &&
+      _udp.endPacket() == 1
+    );
+    if (sent) {
+      _stats.frames++;
+      _stats.samples += _count;
+      _stats.bytes += length;
+    } else {
+      _stats.failures++;
+    }
+    // the sequence moves either way, a lost frame shows as a gap at the listener
+    _sequence += _count;
+    _count = 0;
+    return sent;
+  }
+
+  uint8_t TelemetryExporter::pending() const {
+    return _count;
+  }
+
+  const TelemetryStats& TelemetryExporter::getStats() const {
+    return _stats;
+  }
+
+  uint8_t TelemetryExporter::decode(const uint8_t* frame, const size_t length, TelemetryHeader& header, TelemetrySample* samples, const uint8_t max) {
+    if (length < TELEMETRY_HEADER_SIZE || getU16(frame) != TELEMETRY_FRAME_MAGIC || frame[2] != TELEMETRY_FRAME_VERSION) {
+      return 0;
+    }
+    header.version = frame[2];
+    header.count = frame[3];
+    header.sequence = getU32(frame + 4);
+    header.seconds = getU32(frame + 8);
+    if (length != static_cast<size_t>(TELEMETRY_HEADER_SIZE + header.count * TELEMETRY_SAMPLE_SIZE)) {
+      return 0;
+    }
+    const auto count = std::min(header.count, max);
+    for (uint8_t i = 0; i < count; i++) {
+      const auto sample = frame + TELEMETRY_HEADER_SIZE + i * TELEMETRY_SAMPLE_SIZE;
+      samples[i].flags = sample[0];
+      samples[i].offset = getU16(sample + 1);
+      samples[i].a = static_cast<int16_t>(getU16(sample + 3));
+      samples[i].b = getU16(sample + 5);
+    }
+    return count;
+  }
+
+} // namespace Victor::Components
@@ -0,0 +1,78 @@
+#ifndef Telemetry_h
+#define Telemetry_h
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <WiFiUdp.h>
+#include "ClimateStorage.h"
+#include "SensorBus.h"
+
+// one udp datagram per frame, little-endian:
+// header  magic u16 "VC", version u8, count u8, sequence u32 (of the first sample),
+//         seconds u32 (uptime of the first sample)
+// sample  flags u8 (bit0 aq, bit7 ok), offset u16 (seconds after the first sample),
+//         ht: temperature i16 0.01°C, humidity u16 0.01%RH
+//         aq: co2 u16 1ppm, voc u16 0.1ppb
+#define TELEMETRY_FRAME_MAGIC 0x4356
+#define TELEMETRY_FRAME_VERSION 1
+#define TELEMETRY_HEADER_SIZE 12
+#define TELEMETRY_SAMPLE_SIZE 7
+#define TELEMETRY_FRAME_MAX (TELEMETRY_HEADER_SIZE + TELEMETRY_BATCH_MAX * TELEMETRY_SAMPLE_SIZE)
+#define TELEMETRY_FLAG_AQ 0x01
+#define TELEMETRY_FLAG_OK 0x80
+
+namespace Victor::Components {
+
+  struct TelemetryStats {
+    uint32_t frames = 0;
+    uint32_t samples = 0;
+    uint32_t bytes = 0;
+    // frames the stack refused, their samples are lost (seen as a sequence gap)
+    uint32_t failures = 0;
+    // readings dropped while a full frame waited for loop()
+    uint32_t overflows = 0;
+  };
+
+  struct TelemetryHeader {
+    uint8_t version = 0;
+    uint8_t count = 0;
+    uint32_t sequence = 0;
+    uint32_t seconds = 0;
+  };
+
+  struct TelemetrySample {
+    uint8_t flags = 0;
+    uint16_t offset = 0;
+    int16_t a = 0;
+    uint16_t b = 0;
+  };
+
+  // collects readings off the sensor bus into a binary frame and sends it as one datagram,
+  // once batch readings are in or the oldest waited flushSeconds: one radio wakeup per batch
+  class TelemetryExporter : public SensorSink {
+   public:
+    TelemetryExporter(const TelemetryConfig& config);
+    bool isEnabled() const;
+    void onReading(const SensorReading& reading) override;
+    // send the frame when due, returns sent or not
+    bool loop();
+    // send whatever is collected now
+    bool flush();
+    uint8_t pending() const;
+    const TelemetryStats& getStats() const;
+    // parse a received frame, returns the samples written into samples, 0 when malformed
+    static uint8_t decode(const uint8_t* frame, const size_t length, TelemetryHeader& header, TelemetrySample* samples, const uint8_t max);
+
+   private:
+    TelemetryConfig _config;
+    WiFiUDP _udp;
+    uint8_t _frame[TELEMETRY_FRAME_MAX] = {};
+    uint8_t _count = 0;
+    uint32_t _sequence = 0;
+    unsigned long _firstMillis = 0;
+    TelemetryStats _stats;
+  };
+
+} // namespace Victor::Components
+
+#endif // Telemetry_h
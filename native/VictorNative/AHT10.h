@@ -0,0 +1,103 @@
+#ifndef AHT10_h
+#define AHT10_h
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "FakeClimate.h"
+
+#define AHT10_ADDRESS_0X38    0x38
+#define AHT10_FORCE_READ_DATA true
+#define AHT10_USE_READ_DATA   false
+#define AHT10_ERROR           0xFF
+
+typedef enum : uint8_t {
+  AHT10_SENSOR = 0x00,
+  AHT15_SENSOR = 0x01,
+  AHT20_SENSOR = 0x02,
+} ASAIR_SENSOR;
+
+namespace Victor::Native {
+
+  // register level aht10 on the fake bus: 0xAC 0x33 0x00 triggers,
+  // a 6 byte read reports busy until the conversion time has passed
+  class FakeAht10Device : public FakeI2cDevice {
+   public:
+    bool onWrite(const uint8_t* data, size_t length) override {
+      if (fakeClimate.fail) { return false; }
+      if (length == 3 && data[0] == 0xAC) {
+        _triggerMicros = VirtualClock::nowMicros();
+        _triggered = true;
+        const auto humidity = std::max<float>(0, std::min<float>(100, fakeClimate.sampleHumidity()));
+        const auto temperature = std::max<float>(-50, std::min<float>(150, fakeClimate.sampleTemperature()));
+        _rawHumidity = static_cast<uint32_t>(humidity / 100 * 0xFFFFF);
+        _rawTemperature = static_cast<uint32_t>((temperature + 50) / 200 * 0xFFFFF);
+      }
+      return true;
+    }
+    size_t onRead(uint8_t* data, size_t length) override {
+      if (fakeClimate.fail || length < 6) { return 0; }
+      const auto busy = !_triggered || VirtualClock::nowMicros() - _triggerMicros < fakeClimate.aht10ConversionMicros;
+      data[0] = (busy ? 0x80 : 0x00) | 0x08; // calibrated
+      data[1] = _rawHumidity >> 12;
+      data[2] = _rawHumidity >> 4;
+      data[3] = ((_rawHumidity & 0x0F) << 4) | ((_rawTemperature >> 16) & 0x0F);
+      data[4] = _rawTemperature >> 8;
+      data[5] = _rawTemperature;
+      return 6;
+    }
+
+   private:
+    bool _triggered = false;
+    uint64_t _triggerMicros = 0;
+    uint32_t _rawHumidity = 0;
+    uint32_t _rawTemperature = 0;
+  };
+
+} // namespace Victor::Native
+
+// stand-in of enjoyneering/AHT10, blocks for the conversion like the real one
+class AHT10 {
+ public:
+  AHT10(uint8_t address = AHT10_ADDRESS_0X38, ASAIR_SENSOR sensorName = AHT10_SENSOR) : _address(address) {}
+  ~AHT10() {
+    Wire.detach(_address);
+  }
+  bool begin() {
+    Wire.attach(_address, &_device);
+    delay(40);
+    // normal mode and calibration, 0xE1 0x08 0x00
+    Wire.beginTransmission(_address);
+    Wire.write(0xE1);
+    Wire.write(0x08);
+    Wire.write(0x00);
+    return Wire.endTransmission() == 0;
+  }
+  uint8_t readRawData() {
+    auto& climate = Victor::Native::fakeClimate;
+    delayMicroseconds(climate.aht10ConversionMicros);
+    if (climate.fail) { return AHT10_ERROR; }
+    _temperature = climate.sampleTemperature();
+    _humidity = climate.sampleHumidity();
+    return true;
+  }
+  float readTemperature(bool readI2C = AHT10_FORCE_READ_DATA) {
+    if (readI2C && readRawData() == AHT10_ERROR) { return AHT10_ERROR; }
+    return _temperature;
+  }
+  float readHumidity(bool readI2C = AHT10_FORCE_READ_DATA) {
+    if (readI2C && readRawData() == AHT10_ERROR) { return AHT10_ERROR; }
+    return _humidity;
+  }
+  bool softReset() {
+    delay(20);
+    return true;
+  }
+
+ private:
+  uint8_t _address;
+  Victor::Native::FakeAht10Device _device;
+  float _temperature = 0;
+  float _humidity = 0;
+};
+
+#endif // AHT10_h
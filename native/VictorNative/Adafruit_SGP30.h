@@ -0,0 +1,108 @@
+#ifndef ADAFRUIT_SGP30_H
+#define ADAFRUIT_SGP30_H
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "FakeClimate.h"
+#include "SHT31.h"
+
+#define SGP30_I2CADDR_DEFAULT 0x58
+
+namespace Victor::Native {
+
+  // register level sgp30 on the fake bus, only measure_iaq 0x2008:
+  // the result is NACKed until the measure duration passed, like the real one
+  class FakeSgp30Device : public FakeI2cDevice {
+   public:
+    bool onWrite(const uint8_t* data, size_t length) override {
+      if (fakeClimate.fail) { return false; }
+      if (length == 0) { return true; } // address probe
+      if (length != 2 || data[0] != 0x20 || data[1] != 0x08) { return false; }
+      _ready = true;
+      _readyMicros = VirtualClock::nowMicros() + fakeClimate.sgp30MeasureMicros;
+      _co2 = fakeClimate.sampleCO2();
+      _tvoc = fakeClimate.sampleTVOC();
+      return true;
+    }
+    size_t onRead(uint8_t* data, size_t length) override {
+      if (fakeClimate.fail || length < 6 || !_ready || VirtualClock::nowMicros() < _readyMicros) { return 0; }
+      _ready = false;
+      data[0] = _co2 >> 8;
+      data[1] = _co2;
+      data[2] = FakeSht30Device::crc8(data, 2); // same crc as sensirion's sht3x
+      data[3] = _tvoc >> 8;
+      data[4] = _tvoc;
+      data[5] = FakeSht30Device::crc8(data + 3, 2);
+      return 6;
+    }
+
+   private:
+    bool _ready = false;
+    uint64_t _readyMicros = 0;
+    uint16_t _co2 = 0;
+    uint16_t _tvoc = 0;
+  };
+
+} // namespace Victor::Native
+
+// stand-in of adafruit/Adafruit SGP30 Sensor, blocks per command like the real one,
+// the measure_iaq split into command and read goes through the fake bus
+class Adafruit_SGP30 {
+ public:
+  uint16_t TVOC = 0;
+  uint16_t eCO2 = 0;
+  uint16_t serialnumber[3] = {};
+
+  ~Adafruit_SGP30() {
+    Wire.detach(SGP30_I2CADDR_DEFAULT);
+  }
+  bool begin() {
+    if (Victor::Native::fakeClimate.sgp30Missing) {
+      return _command(false);
+    }
+    Wire.attach(SGP30_I2CADDR_DEFAULT, &_device);
+    return _command(true);
+  }
+  bool softReset() {
+    return _command(true);
+  }
+  bool IAQinit() {
+    return _command(true);
+  }
+  bool IAQmeasure() {
+    auto& climate = Victor::Native::fakeClimate;
+    delayMicroseconds(climate.sgp30MeasureMicros);
+    if (climate.fail || Wire.isStuck()) { return false; }
+    eCO2 = climate.sampleCO2();
+    TVOC = climate.sampleTVOC();
+    return true;
+  }
+  bool getIAQBaseline(uint16_t* eco2Base, uint16_t* tvocBase) {
+    *eco2Base = _eco2Base;
+    *tvocBase = _tvocBase;
+    return _command(true);
+  }
+  bool setIAQBaseline(uint16_t eco2Base, uint16_t tvocBase) {
+    _eco2Base = eco2Base;
+    _tvocBase = tvocBase;
+    return _command(true);
+  }
+  bool setHumidity(uint32_t absoluteHumidity) {
+    humidityWrites++;
+    return _command(true);
+  }
+  // simulation
+  uint32_t humidityWrites = 0;
+
+ private:
+  Victor::Native::FakeSgp30Device _device;
+  uint16_t _eco2Base = 0x8973;
+  uint16_t _tvocBase = 0x8aae;
+  bool _command(bool result) {
+    auto& climate = Victor::Native::fakeClimate;
+    delayMicroseconds(climate.sgp30CommandMicros);
+    return result && !climate.fail && !Wire.isStuck();
+  }
+};
+
+#endif // ADAFRUIT_SGP30_H
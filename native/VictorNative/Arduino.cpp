@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include "Arduino.h"
+
+using namespace Victor::Native;
+
+EspClass ESP;
+
+unsigned long millis() {
+  return static_cast<unsigned long>(VirtualClock::nowMicros() / 1000);
+}
+
+unsigned long micros() {
+  return static_cast<unsigned long>(VirtualClock::nowMicros());
+}
+
+void delay(unsigned long ms) {
+  VirtualClock::advanceMillis(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+  VirtualClock::advanceMicros(us);
+}
+
+void yield() {}
+
+void (*Victor::Native::pinWriteHook)(uint8_t pin, uint8_t val) = nullptr;
+int (*Victor::Native::pinReadHook)(uint8_t pin) = nullptr;
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pinWriteHook != nullptr) {
+    pinWriteHook(pin, val);
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  const auto level = pinReadHook != nullptr ? pinReadHook(pin) : -1;
+  return level < 0 ? LOW : level;
+}
+
+uint32_t EspClass::getCycleCount() {
+  // 80MHz core clock
+  return static_cast<uint32_t>(VirtualClock::nowMicros() * 80);
+}
+
+std::string String::_fromDouble(double value, unsigned int decimalPlaces) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimalPlaces, value);
+  return buffer;
+}
+
+std::string String::_fromInteger(long value, unsigned char base) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), base == HEX ? "%lx" : "%ld", value);
+  return buffer;
+}
@@ -0,0 +1,109 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <functional>
+#include "VirtualClock.h"
+
+// time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// flash strings are plain strings on host
+class __FlashStringHelper;
+#define F(str) (reinterpret_cast<const __FlashStringHelper*>(str))
+#define PROGMEM
+#define PSTR(str) (str)
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper*>(p))
+#define pgm_read_byte(addr)  (*reinterpret_cast<const uint8_t*>(addr))
+#define pgm_read_word(addr)  (*reinterpret_cast<const uint16_t*>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t*>(addr))
+#define pgm_read_float(addr) (*reinterpret_cast<const float*>(addr))
+#define pgm_read_ptr(addr)   (*reinterpret_cast<const void* const*>(addr))
+#define strlen_P  strlen
+#define strcmp_P  strcmp
+#define strncmp_P strncmp
+#define memcpy_P  memcpy
+#define strncpy_P strncpy
+#define vsnprintf_P vsnprintf
+
+#define DEC 10
+#define HEX 16
+
+#define LOW  0x0
+#define HIGH 0x1
+#define INPUT  0x00
+#define OUTPUT 0x01
+#define INPUT_PULLUP      0x02
+#define OUTPUT_OPEN_DRAIN 0x03
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+namespace Victor::Native {
+  // simulation: lets the fake bus watch and drive its sda/scl pins
+  // the read hook returns -1 for pins it does not own
+  extern void (*pinWriteHook)(uint8_t pin, uint8_t val);
+  extern int (*pinReadHook)(uint8_t pin);
+} // namespace Victor::Native
+
+// minimal Arduino String on top of std::string
+class String {
+ public:
+  String(const char* str = "") : _str(str == nullptr ? "" : str) {}
+  String(const __FlashStringHelper* str) : String(reinterpret_cast<const char*>(str)) {}
+  String(const std::string& str) : _str(str) {}
+  explicit String(char c) : _str(1, c) {}
+  explicit String(int value, unsigned char base = 10) : _str(_fromInteger(value, base)) {}
+  explicit String(unsigned int value, unsigned char base = 10) : _str(_fromInteger(value, base)) {}
+  explicit String(unsigned char value, unsigned char base = 10) : _str(_fromInteger(value, base)) {}
+  explicit String(long value) : _str(std::to_string(value)) {}
+  explicit String(unsigned long value) : _str(std::to_string(value)) {}
+  explicit String(float value, unsigned int decimalPlaces = 2) : _str(_fromDouble(value, decimalPlaces)) {}
+  explicit String(double value, unsigned int decimalPlaces = 2) : _str(_fromDouble(value, decimalPlaces)) {}
+  const char* c_str() const { return _str.c_str(); }
+  unsigned int length() const { return _str.length(); }
+  bool isEmpty() const { return _str.empty(); }
+  String& operator+=(const String& rhs) { _str += rhs._str; return *this; }
+  String& operator+=(const char* rhs) { _str += rhs; return *this; }
+  String& operator+=(char rhs) { _str += rhs; return *this; }
+  bool operator==(const String& rhs) const { return _str == rhs._str; }
+  bool operator!=(const String& rhs) const { return _str != rhs._str; }
+  friend String operator+(const String& lhs, const String& rhs) { return String(lhs._str + rhs._str); }
+  friend String operator+(const String& lhs, const char* rhs) { return String(lhs._str + rhs); }
+  friend String operator+(const String& lhs, const __FlashStringHelper* rhs) { return String(lhs._str + reinterpret_cast<const char*>(rhs)); }
+
+ private:
+  std::string _str;
+  static std::string _fromDouble(double value, unsigned int decimalPlaces);
+  static std::string _fromInteger(long value, unsigned char base);
+};
+
+// esp8266 core helpers
+class EspClass {
+ public:
+  void wdtFeed() {}
+  void restart() {}
+  uint32_t getFreeHeap() { return 40 * 1024; }
+  uint32_t getMaxFreeBlockSize() { return 32 * 1024; }
+  uint8_t getHeapFragmentation() { return 0; }
+  uint32_t getCycleCount();
+  uint8_t getCpuFreqMHz() { return 80; }
+};
+extern EspClass ESP;
+
+#ifndef isnanf
+#define isnanf(x) isnan(x)
+#endif
+
+#endif // Arduino_h
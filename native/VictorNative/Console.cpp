@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include "Console.h"
+
+namespace Victor {
+
+  Console& Console::log() {
+    return newline().write(F("[log]"));
+  }
+
+  Console& Console::error() {
+    return newline().write(F("[error]"));
+  }
+
+  Console& Console::bracket(const String& msg) {
+    return write(String(F("[")) + msg + F("]"));
+  }
+
+  Console& Console::section(const String& title, const String& msg) {
+    return write(String(F(" ")) + title + (msg.isEmpty() ? String() : String(F(":")) + msg));
+  }
+
+  Console& Console::write(const String& msg) {
+    if (enabled) {
+      fputs(msg.c_str(), stdout);
+    }
+    return *this;
+  }
+
+  Console& Console::newline() {
+    if (enabled) {
+      fputs("\n", stdout);
+    }
+    return *this;
+  }
+
+  // global
+  Console console;
+
+} // namespace Victor
@@ -0,0 +1,28 @@
+#ifndef Console_h
+#define Console_h
+
+#include "Arduino.h"
+
+namespace Victor {
+
+  // writes to stdout when enabled, swallows everything otherwise
+  // so the benchmark pays for building messages but not for the terminal
+  class Console {
+   public:
+    bool enabled = false;
+    Console& log();
+    Console& error();
+    Console& bracket(const String& msg);
+    Console& section(const String& title, const String& msg = "");
+    Console& write(const String& msg);
+    Console& newline();
+  };
+
+  // global
+  extern Console console;
+
+} // namespace Victor
+
+using Victor::console;
+
+#endif // Console_h
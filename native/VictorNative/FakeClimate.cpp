@@ -0,0 +1,15 @@
+#include "FakeClimate.h"
+
+namespace Victor::Native {
+
+  float FakeClimate::noise(float amplitude) {
+    // lcg, uniform in [-amplitude, amplitude]
+    seed = seed * 1103515245 + 12345;
+    const auto unit = static_cast<float>((seed >> 8) & 0xFFFF) / 0xFFFF;
+    return (unit * 2 - 1) * amplitude;
+  }
+
+  // global
+  FakeClimate fakeClimate;
+
+} // namespace Victor::Native
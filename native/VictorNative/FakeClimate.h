@@ -0,0 +1,42 @@
+#ifndef FakeClimate_h
+#define FakeClimate_h
+
+#include <stdint.h>
+
+namespace Victor::Native {
+
+  // the air around the simulated sensors
+  // every reading picks up deterministic noise so notify paths see realistic churn
+  struct FakeClimate {
+    float temperature = 24.0;  // °C
+    float humidity    = 45.0;  // %RH
+    uint16_t co2      = 600;   // ppm
+    uint16_t tvoc     = 80;    // ppb
+    float temperatureNoise = 0.05;
+    float humidityNoise    = 0.3;
+    uint16_t co2Noise      = 8;
+    uint16_t tvocNoise     = 4;
+    // force every driver call to fail
+    bool fail = false;
+    // no sgp30 fitted, its begin() fails
+    bool sgp30Missing = false;
+    // conversion times from datasheets, in microseconds
+    uint32_t aht10ConversionMicros = 75000;
+    uint32_t sht30ConversionMicros = 15500;
+    uint32_t sgp30MeasureMicros    = 12000;
+    uint32_t sgp30CommandMicros    = 10000;
+    uint32_t seed = 1;
+
+    float noise(float amplitude);
+    float sampleTemperature() { return temperature + noise(temperatureNoise); }
+    float sampleHumidity() { return humidity + noise(humidityNoise); }
+    uint16_t sampleCO2() { return co2 + noise(co2Noise); }
+    uint16_t sampleTVOC() { return tvoc + noise(tvocNoise); }
+  };
+
+  // global
+  extern FakeClimate fakeClimate;
+
+} // namespace Victor::Native
+
+#endif // FakeClimate_h
@@ -0,0 +1,46 @@
+#ifndef I2cStorage_h
+#define I2cStorage_h
+
+#include <ArduinoJson.h>
+#include "LittleFS.h"
+
+namespace Victor::Components {
+
+  struct I2cSetting {
+    int8_t sdaPin = 4;
+    int8_t sclPin = 5;
+    // -1 = disabled
+    int8_t enablePin = -1;
+    uint8_t enableTrueValue = 0;
+  };
+
+  // host flavour of the home-esp8266 I2cStorage, {"sda":4,"scl":5,"en":[3,0]}
+  class I2cStorage {
+   public:
+    I2cStorage(const char* filePath = "/i2c.json") : _filePath(filePath) {}
+    I2cSetting* load() {
+      auto model = new I2cSetting();
+      auto file = LittleFS.open(_filePath, "r");
+      if (!file) {
+        return model;
+      }
+      StaticJsonDocument<128> doc;
+      const auto error = deserializeJson(doc, file);
+      file.close();
+      if (!error) {
+        model->sdaPin = doc[F("sda")];
+        model->sclPin = doc[F("scl")];
+        const auto enableArr = doc[F("en")];
+        model->enablePin = enableArr[0];
+        model->enableTrueValue = enableArr[1];
+      }
+      return model;
+    }
+
+   private:
+    const char* _filePath;
+  };
+
+} // namespace Victor::Components
+
+#endif // I2cStorage_h
@@ -0,0 +1,18 @@
+#ifndef IPAddress_h
+#define IPAddress_h
+
+#include "Arduino.h"
+
+// ipv4 only stand-in of the core IPAddress
+class IPAddress {
+ public:
+  IPAddress() {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _octets{ a, b, c, d } {}
+  uint8_t operator[](int index) const { return _octets[index]; }
+  bool isSet() const { return _octets[0] != 0 || _octets[1] != 0 || _octets[2] != 0 || _octets[3] != 0; }
+
+ private:
+  uint8_t _octets[4] = {};
+};
+
+#endif // IPAddress_h
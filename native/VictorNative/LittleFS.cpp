@@ -0,0 +1,106 @@
+#include <sys/stat.h>
+#include "LittleFS.h"
+
+fs::FS LittleFS;
+
+namespace fs {
+
+  size_t File::write(const uint8_t* buffer, size_t size) {
+    return _file == nullptr ? 0 : fwrite(buffer, 1, size, _file);
+  }
+
+  size_t File::write(uint8_t c) {
+    return write(&c, 1);
+  }
+
+  size_t File::read(uint8_t* buffer, size_t size) {
+    return _file == nullptr ? 0 : fread(buffer, 1, size, _file);
+  }
+
+  int File::read() {
+    return _file == nullptr ? -1 : fgetc(_file);
+  }
+
+  size_t File::readBytes(char* buffer, size_t size) {
+    return read(reinterpret_cast<uint8_t*>(buffer), size);
+  }
+
+  bool File::seek(uint32_t position, SeekMode mode) {
+    const auto whence = mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END;
+    return _file != nullptr && fseek(_file, position, whence) == 0;
+  }
+
+  size_t File::position() const {
+    return _file == nullptr ? 0 : ftell(_file);
+  }
+
+  size_t File::size() const {
+    if (_file == nullptr) {
+      return 0;
+    }
+    const auto current = ftell(_file);
+    fseek(_file, 0, SEEK_END);
+    const auto end = ftell(_file);
+    fseek(_file, current, SEEK_SET);
+    return end;
+  }
+
+  void File::flush() {
+    if (_file != nullptr) {
+      fflush(_file);
+    }
+  }
+
+  void File::close() {
+    if (_file != nullptr) {
+      fclose(_file);
+      _file = nullptr;
+    }
+  }
+
+  bool FS::begin() {
+    // create every level of the root directory
+    std::string path;
+    for (const auto c : std::string(VICTOR_NATIVE_FS_DIR) + "/") {
+      if (c == '/' && !path.empty()) {
+        mkdir(path.c_str(), 0755);
+      }
+      path += c;
+    }
+    return true;
+  }
+
+  File FS::open(const char* path, const char* mode) {
+    begin();
+    // esp8266 modes are text-free, always binary on host
+    std::string hostMode = mode;
+    hostMode += "b";
+    auto file = fopen(hostPath(path).c_str(), hostMode.c_str());
+    if (file == nullptr && hostMode == "rb") {
+      file = fopen(dataPath(path).c_str(), hostMode.c_str());
+    }
+    return File(file);
+  }
+
+  bool FS::exists(const char* path) {
+    struct stat info;
+    return stat(hostPath(path).c_str(), &info) == 0 || stat(dataPath(path).c_str(), &info) == 0;
+  }
+
+  bool FS::remove(const char* path) {
+    return ::remove(hostPath(path).c_str()) == 0;
+  }
+
+  bool FS::rename(const char* pathFrom, const char* pathTo) {
+    return ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+  }
+
+  std::string FS::hostPath(const char* path) {
+    return std::string(VICTOR_NATIVE_FS_DIR) + path;
+  }
+
+  std::string FS::dataPath(const char* path) {
+    return std::string(VICTOR_NATIVE_DATA_DIR) + path;
+  }
+
+} // namespace fs
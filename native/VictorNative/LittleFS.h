@@ -0,0 +1,68 @@
+#ifndef LittleFS_h
+#define LittleFS_h
+
+#include <stdio.h>
+#include "Arduino.h"
+
+// files not written yet on host fall back to the data dir the fs image is built from
+#ifndef VICTOR_NATIVE_DATA_DIR
+#define VICTOR_NATIVE_DATA_DIR "data"
+#endif
+
+#ifndef VICTOR_NATIVE_FS_DIR
+#define VICTOR_NATIVE_FS_DIR ".pio/native-fs"
+#endif
+
+namespace fs {
+
+  enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2,
+  };
+
+  // host file behind the esp8266 fs::File interface
+  class File {
+   public:
+    File(FILE* file = nullptr) : _file(file) {}
+    operator bool() const { return _file != nullptr; }
+    size_t write(const uint8_t* buffer, size_t size);
+    size_t write(uint8_t c);
+    size_t read(uint8_t* buffer, size_t size);
+    // Stream flavour used by ArduinoJson
+    int read();
+    size_t readBytes(char* buffer, size_t size);
+    bool seek(uint32_t position, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close();
+
+   private:
+    FILE* _file;
+  };
+
+  // flat host directory standing in for the LittleFS partition,
+  // read-only opens of files not written on host come from the data dir
+  class FS {
+   public:
+    bool begin();
+    File open(const char* path, const char* mode);
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* pathFrom, const char* pathTo);
+    // host path of a partition path
+    static std::string hostPath(const char* path);
+    static std::string dataPath(const char* path);
+  };
+
+} // namespace fs
+
+using fs::File;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+extern fs::FS LittleFS;
+
+#endif // LittleFS_h
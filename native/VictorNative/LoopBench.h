@@ -0,0 +1,59 @@
+#ifndef LoopBench_h
+#define LoopBench_h
+
+#include <chrono>
+#include <stdio.h>
+#include "VirtualClock.h"
+
+namespace Victor::Native {
+
+  // host cost and simulated blocking time of one phase of loop()
+  struct PhaseStats {
+    const char* name;
+    unsigned long calls = 0;
+    unsigned long busyCalls = 0; // calls that spent virtual time (touched a device)
+    uint64_t hostNanos = 0;
+    uint64_t hostMaxNanos = 0;
+    uint64_t virtualMicros = 0;
+    uint64_t virtualMaxMicros = 0;
+
+    PhaseStats(const char* name) : name(name) {}
+
+    template <typename TPhase>
+    void run(TPhase phase) {
+      const auto virtualStart = VirtualClock::nowMicros();
+      const auto hostStart = std::chrono::steady_clock::now();
+      phase();
+      const auto hostSpent = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - hostStart).count()
+      );
+      const auto virtualSpent = VirtualClock::nowMicros() - virtualStart;
+      calls++;
+      hostNanos += hostSpent;
+      hostMaxNanos = hostSpent > hostMaxNanos ? hostSpent : hostMaxNanos;
+      if (virtualSpent > 0) {
+        busyCalls++;
+        virtualMicros += virtualSpent;
+        virtualMaxMicros = virtualSpent > virtualMaxMicros ? virtualSpent : virtualMaxMicros;
+      }
+    }
+
+    static void printHeader() {
+      printf("%-12s %10s %10s %12s %12s %14s %14s\n", "phase", "calls", "busy", "host avg ns", "host max ns", "block avg us", "block max us");
+    }
+
+    void print() const {
+      printf(
+        "%-12s %10lu %10lu %12llu %12llu %14llu %14llu\n",
+        name, calls, busyCalls,
+        static_cast<unsigned long long>(calls > 0 ? hostNanos / calls : 0),
+        static_cast<unsigned long long>(hostMaxNanos),
+        static_cast<unsigned long long>(busyCalls > 0 ? virtualMicros / busyCalls : 0),
+        static_cast<unsigned long long>(virtualMaxMicros)
+      );
+    }
+  };
+
+} // namespace Victor::Native
+
+#endif // LoopBench_h
@@ -0,0 +1,126 @@
+#ifndef SHT31_h
+#define SHT31_h
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "FakeClimate.h"
+
+#define SHT_DEFAULT_ADDRESS 0x44
+
+namespace Victor::Native {
+
+  // register level sht30 on the fake bus: single shot without clock stretching (0x24xx),
+  // periodic mode (0x20xx~0x27xx) fetched with 0xE000, break 0x3093, soft reset 0x30A2;
+  // a read before a result is ready is NACKed like the real one does,
+  // periodic mode takes only fetch and break, a soft reset needs a break first
+  class FakeSht30Device : public FakeI2cDevice {
+   public:
+    bool onWrite(const uint8_t* data, size_t length) override {
+      if (fakeClimate.fail || length != 2) { return false; }
+      const auto now = VirtualClock::nowMicros();
+      const uint16_t command = (data[0] << 8) | data[1];
+      if (command == 0x30A2 && _periodMicros > 0) { return false; }
+      if (command == 0x30A2 || command == 0x3093) {
+        _periodMicros = 0;
+        _ready = false;
+        return true;
+      }
+      if (command == 0xE000) {
+        // latest periodic result, once per period
+        if (_periodMicros == 0) { return false; }
+        const auto count = (now - _startMicros) / _periodMicros;
+        _ready = count > _fetched;
+        if (_ready) {
+          _fetched = count;
+          _readyMicros = now;
+          _convert();
+        }
+        return true;
+      }
+      if (_periodMicros > 0) { return false; } // only fetch and break in periodic mode
+      if (data[0] == 0x24) {
+        _ready = true;
+        _readyMicros = now + (data[1] == 0x00 ? fakeClimate.sht30ConversionMicros : data[1] == 0x0B ? 6000 : 4000);
+        _convert();
+        return true;
+      }
+      static const uint8_t msbs[] = { 0x20, 0x21, 0x22, 0x23, 0x27 };
+      static const uint32_t periods[] = { 2000000, 1000000, 500000, 250000, 100000 };
+      for (auto i = 0; i < 5; i++) {
+        if (data[0] == msbs[i]) {
+          _periodMicros = periods[i];
+          _startMicros = now;
+          _fetched = 0;
+          _ready = false;
+          return true;
+        }
+      }
+      return false;
+    }
+    size_t onRead(uint8_t* data, size_t length) override {
+      if (fakeClimate.fail || length < 6 || !_ready || VirtualClock::nowMicros() < _readyMicros) { return 0; }
+      _ready = false;
+      data[0] = _rawTemperature >> 8;
+      data[1] = _rawTemperature;
+      data[2] = crc8(data, 2);
+      data[3] = _rawHumidity >> 8;
+      data[4] = _rawHumidity;
+      data[5] = crc8(data + 3, 2);
+      return 6;
+    }
+    static uint8_t crc8(const uint8_t* data, size_t length) {
+      uint8_t crc = 0xFF;
+      for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (auto bit = 0; bit < 8; bit++) {
+          crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+        }
+      }
+      return crc;
+    }
+
+   private:
+    bool _ready = false;
+    uint64_t _readyMicros = 0;
+    uint64_t _startMicros = 0;
+    uint32_t _periodMicros = 0;
+    uint64_t _fetched = 0;
+    uint16_t _rawTemperature = 0;
+    uint16_t _rawHumidity = 0;
+    void _convert() {
+      const auto humidity = std::max(0.0f, std::min(100.0f, fakeClimate.sampleHumidity()));
+      const auto temperature = std::max(-45.0f, std::min(130.0f, fakeClimate.sampleTemperature()));
+      _rawHumidity = lroundf(humidity * 65535 / 100);
+      _rawTemperature = lroundf((temperature + 45) * 65535 / 175);
+    }
+  };
+
+} // namespace Victor::Native
+
+// stand-in of robtillaart/SHT31, only bring up and reset; measuring goes through the fake bus
+class SHT31 {
+ public:
+  ~SHT31() {
+    Wire.detach(_address);
+  }
+  bool begin(const uint8_t address = SHT_DEFAULT_ADDRESS) {
+    _address = address;
+    Wire.attach(_address, &_device);
+    return reset();
+  }
+  bool reset(bool hard = false) {
+    // soft reset 0x30A2, also ends periodic mode
+    Wire.beginTransmission(_address);
+    Wire.write(0x30);
+    Wire.write(0xA2);
+    const auto ok = Wire.endTransmission() == 0;
+    delay(1);
+    return ok;
+  }
+
+ private:
+  uint8_t _address = SHT_DEFAULT_ADDRESS;
+  Victor::Native::FakeSht30Device _device;
+};
+
+#endif // SHT31_h
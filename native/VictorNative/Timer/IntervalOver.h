@@ -0,0 +1,29 @@
+#ifndef IntervalOver_h
+#define IntervalOver_h
+
+#include "../Arduino.h"
+
+namespace Victor::Components {
+
+  class IntervalOver {
+   public:
+    IntervalOver(unsigned long interval) : _interval(interval) {}
+    void start(unsigned long timespan = 0) {
+      _startTimespan = timespan > 0 ? timespan : millis();
+    }
+    void stop() {
+      _startTimespan = 0;
+    }
+    bool isOver(unsigned long timespan = 0) {
+      if (timespan == 0) { timespan = millis(); }
+      return timespan - _startTimespan >= _interval;
+    }
+
+   protected:
+    unsigned long _interval = 0;
+    unsigned long _startTimespan = 0;
+  };
+
+} // namespace Victor::Components
+
+#endif // IntervalOver_h
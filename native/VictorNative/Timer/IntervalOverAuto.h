@@ -0,0 +1,22 @@
+#ifndef IntervalOverAuto_h
+#define IntervalOverAuto_h
+
+#include "IntervalOver.h"
+
+namespace Victor::Components {
+
+  // restarts itself once over
+  class IntervalOverAuto : public IntervalOver {
+   public:
+    IntervalOverAuto(unsigned long interval) : IntervalOver(interval) {}
+    bool isOver(unsigned long timespan = 0) {
+      if (timespan == 0) { timespan = millis(); }
+      const auto over = IntervalOver::isOver(timespan);
+      if (over) { start(timespan); }
+      return over;
+    }
+  };
+
+} // namespace Victor::Components
+
+#endif // IntervalOverAuto_h
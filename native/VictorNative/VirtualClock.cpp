@@ -0,0 +1,23 @@
+#include "VirtualClock.h"
+
+namespace Victor::Native {
+
+  static uint64_t _nowMicros = 0;
+
+  uint64_t VirtualClock::nowMicros() {
+    return _nowMicros;
+  }
+
+  void VirtualClock::advanceMicros(uint64_t micros) {
+    _nowMicros += micros;
+  }
+
+  void VirtualClock::advanceMillis(uint64_t millis) {
+    _nowMicros += millis * 1000;
+  }
+
+  void VirtualClock::reset(uint64_t micros) {
+    _nowMicros = micros;
+  }
+
+} // namespace Victor::Native
@@ -0,0 +1,21 @@
+#ifndef VirtualClock_h
+#define VirtualClock_h
+
+#include <stdint.h>
+
+namespace Victor::Native {
+
+  // simulated time source behind millis()/micros()/delay()
+  // nothing advances it except delay() calls and the host program itself,
+  // so everything a driver spends waiting on the bus shows up as virtual time
+  class VirtualClock {
+   public:
+    static uint64_t nowMicros();
+    static void advanceMicros(uint64_t micros);
+    static void advanceMillis(uint64_t millis);
+    static void reset(uint64_t micros = 0);
+  };
+
+} // namespace Victor::Native
+
+#endif // VirtualClock_h
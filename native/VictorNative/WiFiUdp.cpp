@@ -0,0 +1,49 @@
+#include "WiFiUdp.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+unsigned long WiFiUDP::packets = 0;
+
+WiFiUDP::~WiFiUDP() {
+  stop();
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+  if (_socket < 0) {
+    _socket = socket(AF_INET, SOCK_DGRAM, 0);
+  }
+  _ip = ip;
+  _port = port;
+  _packet.clear();
+  return _socket >= 0 ? 1 : 0;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size) {
+  _packet.insert(_packet.end(), buffer, buffer + size);
+  return size;
+}
+
+int WiFiUDP::endPacket() {
+  if (_socket < 0) {
+    return 0;
+  }
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(_port);
+  address.sin_addr.s_addr = htonl((_ip[0] << 24) | (_ip[1] << 16) | (_ip[2] << 8) | _ip[3]);
+  const auto sent = sendto(_socket, _packet.data(), _packet.size(), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  _packet.clear();
+  if (sent < 0) {
+    return 0;
+  }
+  packets++;
+  return 1;
+}
+
+void WiFiUDP::stop() {
+  if (_socket >= 0) {
+    close(_socket);
+    _socket = -1;
+  }
+}
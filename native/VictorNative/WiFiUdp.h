@@ -0,0 +1,27 @@
+#ifndef WiFiUdp_h
+#define WiFiUdp_h
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+// stand-in of the core WiFiUDP on a real host socket, so frames reach a listener on localhost
+// only the sending side: beginPacket, write, endPacket
+class WiFiUDP {
+ public:
+  ~WiFiUDP();
+  int beginPacket(IPAddress ip, uint16_t port);
+  size_t write(const uint8_t* buffer, size_t size);
+  // 1 = datagram handed to the host stack
+  int endPacket();
+  void stop();
+  // simulation: datagrams sent since boot
+  static unsigned long packets;
+
+ private:
+  int _socket = -1;
+  IPAddress _ip;
+  uint16_t _port = 0;
+  std::vector<uint8_t> _packet;
+};
+
+#endif // WiFiUdp_h
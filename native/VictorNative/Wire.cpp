@@ -0,0 +1,143 @@
+#include "Wire.h"
+
+using namespace Victor::Native;
+
+TwoWire Wire;
+
+void TwoWire::begin(int sda, int scl) {
+  _sdaPin = sda;
+  _sclPin = scl;
+  pinWriteHook = &TwoWire::_onPinWrite;
+  pinReadHook = &TwoWire::_onPinRead;
+}
+
+void TwoWire::setClock(uint32_t frequency) {
+  _frequency = frequency;
+}
+
+void TwoWire::setClockStretchLimit(uint32_t limit) {}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _address = address;
+  _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (_txLength >= sizeof(_txBuffer)) { return 0; }
+  _txBuffer[_txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+  size_t written = 0;
+  while (written < length && write(data[written]) == 1) {
+    written++;
+  }
+  return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  transactions++;
+  // address byte plus payload
+  _spendBytes(_txLength + 1);
+  if (_stuckClocks > 0) {
+    return 4; // bus error, sda never released
+  }
+  if (_unfitted[_address & 0x7F]) {
+    return 2; // address NACK
+  }
+  const auto device = _devices[_address & 0x7F];
+  if (device == nullptr) {
+    return _txLength == 0 && _plugged[_address & 0x7F] ? 0 : 2; // address NACK
+  }
+  return device->onWrite(_txBuffer, _txLength) ? 0 : 3; // data NACK
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+  transactions++;
+  _rxIndex = 0;
+  _rxLength = 0;
+  if (_stuckClocks > 0) {
+    _spendBytes(1);
+    return 0;
+  }
+  const auto device = _unfitted[address & 0x7F] ? nullptr : _devices[address & 0x7F];
+  if (device == nullptr) {
+    _spendBytes(1);
+    return 0;
+  }
+  _rxLength = device->onRead(_rxBuffer, std::min<size_t>(quantity, sizeof(_rxBuffer)));
+  _spendBytes(_rxLength + 1);
+  return _rxLength;
+}
+
+int TwoWire::available() {
+  return _rxLength - _rxIndex;
+}
+
+int TwoWire::read() {
+  return _rxIndex < _rxLength ? _rxBuffer[_rxIndex++] : -1;
+}
+
+void TwoWire::attach(uint8_t address, FakeI2cDevice* device) {
+  _devices[address & 0x7F] = device;
+}
+
+void TwoWire::detach(uint8_t address) {
+  _devices[address & 0x7F] = nullptr;
+}
+
+void TwoWire::plug(uint8_t address) {
+  _plugged[address & 0x7F] = true;
+}
+
+void TwoWire::unplug(uint8_t address) {
+  _plugged[address & 0x7F] = false;
+}
+
+void TwoWire::unfit(uint8_t address) {
+  _unfitted[address & 0x7F] = true;
+}
+
+void TwoWire::fit(uint8_t address) {
+  _unfitted[address & 0x7F] = false;
+}
+
+void TwoWire::stick(uint8_t clocks) {
+  _stuckClocks = clocks;
+}
+
+bool TwoWire::isStuck() const {
+  return _stuckClocks > 0;
+}
+
+int8_t TwoWire::getSdaPin() const {
+  return _sdaPin;
+}
+
+int8_t TwoWire::getSclPin() const {
+  return _sclPin;
+}
+
+void TwoWire::_onPinWrite(uint8_t pin, uint8_t val) {
+  if (pin != Wire._sclPin) {
+    return;
+  }
+  // the stuck slave shifts one bit out per rising edge
+  if (val == HIGH && Wire._sclLevel == LOW && Wire._stuckClocks > 0) {
+    Wire._stuckClocks--;
+  }
+  Wire._sclLevel = val;
+}
+
+int TwoWire::_onPinRead(uint8_t pin) {
+  if (pin == Wire._sdaPin) {
+    return Wire._stuckClocks > 0 ? LOW : HIGH;
+  }
+  return pin == Wire._sclPin ? Wire._sclLevel : -1;
+}
+
+void TwoWire::_spendBytes(size_t bytes) {
+  // 9 clocks per byte (8 data + ack)
+  VirtualClock::advanceMicros(bytes * 9 * 1000000ULL / _frequency);
+}
@@ -0,0 +1,70 @@
+#ifndef Wire_h
+#define Wire_h
+
+#include "Arduino.h"
+
+namespace Victor::Native {
+
+  // a device answering on the simulated bus
+  class FakeI2cDevice {
+   public:
+    virtual ~FakeI2cDevice() {}
+    // master wrote a full transaction; false = NACK
+    virtual bool onWrite(const uint8_t* data, size_t length) = 0;
+    // master reads up to length bytes; returns bytes served
+    virtual size_t onRead(uint8_t* data, size_t length) = 0;
+  };
+
+} // namespace Victor::Native
+
+class TwoWire {
+ public:
+  void begin(int sda = -1, int scl = -1);
+  void setClock(uint32_t frequency);
+  void setClockStretchLimit(uint32_t limit);
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t* data, size_t length);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+  int available();
+  int read();
+  // simulation
+  void attach(uint8_t address, Victor::Native::FakeI2cDevice* device);
+  void detach(uint8_t address);
+  // a device wired to the bus, acks an address probe before its driver attached a model
+  void plug(uint8_t address);
+  void unplug(uint8_t address);
+  // a device missing from the board: its stand-in attaches in vain and the address NACKs until fit()
+  void unfit(uint8_t address);
+  void fit(uint8_t address);
+  // a slave holds sda low mid-byte: every transaction fails until scl is clocked that many times
+  void stick(uint8_t clocks = 9);
+  bool isStuck() const;
+  int8_t getSdaPin() const;
+  int8_t getSclPin() const;
+  uint32_t transactions = 0;
+
+ private:
+  Victor::Native::FakeI2cDevice* _devices[128] = {};
+  bool _plugged[128] = {};
+  bool _unfitted[128] = {};
+  int8_t _sdaPin = -1;
+  int8_t _sclPin = -1;
+  uint8_t _sclLevel = HIGH;
+  uint8_t _stuckClocks = 0;
+  static void _onPinWrite(uint8_t pin, uint8_t val);
+  static int _onPinRead(uint8_t pin);
+  uint32_t _frequency = 100000;
+  uint8_t _address = 0;
+  uint8_t _txBuffer[32] = {};
+  size_t _txLength = 0;
+  uint8_t _rxBuffer[32] = {};
+  size_t _rxLength = 0;
+  size_t _rxIndex = 0;
+  void _spendBytes(size_t bytes);
+};
+
+extern TwoWire Wire;
+
+#endif // Wire_h
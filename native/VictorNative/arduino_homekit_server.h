@@ -0,0 +1,23 @@
+#ifndef arduino_homekit_server_h
+#define arduino_homekit_server_h
+
+#include "homekit/homekit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  bool paired;
+} homekit_server_t;
+
+void arduino_homekit_setup(homekit_server_config_t* config);
+void arduino_homekit_loop();
+homekit_server_t* arduino_homekit_get_running_server();
+int arduino_homekit_connected_clients_count();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // arduino_homekit_server_h
@@ -0,0 +1,15 @@
+#ifndef __HOMEKIT_CHARACTERISTICS_H__
+#define __HOMEKIT_CHARACTERISTICS_H__
+
+#include <stdio.h>
+#include "types.h"
+
+// just enough of the HomeKit-ESP8266 declaration macros to build src/accessory.c (as c) on host,
+// types are kept as their names and the initial values are left out
+
+#define HOMEKIT_CHARACTERISTIC_(name, value, ...) { .type = #name, ##__VA_ARGS__ }
+#define HOMEKIT_CHARACTERISTIC(name, value, ...) &(homekit_characteristic_t) HOMEKIT_CHARACTERISTIC_(name, value, ##__VA_ARGS__)
+#define HOMEKIT_SERVICE_(name, ...) { .type = #name, ##__VA_ARGS__ }
+#define HOMEKIT_ACCESSORY_(...) { __VA_ARGS__ }
+
+#endif // __HOMEKIT_CHARACTERISTICS_H__
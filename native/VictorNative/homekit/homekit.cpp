@@ -0,0 +1,34 @@
+#include "homekit.h"
+#include "../arduino_homekit_server.h"
+
+static homekit_server_t _server = { .paired = true };
+
+extern "C" {
+
+  unsigned long homekit_native_notify_count = 0;
+
+  void homekit_characteristic_notify(homekit_characteristic_t* ch, const homekit_value_t value) {
+    homekit_native_notify_count++;
+  }
+
+  bool homekit_is_paired() {
+    return _server.paired;
+  }
+
+  void homekit_server_reset() {
+    _server.paired = false;
+  }
+
+  void arduino_homekit_setup(homekit_server_config_t* config) {}
+
+  void arduino_homekit_loop() {}
+
+  homekit_server_t* arduino_homekit_get_running_server() {
+    return &_server;
+  }
+
+  int arduino_homekit_connected_clients_count() {
+    return 1;
+  }
+
+} // extern "C"
@@ -0,0 +1,21 @@
+#ifndef __HOMEKIT_H__
+#define __HOMEKIT_H__
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// host stand-in only counts what would have been sent
+void homekit_characteristic_notify(homekit_characteristic_t* ch, const homekit_value_t value);
+extern unsigned long homekit_native_notify_count;
+
+bool homekit_is_paired();
+void homekit_server_reset();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HOMEKIT_H__
@@ -0,0 +1,66 @@
+#ifndef __HOMEKIT_TYPES_H__
+#define __HOMEKIT_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// only the slice of the HomeKit-ESP8266 object model the firmware core touches
+
+typedef enum {
+  homekit_format_bool,
+  homekit_format_uint8,
+  homekit_format_float,
+  homekit_format_string,
+} homekit_format_t;
+
+typedef struct {
+  bool is_null;
+  homekit_format_t format;
+  union {
+    bool bool_value;
+    uint8_t uint8_value;
+    int int_value;
+    float float_value;
+    char* string_value;
+  };
+} homekit_value_t;
+
+typedef struct _homekit_characteristic homekit_characteristic_t;
+typedef struct _homekit_service homekit_service_t;
+typedef struct _homekit_accessory homekit_accessory_t;
+
+struct _homekit_characteristic {
+  homekit_service_t* service;
+  unsigned int id;
+  const char* type;
+  const char* description;
+  homekit_value_t value;
+};
+
+struct _homekit_service {
+  homekit_accessory_t* accessory;
+  unsigned int id;
+  const char* type;
+  bool hidden;
+  bool primary;
+  homekit_characteristic_t** characteristics;
+};
+
+typedef enum {
+  homekit_accessory_category_bridge = 2,
+  homekit_accessory_category_sensor = 10,
+} homekit_accessory_category_t;
+
+struct _homekit_accessory {
+  unsigned int id;
+  homekit_accessory_category_t category;
+  homekit_service_t** services;
+};
+
+typedef struct {
+  homekit_accessory_t** accessories;
+  const char* password;
+  uint16_t config_number;
+} homekit_server_config_t;
+
+#endif // __HOMEKIT_TYPES_H__
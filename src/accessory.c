@@ -110,42 +110,46 @@ homekit_service_t airQualityInformationService = HOMEKIT_SERVICE_(ACCESSORY_INFO
   },
 );
 
-homekit_accessory_t* accessories[] = {
-  HOMEKIT_ACCESSORY(
-    .id = 1,
-    .category = homekit_accessory_category_bridge,
-    .services = (homekit_service_t*[]) {
-      &informationService,
-      NULL,
-    },
-  ),
-  HOMEKIT_ACCESSORY(
-    .id = 2,
-    .category = homekit_accessory_category_sensor,
-    .services = (homekit_service_t*[]) {
-      &temperatureInformationService,
-      &temperatureService,
-      NULL,
-    },
-  ),
-  HOMEKIT_ACCESSORY(
-    .id = 3,
-    .category = homekit_accessory_category_sensor,
-    .services = (homekit_service_t*[]) {
-      &humidityInformationService,
-      &humidityService,
-      NULL,
-    },
-  ),
-  HOMEKIT_ACCESSORY(
-    .id = 4,
-    .category = homekit_accessory_category_sensor,
-    .services = (homekit_service_t*[]) {
-      &airQualityInformationService,
-      &airQualityService,
-      NULL,
-    },
-  ),
+// the pool, ids stay fixed whichever accessories are advertised
+homekit_accessory_t bridgeAccessory = HOMEKIT_ACCESSORY_(
+  .id = 1,
+  .category = homekit_accessory_category_bridge,
+  .services = (homekit_service_t*[]) {
+    &informationService,
+    NULL,
+  },
+);
+homekit_accessory_t temperatureAccessory = HOMEKIT_ACCESSORY_(
+  .id = 2,
+  .category = homekit_accessory_category_sensor,
+  .services = (homekit_service_t*[]) {
+    &temperatureInformationService,
+    &temperatureService,
+    NULL,
+  },
+);
+homekit_accessory_t humidityAccessory = HOMEKIT_ACCESSORY_(
+  .id = 3,
+  .category = homekit_accessory_category_sensor,
+  .services = (homekit_service_t*[]) {
+    &humidityInformationService,
+    &humidityService,
+    NULL,
+  },
+);
+homekit_accessory_t airQualityAccessory = HOMEKIT_ACCESSORY_(
+  .id = 4,
+  .category = homekit_accessory_category_sensor,
+  .services = (homekit_service_t*[]) {
+    &airQualityInformationService,
+    &airQualityService,
+    NULL,
+  },
+);
+
+// bridge plus the accessories of the sensors found at boot, NULL terminated
+homekit_accessory_t* accessories[5] = {
+  &bridgeAccessory,
   NULL,
 };
 
@@ -153,3 +157,19 @@ homekit_server_config_t serverConfig = {
   .accessories = accessories,
   .password = VICTOR_ACCESSORY_SERVER_PASSWORD,
 };
+
+void accessoryBuild(bool hasHT, bool hasAQ, uint16_t configNumber) {
+  int count = 0;
+  accessories[count++] = &bridgeAccessory;
+  if (hasHT) {
+    accessories[count++] = &temperatureAccessory;
+    accessories[count++] = &humidityAccessory;
+  }
+  if (hasAQ) {
+    accessories[count++] = &airQualityAccessory;
+  }
+  accessories[count] = NULL;
+  // paired controllers fetch the database again once the configuration number moves,
+  // accessoryLayout moves it forward on every layout change
+  serverConfig.config_number = configNumber;
+}
@@ -1,197 +1,192 @@
 #include <Arduino.h>
 #include <Wire.h>
+#include <ESP8266WebServer.h>
 #include <arduino_homekit_server.h>
 
 #include <AppMain/AppMain.h>
 #include <GlobalHelpers.h>
-#include <I2cStorage/I2cStorage.h>
 #include <Button/ActionButtonInterrupt.h>
 
 #include "ClimateStorage.h"
-#include "HTSensor.h"
+#include "ConfigImage.h"
 #include "AQSensor.h"
+#include "ClimateMeasure.h"
+#include "SensorBoot.h"
+#include "BootTimeline.h"
+#include "I2cBus.h"
+#include "LoopProfiler.h"
+#include "Metrics.h"
+#include "EventLog.h"
+#include "PortalSnapshot.h"
+#include "Telemetry.h"
+#include "AccessoryLayout.h"
 
 using namespace Victor;
 using namespace Victor::Components;
 
-// temperature
-extern "C" homekit_characteristic_t temperatureState;
-extern "C" homekit_characteristic_t temperatureActiveState;
-// humidity
-extern "C" homekit_characteristic_t humidityState;
-extern "C" homekit_characteristic_t humidityActiveState;
-// air quality
-extern "C" homekit_characteristic_t carbonDioxideState;
-extern "C" homekit_characteristic_t vocDensityState;
-extern "C" homekit_characteristic_t airQualityState;
-extern "C" homekit_characteristic_t airQualityActiveState;
+// upper bound of one loop sleep
+#ifndef VICTOR_LOOP_SLEEP_MAX_MILLIS
+#define VICTOR_LOOP_SLEEP_MAX_MILLIS 20
+#endif
+
+// csv data on http://<host>:<port>/history, /boot, /i2c, /loop, /metrics and /state
+#ifndef VICTOR_DATA_PORT
+#define VICTOR_DATA_PORT 8080
+#endif
+#define VICTOR_DATA_CHUNK_SIZE 256
+
 // others
 extern "C" homekit_characteristic_t accessoryName;
 extern "C" homekit_characteristic_t accessorySerialNumber;
 extern "C" homekit_server_config_t serverConfig;
+extern "C" void accessoryBuild(bool hasHT, bool hasAQ, uint16_t configNumber);
 
 AppMain* appMain = nullptr;
 ActionButtonInterrupt* button = nullptr;
 
-ClimateSetting* climate = nullptr;
-HTSensor* ht = nullptr;
+const ClimateSetting* climate = nullptr;
+// from sensorRegistry once sensorBoot is done
+HTFusion* ht = nullptr;
 AQSensor* aq = nullptr;
+ClimateMeasure* measure = nullptr;
+SensorBoot* sensorBoot = nullptr;
+// readings as udp frames, when climate.json names a listener
+TelemetryExporter* telemetry = nullptr;
+ESP8266WebServer* dataServer = nullptr;
+
+// the accessory database follows the sensors created, so the server starts once sensorBoot created them
+bool homekitStarted = false;
+
+// micros of the boot milestones reached from loop(), 0 = not yet
+unsigned long bootWifiMicros = 0;
+unsigned long bootReadingMicros = 0;
 
 String hostName;
 String serialNumber;
 
-enum AirQuality {
-  AIR_QUALITY_UNKNOWN   = 0,
-  AIR_QUALITY_EXCELLENT = 1,
-  AIR_QUALITY_GOOD      = 2,
-  AIR_QUALITY_FAIR      = 3,
-  AIR_QUALITY_INFERIOR  = 4,
-  AIR_QUALITY_POOR      = 5,
-};
+void setup(void) {
+  bootTimeline.mark(F("setup"));
+  appMain = new AppMain();
+  appMain->setup();
+  bootTimeline.mark(F("app"));
 
-String toAirQualityName(const uint8_t state) {
-  return (
-    state == AIR_QUALITY_EXCELLENT ? F("Excellent") :
-    state == AIR_QUALITY_GOOD      ? F("Good") :
-    state == AIR_QUALITY_FAIR      ? F("Fair") :
-    state == AIR_QUALITY_INFERIOR  ? F("Inferior") :
-    state == AIR_QUALITY_POOR      ? F("Poor") : F("Unknown")
-  );
-}
+  // settings, from the binary image unless the json is new
+  const auto& config = configImage.load();
+  console.log()
+    .bracket(F("config"))
+    .section(F("source"), configImage.getSource() == CONFIG_SOURCE_IMAGE ? F("image") : F("json"))
+    .section(F("micros"), String(configImage.getLoadMicros()));
+  bootTimeline.mark(F("config"));
 
-AirQuality toAirQuality(const float value) {
-  // 0 ~ 49
-  if (value < 49) {
-    return AIR_QUALITY_EXCELLENT;
-  }
-  // 50 ~ 99
-  if (value < 99) {
-    return AIR_QUALITY_GOOD;
-  }
-  // 100 ~ 299
-  if (value < 399) {
-    return AIR_QUALITY_FAIR;
-  }
-  // 300 ~ 599
-  if (value < 599) {
-    return AIR_QUALITY_INFERIOR;
-  }
-  // 600 ~ 1000
-  return AIR_QUALITY_POOR;
-}
+  // sensors are brought up from loop(), the i2c power cycle runs while wifi and homekit start
+  climate = &climateStorage.load();
+  sensorBoot = new SensorBoot(config.i2c, climate, &sensorRegistry);
+  sensorBoot->loop(); // power off right away
 
-void measureHT(const bool notify) {
-  const auto state = ht->measure();
-  if (state == MEASURE_SKIPPED) { return; }
-  const auto htOk = state == MEASURE_SUCCESS;
-  if (temperatureActiveState.value.bool_value != htOk) {
-    temperatureActiveState.value.bool_value = htOk;
-    if (notify) {
-      homekit_characteristic_notify(&temperatureActiveState, temperatureActiveState.value);
+  // portal states, rendered into the snapshot when a reading changed and served from there
+  portalSnapshot.onRender = [](PortalSnapshot& snapshot) {
+    snapshot.add(F("Service"), PSTR("%s"), VICTOR_ACCESSORY_SERVICE_NAME);
+    snapshot.addCenti(F("Temperature"), lroundf(temperatureState.value.float_value * 100), F("°C"));
+    snapshot.addCenti(F("Humidity"), lroundf(humidityState.value.float_value * 100), F("%"));
+    snapshot.addCenti(F("CO2 Level"), lroundf(carbonDioxideState.value.float_value * 100), F("ppm/㎥"));
+    snapshot.addCenti(F("VOC Density"), lroundf(vocDensityState.value.float_value * 100), F("ppb/㎥"));
+    snapshot.add(F("Air Quality"), PSTR("%s"), toAirQualityName(airQualityState.value.uint8_value).c_str());
+    if (bootReadingMicros > 0) {
+      snapshot.add(F("Boot"), PSTR("%lums to reading"), bootReadingMicros / 1000);
     }
-  }
-  if (humidityActiveState.value.bool_value != htOk) {
-    humidityActiveState.value.bool_value = htOk;
-    if (notify) {
-      homekit_characteristic_notify(&humidityActiveState, humidityActiveState.value);
+    if (climate->fusion.scan) {
+      snapshot.add(F("I2C"), PSTR("%s"), sensorRegistry.describe().c_str());
     }
-  }
-  if (htOk) {
-    auto temperature = ht->getTemperature();
-    if (!isnanf(temperature)) {
-      temperature += climate->revise->temperature;
-      const auto temperatureFix = std::max<float>(0, std::min<float>(100, temperature)); // 0~100
-      if (temperatureState.value.float_value != temperatureFix) {
-        temperatureState.value.float_value = temperatureFix;
-        if (notify) {
-          homekit_characteristic_notify(&temperatureState, temperatureState.value);
-        }
-      }
+    if (i2cBus.getClears() > 0) {
+      snapshot.add(F("I2C Clears"), PSTR("%lu stuck bus recovered"), static_cast<unsigned long>(i2cBus.getClears()));
     }
-    auto humidity = ht->getHumidity();
-    if (!isnanf(humidity)) {
-      humidity += climate->revise->humidity;
-      const auto humidityFix = std::max<float>(0, std::min<float>(100, humidity)); // 0~100
-      if (humidityState.value.float_value != humidityFix) {
-        humidityState.value.float_value = humidityFix;
-        if (notify) {
-          homekit_characteristic_notify(&humidityState, humidityState.value);
-        }
-      }
+    if (ht != nullptr) {
+      snapshot.add(F("HT Sensors"), PSTR("%u of %u fused"), ht->getFusedCount(), ht->size());
+      snapshot.add(F("HT Block"), PSTR("%luus"), static_cast<unsigned long>(ht->getMaxBlockMicros()));
+    }
+    if (measure != nullptr) {
+      const auto& batch = measure->getNotifyBatch();
+      const auto& stats = batch.getStats();
+      snapshot.add(F("Notify"), PSTR("%lu sent, %lu saved by batching"), stats.sent, stats.saved);
     }
-    console.log()
-      .bracket(F("ht"))
-      .section(F("h"), String(humidity))
-      .section(F("t"), String(temperature));
-    // write to AQ
     if (aq != nullptr) {
-      aq->setRelHumidity(humidity, temperature);
+      snapshot.add(F("AQ Comp"), PSTR("%lu writes, %lu saved"), static_cast<unsigned long>(aq->getHumidityWrites()), static_cast<unsigned long>(aq->getHumiditySkips()));
+      const auto& sampling = aq->getSampling();
+      snapshot.add(F("AQ Jitter"), PSTR("%luus avg, %luus max"), static_cast<unsigned long>(sampling.jitterAvgMicros()), static_cast<unsigned long>(sampling.jitterMaxMicros));
     }
-  }
-}
-
-void measureAQ(const bool notify) {
-  const auto state = aq->measure();
-  if (state == MEASURE_SKIPPED) { return; }
-  const auto aqOk = state == MEASURE_SUCCESS;
-  if (airQualityActiveState.value.bool_value != aqOk) {
-    airQualityActiveState.value.bool_value = aqOk;
-    if (notify) {
-      homekit_characteristic_notify(&airQualityActiveState, airQualityActiveState.value);
+    const auto& heap = metrics.getHeap();
+    snapshot.add(
+      F("Heap"), PSTR("%lu free, %lu min, %lu block, %u%% frag"),
+      static_cast<unsigned long>(heap.free), static_cast<unsigned long>(heap.freeMin), static_cast<unsigned long>(heap.maxBlock), heap.fragmentation
+    );
+    snapshot.add(F("Loop Rate"), PSTR("%lu/s"), static_cast<unsigned long>(metrics.getLoopRate()));
+    if (telemetry != nullptr) {
+      const auto& stats = telemetry->getStats();
+      snapshot.add(
+        F("Telemetry"), PSTR("%lu frames, %lu samples, %lu bytes, %lu failed"),
+        static_cast<unsigned long>(stats.frames), static_cast<unsigned long>(stats.samples),
+        static_cast<unsigned long>(stats.bytes), static_cast<unsigned long>(stats.failures)
+      );
     }
-  }
-  if (aqOk) {
-    auto co2 = aq->getCO2();
-    if (!isnan(co2)) {
-      co2 += climate->revise->co2;
-      const auto co2Fix = std::max<float>(0, std::min<float>(100000, co2)); // 0~100000
-      if (carbonDioxideState.value.float_value != co2Fix) {
-        carbonDioxideState.value.float_value = co2Fix;
-        if (notify) {
-          homekit_characteristic_notify(&carbonDioxideState, carbonDioxideState.value);
-        }
-      }
+    if (ht != nullptr) {
+      const auto& sensor = metrics.getSensor(METRIC_SENSOR_HT);
+      snapshot.add(
+        F("HT Reads"), PSTR("%lu ok, %lu failed, up %lus"),
+        static_cast<unsigned long>(sensor.success), static_cast<unsigned long>(sensor.failure), metrics.getSensorUptime(METRIC_SENSOR_HT)
+      );
     }
-    auto voc = aq->getTVOC();
-    if (!isnan(voc)) {
-      voc += climate->revise->voc;
-      const auto vocFix = std::max<float>(0, std::min<float>(1000, voc)); // 0~1000
-      if (vocDensityState.value.float_value != vocFix) {
-        vocDensityState.value.float_value = vocFix;
-        if (notify) {
-          homekit_characteristic_notify(&vocDensityState, vocDensityState.value);
-        }
+    if (aq != nullptr) {
+      const auto& sensor = metrics.getSensor(METRIC_SENSOR_AQ);
+      snapshot.add(
+        F("AQ Reads"), PSTR("%lu ok, %lu failed, up %lus"),
+        static_cast<unsigned long>(sensor.success), static_cast<unsigned long>(sensor.failure), metrics.getSensorUptime(METRIC_SENSOR_AQ)
+      );
+    }
+    char notified[128] = {};
+    size_t notifiedLength = 0;
+    for (uint8_t i = 0; i < metrics.size(); i++) {
+      const auto& tracked = metrics.at(i);
+      if (tracked.notified > 0 && notifiedLength < sizeof(notified)) {
+        const auto written = snprintf(
+          notified + notifiedLength, sizeof(notified) - notifiedLength, "%s%s %lu",
+          notifiedLength > 0 ? ", " : "", String(tracked.name).c_str(), static_cast<unsigned long>(tracked.notified)
+        );
+        notifiedLength = written < 0 ? sizeof(notified) : std::min(notifiedLength + written, sizeof(notified));
       }
-      const auto quality = toAirQuality(vocFix);
-      if (airQualityState.value.uint8_value != quality) {
-        airQualityState.value.uint8_value = quality;
-        if (notify) {
-          homekit_characteristic_notify(&airQualityState, airQualityState.value);
-        }
+    }
+    if (notifiedLength > 0) {
+      snapshot.add(F("Notified"), PSTR("%s"), notified);
+    }
+    // busy time per loop() phase, the sleep is intended
+    for (uint8_t i = 0; i < LOOP_PHASE_COUNT; i++) {
+      const auto phase = static_cast<LoopPhase>(i);
+      const auto& stats = loopProfiler.at(phase);
+      if (stats.calls > 0 && phase != LOOP_PHASE_SLEEP) {
+        snapshot.add(
+          F("Loop "), LoopProfiler::name(phase), PSTR("%luus avg, %luus max"),
+          static_cast<unsigned long>(stats.avgMicros()), static_cast<unsigned long>(stats.maxMicros)
+        );
       }
     }
-    console.log()
-      .bracket(F("aq"))
-      .section(F("voc"), String(voc))
-      .section(F("co2"), String(co2));
-  }
-}
-
-void setup(void) {
-  appMain = new AppMain();
-  appMain->setup();
+    if (loopProfiler.getSlowIterations() > 0) {
+      snapshot.add(
+        F("Loop Slow"), PSTR("%lu times, last %lums in %s"),
+        static_cast<unsigned long>(loopProfiler.getSlowIterations()), static_cast<unsigned long>(loopProfiler.getSlowMicros() / 1000),
+        String(LoopProfiler::name(loopProfiler.getSlowPhase())).c_str()
+      );
+    }
+    snapshot.add(F("Paired"), PSTR("%s"), GlobalHelpers::toYesNoName(homekit_is_paired()).c_str());
+    snapshot.add(F("Clients"), PSTR("%d"), arduino_homekit_connected_clients_count());
+  };
 
   // setup web
   appMain->webPortal->onServiceGet = [](std::vector<TextValueModel>& states, std::vector<TextValueModel>& buttons) {
-    // states
-    states.push_back({ .text = F("Service"),     .value = VICTOR_ACCESSORY_SERVICE_NAME });
-    states.push_back({ .text = F("Temperature"), .value = String(temperatureState.value.float_value) + F("°C") });
-    states.push_back({ .text = F("Humidity"),    .value = String(humidityState.value.float_value) + F("%") });
-    states.push_back({ .text = F("CO2 Level"),   .value = String(carbonDioxideState.value.float_value) + F("ppm/㎥") });
-    states.push_back({ .text = F("VOC Density"), .value = String(vocDensityState.value.float_value) + F("ppb/㎥") });
-    states.push_back({ .text = F("Air Quality"), .value = toAirQualityName(airQualityState.value.uint8_value) });
-    states.push_back({ .text = F("Paired"),      .value = GlobalHelpers::toYesNoName(homekit_is_paired()) });
-    states.push_back({ .text = F("Clients"),     .value = String(arduino_homekit_connected_clients_count()) });
+    // states, one copy per row out of the snapshot
+    portalSnapshot.refresh(measure != nullptr ? measure->getRevision() : 0);
+    states.reserve(states.size() + portalSnapshot.size());
+    for (uint8_t i = 0; i < portalSnapshot.size(); i++) {
+      states.push_back({ .text = portalSnapshot.textAt(i), .value = portalSnapshot.valueAt(i) });
+    }
     // buttons
     buttons.push_back({ .text = F("UnPair"),   .value = F("UnPair") }); // UnPair HomeKit
     if (ht != nullptr) {
@@ -205,22 +200,21 @@ void setup(void) {
     if (value == F("UnPair")) {
       homekit_server_reset();
       ESP.restart();
-    } else if (value == F("ht")) {
+    } else if (value == F("ht") && ht != nullptr) {
       ht->reset();
-    } else if (value == F("aq")) {
+    } else if (value == F("aq") && aq != nullptr) {
       aq->reset();
     }
+    portalSnapshot.invalidate();
   };
 
-  // setup homekit server
+  // homekit server info, started from loop() once the sensors are known
   hostName = victorWifi.getHostName();
   serialNumber = String(VICTOR_ACCESSORY_INFORMATION_SERIAL_NUMBER) + "/" + victorWifi.getHostId();
   accessoryName.value.string_value = const_cast<char*>(hostName.c_str());
   accessorySerialNumber.value.string_value = const_cast<char*>(serialNumber.c_str());
-  arduino_homekit_setup(&serverConfig);
 
-  // climate
-  climate = climateStorage.load();
+  // button
   if (climate->buttonPin > -1) {
     button = new ActionButtonInterrupt(climate->buttonPin, climate->buttonTrueValue);
     button->onAction = [](const ButtonAction action) {
@@ -242,59 +236,187 @@ void setup(void) {
     };
   }
 
-  // setup i2c
-  const auto i2cStorage = new I2cStorage("/i2c.json");
-  const auto i2c = i2cStorage->load();
-  if (i2c->enablePin > -1) {
-    const auto enableI2c = new DigitalOutput(i2c->enablePin, i2c->enableTrueValue);
-    enableI2c->setValue(false);
-    delay(200);
-    enableI2c->setValue(true);
-    delay(200);
-    delete enableI2c;
-  }
-  Wire.begin(   // https://zhuanlan.zhihu.com/p/137568249
-    i2c->sdaPin, // Inter-Integrated Circuit - Serial Data (I2C-SDA)
-    i2c->sclPin  // Inter-Integrated Circuit - Serial Clock (I2C-SCL)
-  );
-
-  // setup ht sensor
-  if (climate->htSensor != HT_SENSOR_OFF) {
-    ht = new HTSensor(climate->htSensor, climate->htQuery);
-    if (!ht->begin()) {
-      console.error()
-        .bracket(F("ht"))
-        .section(F("notfound"));
+  // history, boot timeline, i2c health, loop profile, metrics and portal states, streamed in small chunks so no response body is built in heap
+  dataServer = new ESP8266WebServer(VICTOR_DATA_PORT);
+  dataServer->on(F("/history"), HTTP_GET, []() {
+    dataServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    dataServer->send(200, F("text/csv"), HISTORY_CSV_HEADER);
+    char buffer[VICTOR_DATA_CHUNK_SIZE];
+    size_t cursor = 0;
+    size_t length;
+    const auto now = millis();
+    while ((length = climateHistory.writeCsv(cursor, buffer, sizeof(buffer), now)) > 0) {
+      dataServer->sendContent(buffer, length);
     }
-  }
-
-  // setup aq sensor
-  if (climate->aqSensor != AQ_SENSOR_OFF) {
-    aq = new AQSensor(climate->aqSensor, climate->aqQuery);
-    if (!aq->begin(climate->baseline)) {
-      console.error()
-        .bracket(F("aq"))
-        .section(F("notfound"));
+    dataServer->sendContent(""); // end of chunked body
+  });
+  dataServer->on(F("/boot"), HTTP_GET, []() {
+    dataServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    dataServer->send(200, F("text/csv"), BOOT_TIMELINE_CSV_HEADER);
+    char buffer[VICTOR_DATA_CHUNK_SIZE];
+    size_t cursor = 0;
+    size_t length;
+    while ((length = bootTimeline.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+      dataServer->sendContent(buffer, length);
+    }
+    dataServer->sendContent("");
+  });
+  dataServer->on(F("/i2c"), HTTP_GET, []() {
+    dataServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    dataServer->send(200, F("text/csv"), I2C_BUS_CSV_HEADER);
+    char buffer[VICTOR_DATA_CHUNK_SIZE];
+    size_t cursor = 0;
+    size_t length;
+    while ((length = i2cBus.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+      dataServer->sendContent(buffer, length);
+    }
+    dataServer->sendContent("");
+  });
+  dataServer->on(F("/metrics"), HTTP_GET, []() {
+    dataServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    dataServer->send(200, F("text/csv"), METRICS_CSV_HEADER);
+    char buffer[VICTOR_DATA_CHUNK_SIZE];
+    size_t cursor = 0;
+    size_t length;
+    while ((length = metrics.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+      dataServer->sendContent(buffer, length);
+    }
+    dataServer->sendContent("");
+  });
+  dataServer->on(F("/loop"), HTTP_GET, []() {
+    dataServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    dataServer->send(200, F("text/csv"), LOOP_PROFILER_CSV_HEADER);
+    char buffer[VICTOR_DATA_CHUNK_SIZE];
+    size_t cursor = 0;
+    size_t length;
+    while ((length = loopProfiler.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+      dataServer->sendContent(buffer, length);
     }
+    dataServer->sendContent("");
+  });
+  dataServer->on(F("/state"), HTTP_GET, []() {
+    portalSnapshot.refresh(measure != nullptr ? measure->getRevision() : 0);
+    dataServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    dataServer->send(200, F("text/csv"), PORTAL_SNAPSHOT_CSV_HEADER);
+    char buffer[VICTOR_DATA_CHUNK_SIZE];
+    size_t cursor = 0;
+    size_t length;
+    while ((length = portalSnapshot.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+      dataServer->sendContent(buffer, length);
+    }
+    dataServer->sendContent("");
+  });
+  dataServer->begin();
+
+  // json edited since the image was generated and the new image written, boot again on it
+  if (!configImage.verify()) {
+    ESP.restart();
   }
 
   // done
+  bootTimeline.mark(F("setup done"));
   console.log()
     .bracket(F("setup"))
     .section(F("complete"));
 }
 
+void loopBootTimeline() {
+  if (bootWifiMicros == 0 && WiFi.status() == WL_CONNECTED) {
+    bootWifiMicros = micros();
+    bootTimeline.mark(F("wifi"));
+  }
+  if (bootReadingMicros == 0 && (temperatureActiveState.value.bool_value || airQualityActiveState.value.bool_value)) {
+    bootReadingMicros = micros();
+    bootTimeline.mark(F("first reading"));
+    bootTimeline.print();
+  }
+}
+
+// once the sensors are created the accessory layout is known, their begin and baseline
+// finish in the background
+void startHomekit() {
+  // what is configured goes into the accessory database, answered at boot or not:
+  // a sensor that did not answer is probed again and shows StatusActive off until it does
+  ht = sensorRegistry.getHT();
+  aq = sensorRegistry.getAQ();
+  const uint8_t layout = (ht != nullptr ? ACCESSORY_LAYOUT_HT : 0) | (aq != nullptr ? ACCESSORY_LAYOUT_AQ : 0);
+  accessoryBuild(ht != nullptr, aq != nullptr, accessoryLayout.apply(layout));
+  if (accessoryLayout.isChanged()) {
+    console.log()
+      .bracket(F("accessory"))
+      .section(F("layout"), String(layout))
+      .section(F("config number"), String(accessoryLayout.getConfigNumber()));
+  }
+  arduino_homekit_setup(&serverConfig);
+  homekitStarted = true;
+  bootTimeline.mark(F("homekit"));
+}
+
 void loop(void) {
-  arduino_homekit_loop();
+  metrics.loop();
+  loopProfiler.begin();
+  if (homekitStarted) {
+    arduino_homekit_loop();
+  }
+  loopProfiler.mark(LOOP_PHASE_HOMEKIT);
   // loop sensor
-  const auto isPaired = arduino_homekit_get_running_server()->paired;
+  const auto isPaired = homekitStarted && arduino_homekit_get_running_server()->paired;
   const auto connective = victorWifi.isLightSleepMode() && isPaired;
-  if (ht != nullptr) { measureHT(connective); }
-  if (aq != nullptr) { measureAQ(connective); }
-  // sleep
-  appMain->loop(connective);
+  unsigned long idleMillis;
+  if (sensorBoot->isDone()) {
+    idleMillis = measure->loop(connective);
+  } else {
+    idleMillis = sensorBoot->loop();
+    if (!homekitStarted && sensorBoot->isCreated()) {
+      startHomekit();
+    }
+    if (sensorBoot->isDone()) {
+      bootTimeline.mark(F("sensors ready"));
+      measure = new ClimateMeasure(climate, ht, aq);
+      if (climate->telemetry.port > 0) {
+        telemetry = new TelemetryExporter(climate->telemetry);
+        measure->getBus().subscribe(telemetry);
+      }
+      if (!measure->begin()) {
+        console.error()
+          .bracket(F("measure"))
+          .section(F("jobs"), F("not all scheduled"));
+      }
+      portalSnapshot.invalidate(); // sensor rows show up
+      idleMillis = 0;
+    }
+  }
+  loopProfiler.mark(LOOP_PHASE_SENSOR);
+  // sleep until the next sensor deadline, bounded so homekit keeps being served
+  appMain->loop(false);
+  loopProfiler.mark(LOOP_PHASE_PORTAL);
+  dataServer->handleClient();
+  // a frame goes out once its batch is full or old enough
+  if (telemetry != nullptr) {
+    telemetry->loop();
+  }
+  loopProfiler.mark(LOOP_PHASE_DATA);
+  // log lines of the measures wait for a pass with nothing due
+  if (idleMillis > 0) {
+    eventLog.flush();
+  }
+  loopProfiler.mark(LOOP_PHASE_LOG);
+  if (connective && idleMillis > 0) {
+    delay(std::min<unsigned long>(idleMillis, VICTOR_LOOP_SLEEP_MAX_MILLIS));
+  }
+  loopProfiler.mark(LOOP_PHASE_SLEEP);
   // button
   if (button != nullptr) {
     button->loop();
   }
+  loopProfiler.mark(LOOP_PHASE_BUTTON);
+  // one event message per client for everything changed in this pass
+  if (measure != nullptr) {
+    measure->flushNotify();
+  }
+  loopProfiler.mark(LOOP_PHASE_NOTIFY);
+  if (bootReadingMicros == 0) {
+    loopBootTimeline();
+  }
+  loopProfiler.end();
 }
@@ -0,0 +1,2 @@
+// src is not built for tests (test_build_src = no), the accessory database is compiled in from here
+#include "../../src/accessory.c"
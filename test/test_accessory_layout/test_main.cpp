@@ -0,0 +1,136 @@
+#include <unity.h>
+#include <homekit/homekit.h>
+#include "AccessoryLayout.h"
+
+using namespace Victor::Components;
+
+#define ACCESSORY_LAYOUT_PATH "/accessory.bin"
+
+// src/accessory.c, built from accessory.c next to this file
+extern "C" homekit_accessory_t* accessories[];
+extern "C" homekit_server_config_t serverConfig;
+extern "C" homekit_accessory_t bridgeAccessory;
+extern "C" homekit_accessory_t temperatureAccessory;
+extern "C" homekit_accessory_t humidityAccessory;
+extern "C" homekit_accessory_t airQualityAccessory;
+extern "C" void accessoryBuild(bool hasHT, bool hasAQ, uint16_t configNumber);
+
+// a boot reads the stored layout again
+static uint16_t boot(const uint8_t layout) {
+  AccessoryLayout accessoryLayout(ACCESSORY_LAYOUT_PATH);
+  return accessoryLayout.apply(layout);
+}
+
+static void writeRecord(const uint8_t layout, const uint16_t configNumber) {
+  AccessoryLayoutRecord record;
+  record.layout = layout;
+  record.configNumber = configNumber;
+  record.crc = crc16(reinterpret_cast<const uint8_t*>(&record), offsetof(AccessoryLayoutRecord, crc));
+  auto file = LittleFS.open(ACCESSORY_LAYOUT_PATH, "w");
+  file.write(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+  file.close();
+}
+
+void setUp(void) {
+  LittleFS.begin();
+  LittleFS.remove(ACCESSORY_LAYOUT_PATH);
+}
+
+void tearDown(void) {
+  LittleFS.remove(ACCESSORY_LAYOUT_PATH);
+}
+
+void test_build_lists_what_applies(void) {
+  accessoryBuild(true, true, 1);
+  TEST_ASSERT_EQUAL_PTR(&bridgeAccessory, accessories[0]);
+  TEST_ASSERT_EQUAL_PTR(&temperatureAccessory, accessories[1]);
+  TEST_ASSERT_EQUAL_PTR(&humidityAccessory, accessories[2]);
+  TEST_ASSERT_EQUAL_PTR(&airQualityAccessory, accessories[3]);
+  TEST_ASSERT_NULL(accessories[4]);
+  TEST_ASSERT_EQUAL(1, serverConfig.config_number);
+  TEST_ASSERT_EQUAL_PTR(accessories, serverConfig.accessories);
+
+  accessoryBuild(false, true, 7);
+  TEST_ASSERT_EQUAL_PTR(&bridgeAccessory, accessories[0]);
+  TEST_ASSERT_EQUAL_PTR(&airQualityAccessory, accessories[1]);
+  TEST_ASSERT_NULL(accessories[2]);
+  TEST_ASSERT_EQUAL(7, serverConfig.config_number);
+
+  accessoryBuild(true, false, 8);
+  TEST_ASSERT_EQUAL_PTR(&humidityAccessory, accessories[2]);
+  TEST_ASSERT_NULL(accessories[3]);
+
+  accessoryBuild(false, false, 9);
+  TEST_ASSERT_EQUAL_PTR(&bridgeAccessory, accessories[0]);
+  TEST_ASSERT_NULL(accessories[1]);
+}
+
+void test_ids_stay_fixed(void) {
+  // controllers key their tiles by accessory id, whichever accessories are left out
+  accessoryBuild(false, true, 2);
+  TEST_ASSERT_EQUAL(1, accessories[0]->id);
+  TEST_ASSERT_EQUAL(4, accessories[1]->id);
+  TEST_ASSERT_EQUAL(2, temperatureAccessory.id);
+  TEST_ASSERT_EQUAL(3, humidityAccessory.id);
+}
+
+void test_first_boot_full_keeps_1(void) {
+  // existing pairings were made against the full database under 1
+  TEST_ASSERT_EQUAL(1, boot(ACCESSORY_LAYOUT_FULL));
+  TEST_ASSERT_FALSE(LittleFS.exists(ACCESSORY_LAYOUT_PATH));
+  TEST_ASSERT_EQUAL(1, boot(ACCESSORY_LAYOUT_FULL));
+}
+
+void test_first_boot_reduced_moves_on(void) {
+  AccessoryLayout accessoryLayout(ACCESSORY_LAYOUT_PATH);
+  TEST_ASSERT_EQUAL(2, accessoryLayout.apply(ACCESSORY_LAYOUT_HT));
+  TEST_ASSERT_TRUE(accessoryLayout.isChanged());
+  TEST_ASSERT_EQUAL(2, accessoryLayout.getConfigNumber());
+}
+
+void test_number_only_moves_forward(void) {
+  TEST_ASSERT_EQUAL(2, boot(ACCESSORY_LAYOUT_HT));
+  TEST_ASSERT_EQUAL(2, boot(ACCESSORY_LAYOUT_HT));
+  // back to a layout seen before still takes a new number, controllers cached the reduced one
+  TEST_ASSERT_EQUAL(3, boot(ACCESSORY_LAYOUT_FULL));
+  TEST_ASSERT_EQUAL(4, boot(ACCESSORY_LAYOUT_HT));
+  TEST_ASSERT_EQUAL(5, boot(0));
+  TEST_ASSERT_EQUAL(5, boot(0));
+  TEST_ASSERT_EQUAL(6, boot(ACCESSORY_LAYOUT_AQ));
+}
+
+void test_unchanged_layout_is_not_written(void) {
+  writeRecord(ACCESSORY_LAYOUT_AQ, 42);
+  AccessoryLayout accessoryLayout(ACCESSORY_LAYOUT_PATH);
+  TEST_ASSERT_EQUAL(42, accessoryLayout.apply(ACCESSORY_LAYOUT_AQ));
+  TEST_ASSERT_FALSE(accessoryLayout.isChanged());
+}
+
+void test_wraps_to_1(void) {
+  writeRecord(ACCESSORY_LAYOUT_FULL, ACCESSORY_CONFIG_NUMBER_MAX);
+  TEST_ASSERT_EQUAL(1, boot(ACCESSORY_LAYOUT_HT));
+  TEST_ASSERT_EQUAL(2, boot(ACCESSORY_LAYOUT_FULL));
+}
+
+void test_corrupt_record_reads_as_full(void) {
+  writeRecord(ACCESSORY_LAYOUT_HT, 9);
+  auto file = LittleFS.open(ACCESSORY_LAYOUT_PATH, "r+");
+  file.seek(2);
+  file.write(static_cast<uint8_t>(0xFF));
+  file.close();
+  TEST_ASSERT_EQUAL(1, boot(ACCESSORY_LAYOUT_FULL));
+  TEST_ASSERT_EQUAL(2, boot(ACCESSORY_LAYOUT_HT));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_build_lists_what_applies);
+  RUN_TEST(test_ids_stay_fixed);
+  RUN_TEST(test_first_boot_full_keeps_1);
+  RUN_TEST(test_first_boot_reduced_moves_on);
+  RUN_TEST(test_number_only_moves_forward);
+  RUN_TEST(test_unchanged_layout_is_not_written);
+  RUN_TEST(test_wraps_to_1);
+  RUN_TEST(test_corrupt_record_reads_as_full);
+  return UNITY_END();
+}
@@ -0,0 +1,121 @@
+#include <unity.h>
+#include <FakeClimate.h>
+#include "BaselineLog.h"
+#include "AQSensor.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+#define TEST_LOG_PATH "/baseline.log"
+
+void setUp(void) {
+  VirtualClock::reset();
+  fakeClimate = FakeClimate();
+  LittleFS.begin();
+  LittleFS.remove(TEST_LOG_PATH);
+}
+
+void tearDown(void) {
+  LittleFS.remove(TEST_LOG_PATH);
+}
+
+// overwrite the bytes at offset, the way a half written flash page looks
+void corrupt(const size_t offset, const uint8_t* bytes, const size_t size) {
+  auto file = LittleFS.open(TEST_LOG_PATH, "r+");
+  file.seek(offset, SeekSet);
+  file.write(bytes, size);
+  file.close();
+}
+
+void test_empty_log(void) {
+  BaselineLog log(TEST_LOG_PATH);
+  uint16_t co2 = 0, voc = 0;
+  TEST_ASSERT_FALSE(log.read(co2, voc));
+  TEST_ASSERT_EQUAL(0, log.count());
+}
+
+void test_append_and_read_back(void) {
+  BaselineLog log(TEST_LOG_PATH);
+  TEST_ASSERT_TRUE(log.append(0x8973, 0x8aae));
+  TEST_ASSERT_TRUE(log.append(0x8980, 0x8ab0));
+  TEST_ASSERT_EQUAL(2, log.count());
+  uint16_t co2 = 0, voc = 0;
+  TEST_ASSERT_TRUE(log.read(co2, voc));
+  TEST_ASSERT_EQUAL_UINT16(0x8980, co2);
+  TEST_ASSERT_EQUAL_UINT16(0x8ab0, voc);
+}
+
+void test_compacts_when_full(void) {
+  BaselineLog log(TEST_LOG_PATH);
+  for (uint16_t i = 0; i < BASELINE_LOG_CAPACITY; i++) {
+    TEST_ASSERT_TRUE(log.append(1000 + i, 2000 + i));
+  }
+  TEST_ASSERT_EQUAL(BASELINE_LOG_CAPACITY, log.count());
+  // the next append leaves just itself
+  TEST_ASSERT_TRUE(log.append(3000, 4000));
+  TEST_ASSERT_EQUAL(1, log.count());
+  TEST_ASSERT_FALSE(LittleFS.exists(TEST_LOG_PATH ".tmp"));
+  uint16_t co2 = 0, voc = 0;
+  TEST_ASSERT_TRUE(log.read(co2, voc));
+  TEST_ASSERT_EQUAL_UINT16(3000, co2);
+  TEST_ASSERT_EQUAL_UINT16(4000, voc);
+  TEST_ASSERT_TRUE(log.append(3001, 4001));
+  TEST_ASSERT_EQUAL(2, log.count());
+}
+
+void test_crc_bad_tail_falls_back(void) {
+  BaselineLog log(TEST_LOG_PATH);
+  TEST_ASSERT_TRUE(log.append(1000, 2000));
+  TEST_ASSERT_TRUE(log.append(1001, 2001));
+  // flip a value byte of the latest record, its crc no longer matches
+  const uint8_t flipped = 0xFF;
+  corrupt(sizeof(BaselineRecord) + offsetof(BaselineRecord, co2), &flipped, 1);
+  uint16_t co2 = 0, voc = 0;
+  TEST_ASSERT_TRUE(log.read(co2, voc));
+  TEST_ASSERT_EQUAL_UINT16(1000, co2);
+  TEST_ASSERT_EQUAL_UINT16(2000, voc);
+}
+
+void test_torn_tail_recovers(void) {
+  BaselineLog log(TEST_LOG_PATH);
+  TEST_ASSERT_TRUE(log.append(1000, 2000));
+  // a power cut in the middle of the next record
+  auto file = LittleFS.open(TEST_LOG_PATH, "a");
+  const uint8_t torn[3] = { BASELINE_RECORD_MAGIC, 0, 0x12 };
+  file.write(torn, sizeof(torn));
+  file.close();
+  uint16_t co2 = 0, voc = 0;
+  TEST_ASSERT_TRUE(log.read(co2, voc));
+  TEST_ASSERT_EQUAL_UINT16(1000, co2);
+  // the misaligned log gets compacted by the next append instead of growing torn
+  TEST_ASSERT_TRUE(log.append(1002, 2002));
+  TEST_ASSERT_EQUAL(1, log.count());
+  TEST_ASSERT_TRUE(log.read(co2, voc));
+  TEST_ASSERT_EQUAL_UINT16(1002, co2);
+  TEST_ASSERT_EQUAL_UINT16(2002, voc);
+}
+
+void test_load_gate(void) {
+  TEST_ASSERT_TRUE(baselineLog.append(0x8980, 0x8ab0));
+  AQSensor aq(AQ_SENSOR_SGP30);
+  TEST_ASSERT_TRUE(aq.begin());
+  AQBaseline baseline;
+  baseline.load = false;
+  baseline.co2 = 0x8973;
+  baseline.voc = 0x8aae;
+  // switched off, not even the log is applied
+  TEST_ASSERT_FALSE(aq.loadBaseline(baseline));
+  baseline.load = true;
+  TEST_ASSERT_TRUE(aq.loadBaseline(baseline));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_log);
+  RUN_TEST(test_append_and_read_back);
+  RUN_TEST(test_compacts_when_full);
+  RUN_TEST(test_crc_bad_tail_falls_back);
+  RUN_TEST(test_torn_tail_recovers);
+  RUN_TEST(test_load_gate);
+  return UNITY_END();
+}
@@ -0,0 +1,111 @@
+#include <unity.h>
+#include "ClimateHistory.h"
+
+using namespace Victor::Components;
+
+ClimateHistory* history = nullptr;
+
+HistoryReading readingOf(const float temperature, const float co2) {
+  HistoryReading reading;
+  reading.hasHT = true;
+  reading.temperature = temperature;
+  reading.humidity = 50;
+  reading.hasAQ = true;
+  reading.co2 = co2;
+  reading.voc = 100;
+  return reading;
+}
+
+void setUp(void) {
+  history = new ClimateHistory();
+}
+
+void tearDown(void) {
+  delete history;
+}
+
+void test_ring_wraps_around(void) {
+  const auto extra = 5;
+  for (auto i = 0; i < HISTORY_CAPACITY + extra; i++) {
+    history->record(readingOf(i / 100.0f, 400), i * 60000UL);
+  }
+  TEST_ASSERT_EQUAL(HISTORY_CAPACITY, history->size());
+  // the oldest samples were overwritten, order stays by age
+  TEST_ASSERT_EQUAL(extra, history->at(0).minute);
+  TEST_ASSERT_EQUAL(extra, history->at(0).temperature);
+  TEST_ASSERT_EQUAL(HISTORY_CAPACITY + extra - 1, history->at(HISTORY_CAPACITY - 1).minute);
+  for (size_t i = 1; i < history->size(); i++) {
+    TEST_ASSERT_EQUAL(history->at(i - 1).minute + 1, history->at(i).minute);
+  }
+  history->clear();
+  TEST_ASSERT_EQUAL(0, history->size());
+}
+
+void test_pack_quantizes_and_clamps(void) {
+  HistoryReading reading;
+  reading.hasHT = true;
+  reading.temperature = 23.456f;
+  reading.humidity = 45.3f;
+  reading.hasAQ = true;
+  reading.co2 = 1234;
+  reading.voc = 567;
+  auto unpacked = ClimateHistory::unpack(ClimateHistory::pack(reading, 0));
+  // 0.01 °C, 0.5 %RH, 4 ppm and 1 ppb steps
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 23.46f, unpacked.temperature);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 45.5f, unpacked.humidity);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1236, unpacked.co2);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 567, unpacked.voc);
+  // out of range values clamp below the sentinels
+  reading.temperature = 1000;
+  reading.humidity = 120;
+  reading.co2 = 100000;
+  reading.voc = 100000;
+  unpacked = ClimateHistory::unpack(ClimateHistory::pack(reading, 0));
+  TEST_ASSERT_TRUE(unpacked.hasHT);
+  TEST_ASSERT_TRUE(unpacked.hasAQ);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 300, unpacked.temperature);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 100, unpacked.humidity);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, (HISTORY_NO_GAS - 1) * 4, unpacked.co2);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, HISTORY_NO_GAS - 1, unpacked.voc);
+  // a channel without reading comes back empty
+  HistoryReading empty;
+  unpacked = ClimateHistory::unpack(ClimateHistory::pack(empty, 0));
+  TEST_ASSERT_FALSE(unpacked.hasHT);
+  TEST_ASSERT_FALSE(unpacked.hasAQ);
+}
+
+void test_csv_export_oldest_first_in_chunks(void) {
+  HistoryReading htOnly;
+  htOnly.hasHT = true;
+  htOnly.temperature = 21.5f;
+  htOnly.humidity = 40;
+  history->record(htOnly, 0);
+  history->record(readingOf(22, 800), 2 * 60000UL);
+  HistoryReading empty;
+  history->record(empty, 4 * 60000UL);
+  const auto now = 10 * 60000UL;
+  // the first two lines do not fit one chunk, the cursor resumes where the last chunk stopped
+  char buffer[32];
+  char csv[256] = {};
+  size_t cursor = 0;
+  size_t chunks = 0;
+  while (true) {
+    const auto length = history->writeCsv(cursor, buffer, sizeof(buffer), now);
+    if (length == 0) {
+      break;
+    }
+    strncat(csv, buffer, length);
+    chunks++;
+  }
+  TEST_ASSERT_EQUAL(3, cursor);
+  TEST_ASSERT_EQUAL(2, chunks);
+  TEST_ASSERT_EQUAL_STRING("10,21.50,40.0,,\n8,22.00,50.0,800,100\n6,,,,\n", csv);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_ring_wraps_around);
+  RUN_TEST(test_pack_quantizes_and_clamps);
+  RUN_TEST(test_csv_export_oldest_first_in_chunks);
+  return UNITY_END();
+}
@@ -0,0 +1,122 @@
+#include <math.h>
+#include <unity.h>
+#include "ClimateMath.h"
+
+using namespace Victor::Components;
+
+// same sweep runs on the host (ns) and on the device (cpu cycles)
+#ifdef VICTOR_NATIVE
+#include <chrono>
+#define BENCH_UNIT "ns"
+static uint32_t benchNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#else
+#define BENCH_UNIT "cycles"
+static uint32_t benchNow() {
+  return ESP.getCycleCount();
+}
+#endif
+
+#define BENCH_ROUNDS 2000
+
+// the double implementation AQSensor used before, kept as the reference
+static double referenceAbsoluteHumidity(float relativeHumidity, float temperature) {
+  double eSat = 6.11 * pow(10.0, (7.5 * temperature / (237.7 + temperature)));
+  double vaporPressure = (relativeHumidity * eSat) / 100; // millibars
+  double absHumidity = 1000 * vaporPressure * 100 / ((temperature + 273) * 461.5); // Ideal gas law with unit conversions
+  return absHumidity;
+}
+
+static uint16_t referenceFixedPoint(double number) {
+  int power = 1 << 8;
+  double number2 = number * power;
+  uint16_t value = floor(number2 + 0.5);
+  return value;
+}
+
+volatile uint32_t sink = 0;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_absolute_humidity_matches_double(void) {
+  uint32_t maxError = 0, samples = 0, exact = 0;
+  int32_t worstCelsius = 0, worstHumidity = 0;
+  for (int32_t centiCelsius = -2000; centiCelsius <= 6000; centiCelsius += 10) {
+    for (int32_t centiHumidity = 0; centiHumidity <= 10000; centiHumidity += 25) {
+      const auto expected = referenceFixedPoint(referenceAbsoluteHumidity(centiHumidity / 100.0f, centiCelsius / 100.0f));
+      const auto actual = ClimateMath::absoluteHumidity(centiCelsius, centiHumidity);
+      const auto error = static_cast<uint32_t>(abs(static_cast<int32_t>(actual) - expected));
+      if (error > maxError) {
+        maxError = error;
+        worstCelsius = centiCelsius;
+        worstHumidity = centiHumidity;
+      }
+      exact += error == 0 ? 1 : 0;
+      samples++;
+    }
+  }
+  printf(
+    "\nabsolute humidity over %lu samples: %lu exact, max error %lu lsb (1/256 g/m3) at %ld centi C %ld centi %%RH\n",
+    static_cast<unsigned long>(samples), static_cast<unsigned long>(exact), static_cast<unsigned long>(maxError),
+    static_cast<long>(worstCelsius), static_cast<long>(worstHumidity)
+  );
+  TEST_ASSERT_LESS_OR_EQUAL(1, maxError);
+}
+
+void test_absolute_humidity_edges(void) {
+  TEST_ASSERT_EQUAL(0, ClimateMath::absoluteHumidity(2500, 0));
+  // clamped to the table range
+  TEST_ASSERT_EQUAL(ClimateMath::absoluteHumidity(-2000, 5000), ClimateMath::absoluteHumidity(-4000, 5000));
+  TEST_ASSERT_EQUAL(ClimateMath::absoluteHumidity(6000, 10000), ClimateMath::absoluteHumidity(8500, 12000));
+  // ~129 g/m3 at the top, well inside the 8.8 range
+  TEST_ASSERT_UINT_WITHIN(1, referenceFixedPoint(referenceAbsoluteHumidity(100, 60)), ClimateMath::absoluteHumidity(6000, 10000));
+  TEST_ASSERT_EQUAL(11719, ClimateMath::toMilligrams(3000));
+}
+
+void test_integer_revise_and_clamp(void) {
+  TEST_ASSERT_EQUAL(-600, ClimateMath::toCenti(-6));
+  TEST_ASSERT_EQUAL(10, ClimateMath::toCenti(0.1));
+  TEST_ASSERT_EQUAL(0, ClimateMath::clamp(-1, 0, 10000));
+  TEST_ASSERT_EQUAL(10000, ClimateMath::clamp(10001, 0, 10000));
+  TEST_ASSERT_EQUAL(2340, ClimateMath::roundTo(2345, 10));
+  TEST_ASSERT_EQUAL(2360, ClimateMath::roundTo(2355, 10));
+  TEST_ASSERT_EQUAL(2350, ClimateMath::roundTo(2346, 10));
+  TEST_ASSERT_EQUAL(-2340, ClimateMath::roundTo(-2345, 10));
+  TEST_ASSERT_EQUAL(4700, ClimateMath::roundTo(4651, 100));
+  TEST_ASSERT_EQUAL_STRING("23.05", ClimateMath::toString(2305).c_str());
+  TEST_ASSERT_EQUAL_STRING("-0.50", ClimateMath::toString(-50).c_str());
+}
+
+void test_absolute_humidity_benchmark(void) {
+  uint32_t begin = benchNow();
+  for (auto i = 0; i < BENCH_ROUNDS; i++) {
+    const auto celsius = (i % 80 - 20) + 0.37f;
+    const auto humidity = (i % 100) + 0.5f;
+    sink += referenceFixedPoint(referenceAbsoluteHumidity(humidity, celsius));
+  }
+  const auto doubleCost = benchNow() - begin;
+  begin = benchNow();
+  for (auto i = 0; i < BENCH_ROUNDS; i++) {
+    const auto centiCelsius = (i % 80 - 20) * 100 + 37;
+    const auto centiHumidity = (i % 100) * 100 + 50;
+    sink += ClimateMath::absoluteHumidity(centiCelsius, centiHumidity);
+  }
+  const auto fixedCost = benchNow() - begin;
+  printf(
+    "absolute humidity per call: double %.1f " BENCH_UNIT ", fixed-point %.1f " BENCH_UNIT "\n",
+    static_cast<float>(doubleCost) / BENCH_ROUNDS, static_cast<float>(fixedCost) / BENCH_ROUNDS
+  );
+  TEST_ASSERT_LESS_THAN(doubleCost, fixedCost);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_absolute_humidity_matches_double);
+  RUN_TEST(test_absolute_humidity_edges);
+  RUN_TEST(test_integer_revise_and_clamp);
+  RUN_TEST(test_absolute_humidity_benchmark);
+  return UNITY_END();
+}
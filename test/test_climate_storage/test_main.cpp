@@ -0,0 +1,147 @@
+#include <new>
+#include <stdlib.h>
+#include <unity.h>
+#include "ClimateStorage.h"
+
+using namespace Victor::Components;
+
+// heap traffic through operator new, which is what the old per-section `new` paid
+static size_t allocations = 0;
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+  allocations++;
+  allocatedBytes += size;
+  if (void* ptr = malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept {
+  free(ptr);
+}
+
+// climate.json as edited on the device, shadows the data dir copy
+static void writeClimate(const char* json) {
+  auto file = LittleFS.open("/climate.json", "w");
+  file.write(reinterpret_cast<const uint8_t*>(json), strlen(json));
+  file.close();
+}
+
+void setUp(void) {
+  LittleFS.begin();
+  climateStorage.invalidate();
+  allocations = 0;
+  allocatedBytes = 0;
+}
+
+void tearDown(void) {
+  LittleFS.remove("/climate.json"); // back to the data dir copy
+}
+
+void test_load_parses_shipped_config(void) {
+  const auto& setting = climateStorage.load();
+  TEST_ASSERT_EQUAL(HT_SENSOR_SHT30, setting.htSensor);
+  TEST_ASSERT_EQUAL(AQ_SENSOR_SGP30, setting.aqSensor);
+  TEST_ASSERT_EQUAL_UINT8(10, setting.htQuery.loopSeconds);
+  TEST_ASSERT_EQUAL_UINT8(5, setting.aqQuery.loopSeconds);
+  TEST_ASSERT_EQUAL_FLOAT(-6, setting.revise.temperature);
+  TEST_ASSERT_EQUAL_UINT16(36897, setting.baseline.co2);
+  TEST_ASSERT_EQUAL_UINT16(30, setting.notify.minSeconds);
+}
+
+void test_load_is_cached_and_allocation_free(void) {
+  const auto& first = climateStorage.load();
+  const auto firstAllocations = allocations;
+  const auto firstBytes = allocatedBytes;
+  for (auto i = 0; i < 100; i++) {
+    const auto& again = climateStorage.load();
+    TEST_ASSERT_TRUE(&first == &again);
+  }
+  printf("\nfirst load: %zu allocations, %zu bytes; cached loads: %zu allocations\n", firstAllocations, firstBytes, allocations - firstAllocations);
+  printf("load heap bytes (ESP.getFreeHeap delta): %d\n", climateStorage.getLoadHeapBytes());
+  // the first load pays host fs path handling and the parse document, freed again
+  TEST_ASSERT_EQUAL(firstAllocations, allocations);
+}
+
+void test_out_of_range_values_are_clamped(void) {
+  writeClimate(
+    "{\"hts\":9,\"aqs\":5,\"button\":[4,7],"
+    "\"notify\":{\"t\":0.01,\"h\":0,\"co2\":0,\"voc\":0,\"min\":600,\"max\":30},"
+    "\"comp\":{\"ah\":400},"
+    "\"filter\":{\"os\":99,\"t\":[4,99],\"h\":[0,0]},"
+    "\"fusion\":{\"mode\":9},\"sht30\":{\"rate\":9,\"rep\":9},"
+    "\"telemetry\":{\"batch\":200,\"flush\":0}}"
+  );
+  const auto& setting = climateStorage.load();
+  // unknown sensor types are switched off rather than guessed
+  TEST_ASSERT_EQUAL(HT_SENSOR_OFF, setting.htSensor);
+  TEST_ASSERT_EQUAL(AQ_SENSOR_OFF, setting.aqSensor);
+  TEST_ASSERT_EQUAL(HIGH, setting.buttonTrueValue);
+  // deadbands no finer than the homekit steps, max interval not under min
+  TEST_ASSERT_EQUAL_FLOAT(0.1f, setting.notify.temperature);
+  TEST_ASSERT_EQUAL_FLOAT(1, setting.notify.humidity);
+  TEST_ASSERT_EQUAL_FLOAT(1, setting.notify.co2);
+  TEST_ASSERT_EQUAL_FLOAT(1, setting.notify.voc);
+  TEST_ASSERT_EQUAL(600, setting.notify.maxSeconds);
+  TEST_ASSERT_EQUAL_FLOAT(255, setting.compensation.absoluteHumidity);
+  // filters fit the compile time state, medians odd
+  TEST_ASSERT_EQUAL(FILTER_OVERSAMPLE_MAX, setting.filter.oversample);
+  TEST_ASSERT_EQUAL(5, setting.filter.temperature.median);
+  TEST_ASSERT_EQUAL(FILTER_EMA_SHIFT_MAX, setting.filter.temperature.emaShift);
+  TEST_ASSERT_EQUAL(1, setting.filter.humidity.median);
+  TEST_ASSERT_EQUAL(FUSION_MEAN, setting.fusion.mode);
+  TEST_ASSERT_EQUAL(HT_RATE_SINGLE_SHOT, setting.sht30.rate);
+  TEST_ASSERT_EQUAL(HT_REPEATABILITY_HIGH, setting.sht30.repeatability);
+  TEST_ASSERT_EQUAL(TELEMETRY_BATCH_MAX, setting.telemetry.batch);
+  TEST_ASSERT_EQUAL(1, setting.telemetry.flushSeconds);
+}
+
+void test_missing_fields_fall_back(void) {
+  writeClimate("{\"hts\":2,\"ht\":{\"loop\":10}}");
+  const auto& setting = climateStorage.load();
+  const NotifyConfig notifyDefault;
+  const TelemetryConfig telemetryDefault;
+  TEST_ASSERT_EQUAL(HT_SENSOR_SHT30, setting.htSensor);
+  TEST_ASSERT_EQUAL_UINT8(10, setting.htQuery.loopSeconds);
+  // a sensor or query left out is off
+  TEST_ASSERT_EQUAL(AQ_SENSOR_OFF, setting.aqSensor);
+  TEST_ASSERT_EQUAL_UINT8(0, setting.aqQuery.loopSeconds);
+  TEST_ASSERT_FALSE(setting.baseline.load);
+  TEST_ASSERT_FALSE(setting.fusion.scan);
+  // sections added later keep their defaults for files written before them
+  TEST_ASSERT_EQUAL_FLOAT(notifyDefault.temperature, setting.notify.temperature);
+  TEST_ASSERT_EQUAL_FLOAT(notifyDefault.co2, setting.notify.co2);
+  TEST_ASSERT_EQUAL_FLOAT(0.1f, setting.compensation.absoluteHumidity);
+  TEST_ASSERT_EQUAL(1, setting.filter.oversample);
+  TEST_ASSERT_EQUAL(1, setting.filter.temperature.median);
+  TEST_ASSERT_EQUAL(1, setting.fusion.weights[2]);
+  TEST_ASSERT_EQUAL(HT_REPEATABILITY_HIGH, setting.sht30.repeatability);
+  TEST_ASSERT_EQUAL(telemetryDefault.batch, setting.telemetry.batch);
+  TEST_ASSERT_EQUAL(telemetryDefault.flushSeconds, setting.telemetry.flushSeconds);
+  TEST_ASSERT_EQUAL(0, setting.telemetry.port);
+}
+
+void test_unparsable_file_keeps_defaults(void) {
+  writeClimate("{\"hts\":2,");
+  const auto& setting = climateStorage.load();
+  const ClimateSetting defaults;
+  TEST_ASSERT_EQUAL(defaults.htSensor, setting.htSensor);
+  TEST_ASSERT_EQUAL(defaults.aqSensor, setting.aqSensor);
+  TEST_ASSERT_EQUAL(defaults.telemetry.batch, setting.telemetry.batch);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_load_parses_shipped_config);
+  RUN_TEST(test_load_is_cached_and_allocation_free);
+  RUN_TEST(test_out_of_range_values_are_clamped);
+  RUN_TEST(test_missing_fields_fall_back);
+  RUN_TEST(test_unparsable_file_keeps_defaults);
+  return UNITY_END();
+}
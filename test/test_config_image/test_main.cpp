@@ -0,0 +1,232 @@
+#include <chrono>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unity.h>
+#include "ConfigImage.h"
+
+using namespace Victor::Components;
+
+#define CONFIG_IMAGE_PATH "/config.bin"
+#define BOOT_ROUNDS 200
+
+static std::vector<uint8_t> readImage() {
+  std::vector<uint8_t> bytes;
+  auto file = LittleFS.open(CONFIG_IMAGE_PATH, "r");
+  int c;
+  while ((c = file.read()) >= 0) {
+    bytes.push_back(c);
+  }
+  file.close();
+  return bytes;
+}
+
+static void writeImage(const std::vector<uint8_t>& bytes) {
+  auto file = LittleFS.open(CONFIG_IMAGE_PATH, "w");
+  file.write(bytes.data(), bytes.size());
+  file.close();
+}
+
+static std::string readFile(const char* path) {
+  std::string text;
+  auto file = LittleFS.open(path, "r");
+  int c;
+  while ((c = file.read()) >= 0) {
+    text.push_back(c);
+  }
+  file.close();
+  return text;
+}
+
+static void writeFile(const char* path, const std::string& text) {
+  auto file = LittleFS.open(path, "w");
+  file.write(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+  file.close();
+}
+
+static void reboot() {
+  configImage.invalidate();
+  climateStorage.invalidate();
+}
+
+void setUp(void) {
+  LittleFS.begin();
+  LittleFS.remove(CONFIG_IMAGE_PATH);
+  reboot();
+}
+
+void tearDown(void) {
+  LittleFS.remove("/climate.json"); // back to the data dir copy
+  rmdir(LittleFS.hostPath(CONFIG_IMAGE_PATH ".tmp").c_str());
+}
+
+void test_first_boot_generates_image(void) {
+  const auto& model = configImage.load();
+  TEST_ASSERT_EQUAL(CONFIG_SOURCE_JSON, configImage.getSource());
+  TEST_ASSERT_TRUE(LittleFS.exists(CONFIG_IMAGE_PATH));
+  TEST_ASSERT_EQUAL(HT_SENSOR_SHT30, model.climate.htSensor);
+  TEST_ASSERT_EQUAL(4, model.i2c.sdaPin);
+  TEST_ASSERT_EQUAL(5, model.i2c.sclPin);
+  TEST_ASSERT_EQUAL(3, model.i2c.enablePin);
+}
+
+void test_next_boot_decodes_image(void) {
+  configImage.load();
+  reboot();
+  const auto& model = configImage.load();
+  TEST_ASSERT_EQUAL(CONFIG_SOURCE_IMAGE, configImage.getSource());
+  TEST_ASSERT_EQUAL(CONFIG_IMAGE_VERSION, configImage.getSourceVersion());
+  // climateStorage is primed, its cache matches what json gives
+  const auto& climate = climateStorage.load();
+  TEST_ASSERT_EQUAL(HT_SENSOR_SHT30, climate.htSensor);
+  TEST_ASSERT_EQUAL(AQ_SENSOR_SGP30, climate.aqSensor);
+  TEST_ASSERT_EQUAL(10, climate.htQuery.loopSeconds);
+  TEST_ASSERT_EQUAL_FLOAT(-6, climate.revise.temperature);
+  TEST_ASSERT_EQUAL(36897, climate.baseline.co2);
+  TEST_ASSERT_EQUAL(30, climate.notify.minSeconds);
+  TEST_ASSERT_EQUAL(600, climate.notify.maxSeconds);
+  TEST_ASSERT_EQUAL_FLOAT(0.1, climate.compensation.absoluteHumidity);
+  TEST_ASSERT_EQUAL(1, climate.filter.oversample);
+  TEST_ASSERT_EQUAL(3, climate.filter.humidity.median);
+  TEST_ASSERT_EQUAL(1, climate.filter.voc.emaShift);
+  TEST_ASSERT_TRUE(climate.fusion.scan);
+  TEST_ASSERT_EQUAL(FUSION_MEAN, climate.fusion.mode);
+  TEST_ASSERT_EQUAL(1, climate.fusion.weights[2]);
+  TEST_ASSERT_EQUAL(HT_RATE_SINGLE_SHOT, climate.sht30.rate);
+  TEST_ASSERT_EQUAL(HT_REPEATABILITY_HIGH, climate.sht30.repeatability);
+  TEST_ASSERT_EQUAL(0, climate.telemetry.port);
+  TEST_ASSERT_EQUAL(16, climate.telemetry.batch);
+  TEST_ASSERT_EQUAL(60, climate.telemetry.flushSeconds);
+  TEST_ASSERT_EQUAL(3, model.i2c.enablePin);
+}
+
+void test_corrupt_image_falls_back_to_json(void) {
+  configImage.load();
+  auto bytes = readImage();
+  bytes[sizeof(ConfigImageHeader) + 3] ^= 0x5A;
+  writeImage(bytes);
+  reboot();
+  configImage.load();
+  TEST_ASSERT_EQUAL(CONFIG_SOURCE_JSON, configImage.getSource());
+  TEST_ASSERT_EQUAL(10, climateStorage.load().htQuery.loopSeconds);
+  // regenerated
+  reboot();
+  configImage.load();
+  TEST_ASSERT_EQUAL(CONFIG_SOURCE_IMAGE, configImage.getSource());
+}
+
+void test_version_1_image_is_migrated(void) {
+  const auto model = configImage.load();
+  auto header = ConfigImageHeader();
+  memcpy(&header, readImage().data(), sizeof(header));
+  // image as written by a build before notify existed
+  uint8_t payload[CONFIG_IMAGE_PAYLOAD_MAX];
+  header.version = 1;
+  header.length = ConfigImage::encode(model, payload, sizeof(payload), 1);
+  header.crc = crc16(payload, header.length);
+  std::vector<uint8_t> bytes(reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
+  bytes.insert(bytes.end(), payload, payload + header.length);
+  writeImage(bytes);
+  reboot();
+  configImage.load();
+  // regenerated from json, the fields version 1 lacks keep what climate.json says
+  TEST_ASSERT_EQUAL(CONFIG_SOURCE_JSON, configImage.getSource());
+  TEST_ASSERT_EQUAL(1, configImage.getSourceVersion());
+  TEST_ASSERT_EQUAL(36897, climateStorage.load().baseline.co2);
+  TEST_ASSERT_EQUAL(30, climateStorage.load().notify.minSeconds);
+  TEST_ASSERT_TRUE(configImage.verify());
+  // rewritten at the current version
+  reboot();
+  configImage.load();
+  TEST_ASSERT_EQUAL(CONFIG_SOURCE_IMAGE, configImage.getSource());
+  TEST_ASSERT_EQUAL(CONFIG_IMAGE_VERSION, configImage.getSourceVersion());
+  TEST_ASSERT_EQUAL(30, climateStorage.load().notify.minSeconds);
+}
+
+void test_edited_json_is_caught_by_verify(void) {
+  configImage.load();
+  reboot();
+  configImage.load();
+  TEST_ASSERT_TRUE(configImage.verify());
+  // edited on the device
+  auto json = readFile("/climate.json");
+  const auto at = json.find("\"ht\":{\"loop\":10");
+  TEST_ASSERT_TRUE(at != std::string::npos);
+  json.replace(at, 15, "\"ht\":{\"loop\":7");
+  writeFile("/climate.json", json);
+  reboot();
+  TEST_ASSERT_EQUAL(10, configImage.load().climate.htQuery.loopSeconds);
+  TEST_ASSERT_FALSE(configImage.verify());
+  reboot();
+  configImage.load();
+  TEST_ASSERT_EQUAL(CONFIG_SOURCE_IMAGE, configImage.getSource());
+  TEST_ASSERT_EQUAL(7, climateStorage.load().htQuery.loopSeconds);
+  TEST_ASSERT_TRUE(configImage.verify());
+}
+
+void test_failed_image_write_keeps_running(void) {
+  configImage.load();
+  auto json = readFile("/climate.json");
+  const auto at = json.find("\"ht\":{\"loop\":10");
+  TEST_ASSERT_TRUE(at != std::string::npos);
+  json.replace(at, 15, "\"ht\":{\"loop\":7");
+  writeFile("/climate.json", json);
+  // the image is written aside first, a directory in the way fails it like a full flash would
+  const auto tempPath = LittleFS.hostPath(CONFIG_IMAGE_PATH ".tmp");
+  TEST_ASSERT_EQUAL(0, mkdir(tempPath.c_str(), 0755));
+  reboot();
+  TEST_ASSERT_EQUAL(10, configImage.load().climate.htQuery.loopSeconds);
+  // no restart, it would only find the same old image again
+  TEST_ASSERT_TRUE(configImage.verify());
+  TEST_ASSERT_EQUAL(10, climateStorage.load().htQuery.loopSeconds);
+  rmdir(tempPath.c_str());
+  reboot();
+  configImage.load();
+  TEST_ASSERT_FALSE(configImage.verify());
+  reboot();
+  TEST_ASSERT_EQUAL(7, configImage.load().climate.htQuery.loopSeconds);
+}
+
+void test_boot_parse_cost(void) {
+  using Clock = std::chrono::steady_clock;
+  configImage.load();
+  // what setup() paid before: both json files through ArduinoJson
+  const auto jsonBegin = Clock::now();
+  for (auto i = 0; i < BOOT_ROUNDS; i++) {
+    climateStorage.invalidate();
+    climateStorage.load();
+    I2cStorage i2cStorage("/i2c.json");
+    delete i2cStorage.load();
+  }
+  const auto jsonNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - jsonBegin).count();
+  // image read and decode, the only config work left before sensors come up
+  const auto imageBegin = Clock::now();
+  for (auto i = 0; i < BOOT_ROUNDS; i++) {
+    reboot();
+    configImage.load();
+  }
+  const auto imageNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - imageBegin).count();
+  TEST_ASSERT_EQUAL(CONFIG_SOURCE_IMAGE, configImage.getSource());
+  // json crc against the image, after setup
+  const auto verifyBegin = Clock::now();
+  for (auto i = 0; i < BOOT_ROUNDS; i++) {
+    TEST_ASSERT_TRUE(configImage.verify());
+  }
+  const auto verifyNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - verifyBegin).count();
+  printf(
+    "\nboot config load over %d rounds: json %.1fus, image %.1fus (%lu byte payload), deferred verify %.1fus\n", BOOT_ROUNDS,
+    jsonNanos / 1000.0 / BOOT_ROUNDS, imageNanos / 1000.0 / BOOT_ROUNDS, static_cast<unsigned long>(readImage().size() - sizeof(ConfigImageHeader)),
+    verifyNanos / 1000.0 / BOOT_ROUNDS
+  );
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_boot_generates_image);
+  RUN_TEST(test_next_boot_decodes_image);
+  RUN_TEST(test_corrupt_image_falls_back_to_json);
+  RUN_TEST(test_version_1_image_is_migrated);
+  RUN_TEST(test_edited_json_is_caught_by_verify);
+  RUN_TEST(test_failed_image_write_keeps_running);
+  RUN_TEST(test_boot_parse_cost);
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include <limits.h>
+#include <unity.h>
+#include "DeadlineScheduler.h"
+
+using namespace Victor::Components;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_earliest_deadline_first(void) {
+  DeadlineScheduler scheduler;
+  TEST_ASSERT_TRUE(scheduler.after(1, 300, 0));
+  TEST_ASSERT_TRUE(scheduler.after(2, 100, 0));
+  TEST_ASSERT_TRUE(scheduler.after(3, 200, 0));
+  TEST_ASSERT_EQUAL(100, scheduler.idleMillis(0));
+  TEST_ASSERT_EQUAL(SCHEDULER_NONE, scheduler.next(99));
+  TEST_ASSERT_EQUAL(2, scheduler.next(300));
+  TEST_ASSERT_EQUAL(3, scheduler.next(300));
+  TEST_ASSERT_EQUAL(1, scheduler.next(300));
+  TEST_ASSERT_EQUAL(SCHEDULER_NONE, scheduler.next(300));
+  TEST_ASSERT_EQUAL(ULONG_MAX, scheduler.idleMillis(300));
+}
+
+void test_millis_wrap_around(void) {
+  DeadlineScheduler scheduler;
+  const unsigned long now = ULONG_MAX - 50;
+  // due after the wrap, still ordered behind a job due before it
+  TEST_ASSERT_TRUE(scheduler.after(1, 100, now));
+  TEST_ASSERT_TRUE(scheduler.after(2, 10, now));
+  TEST_ASSERT_EQUAL(10, scheduler.idleMillis(now));
+  TEST_ASSERT_EQUAL(SCHEDULER_NONE, scheduler.next(now + 9));
+  TEST_ASSERT_EQUAL(2, scheduler.next(now + 10));
+  // millis wrapped to 0, job 1 is due at 49
+  TEST_ASSERT_EQUAL(49, scheduler.idleMillis(0));
+  TEST_ASSERT_EQUAL(SCHEDULER_NONE, scheduler.next(48));
+  TEST_ASSERT_EQUAL(1, scheduler.next(49));
+  // a periodic job keeps its cadence across the wrap
+  TEST_ASSERT_TRUE(scheduler.every(3, 40, now, 0));
+  TEST_ASSERT_EQUAL(3, scheduler.next(now));
+  TEST_ASSERT_EQUAL(SCHEDULER_NONE, scheduler.next(now + 39));
+  TEST_ASSERT_EQUAL(3, scheduler.next(now + 40));
+  TEST_ASSERT_EQUAL(3, scheduler.next(now + 80)); // 29 after the wrap
+  TEST_ASSERT_EQUAL(40, scheduler.idleMillis(now + 80));
+}
+
+void test_fixed_cadence_without_drift(void) {
+  DeadlineScheduler scheduler;
+  TEST_ASSERT_TRUE(scheduler.every(1, 1000, 0, 1000));
+  // served a little late every time, the deadlines stay on the 1000 grid
+  for (unsigned long period = 1; period <= 100; period++) {
+    const auto now = period * 1000 + 7;
+    TEST_ASSERT_EQUAL(1, scheduler.next(now));
+    TEST_ASSERT_EQUAL(993, scheduler.idleMillis(now));
+  }
+  // a long stall drops the missed periods instead of firing them in a burst
+  TEST_ASSERT_EQUAL(1, scheduler.next(105500));
+  TEST_ASSERT_EQUAL(SCHEDULER_NONE, scheduler.next(105500));
+  TEST_ASSERT_EQUAL(500, scheduler.idleMillis(105500));
+}
+
+void test_same_id_replaces(void) {
+  DeadlineScheduler scheduler;
+  TEST_ASSERT_TRUE(scheduler.after(1, 100, 0));
+  TEST_ASSERT_TRUE(scheduler.after(1, 50, 0));
+  TEST_ASSERT_EQUAL(1, scheduler.size());
+  TEST_ASSERT_EQUAL(50, scheduler.idleMillis(0));
+  scheduler.cancel(1);
+  TEST_ASSERT_FALSE(scheduler.has(1));
+  TEST_ASSERT_EQUAL(0, scheduler.size());
+}
+
+void test_capacity_limit(void) {
+  DeadlineScheduler scheduler;
+  for (uint8_t id = 0; id < SCHEDULER_CAPACITY; id++) {
+    TEST_ASSERT_TRUE(scheduler.every(id, 1000, 0, id));
+  }
+  TEST_ASSERT_EQUAL(SCHEDULER_CAPACITY, scheduler.size());
+  // full, the push is refused instead of lost silently
+  TEST_ASSERT_FALSE(scheduler.after(SCHEDULER_CAPACITY, 1, 0));
+  TEST_ASSERT_FALSE(scheduler.has(SCHEDULER_CAPACITY));
+  // an id already held still gets replaced
+  TEST_ASSERT_TRUE(scheduler.after(0, 5000, 0));
+  TEST_ASSERT_EQUAL(SCHEDULER_CAPACITY, scheduler.size());
+  // periodic jobs popped while full go back in
+  TEST_ASSERT_EQUAL(1, scheduler.next(1));
+  TEST_ASSERT_EQUAL(SCHEDULER_CAPACITY, scheduler.size());
+  TEST_ASSERT_TRUE(scheduler.has(1));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_earliest_deadline_first);
+  RUN_TEST(test_millis_wrap_around);
+  RUN_TEST(test_fixed_cadence_without_drift);
+  RUN_TEST(test_same_id_replaces);
+  RUN_TEST(test_capacity_limit);
+  return UNITY_END();
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <unity.h>
+#include "EventLog.h"
+#include "ClimateMath.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// per measurement logging cost, console output swallowed so only the building is timed
+#define BENCH_ROUNDS 200000
+
+void setUp(void) {
+  VirtualClock::reset();
+  console.enabled = false;
+}
+
+void tearDown(void) {}
+
+void test_ring_keeps_the_newest(void) {
+  EventLog log;
+  for (auto i = 0; i < EVENT_LOG_CAPACITY + 3; i++) {
+    log.write(LOG_EVENT_HT_READING, EVENT_LOG_LEVEL_INFO, i, -i);
+  }
+  TEST_ASSERT_EQUAL(EVENT_LOG_CAPACITY, log.size());
+  TEST_ASSERT_EQUAL(3, log.getDropped());
+  // flushed a few per idle pass
+  TEST_ASSERT_EQUAL(EVENT_LOG_FLUSH_MAX, log.flush());
+  TEST_ASSERT_EQUAL(EVENT_LOG_CAPACITY - EVENT_LOG_FLUSH_MAX, log.size());
+  TEST_ASSERT_EQUAL(EVENT_LOG_CAPACITY - EVENT_LOG_FLUSH_MAX, log.flush(255));
+  TEST_ASSERT_EQUAL(0, log.size());
+  TEST_ASSERT_EQUAL(0, log.flush());
+}
+
+void test_centi_format_matches_console(void) {
+  char buffer[16];
+  for (const int32_t centi : { 0, 5, -5, 100, 1234, -1234, 4510, 10000000 }) {
+    TEST_ASSERT_EQUAL_STRING(ClimateMath::toString(centi).c_str(), EventLog::formatCenti(buffer, sizeof(buffer), centi));
+  }
+}
+
+void test_logging_benchmark(void) {
+  volatile int32_t humidity = 4512;
+  volatile int32_t temperature = 2398;
+  // before: Strings built and chained through the console inside measureHT
+  auto begin = std::chrono::steady_clock::now();
+  for (auto i = 0; i < BENCH_ROUNDS; i++) {
+    console.log()
+      .bracket(F("ht"))
+      .section(F("h"), ClimateMath::toString(humidity))
+      .section(F("t"), ClimateMath::toString(temperature));
+  }
+  const auto consoleNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count() / BENCH_ROUNDS;
+  // after: one entry into the ring, formatted later when the loop is idle
+  std::chrono::steady_clock::duration flushTime = {};
+  begin = std::chrono::steady_clock::now();
+  for (auto i = 0; i < BENCH_ROUNDS; i++) {
+    EVENT_LOG_INFO(LOG_EVENT_HT_READING, humidity, temperature);
+    if (eventLog.size() == EVENT_LOG_CAPACITY) {
+      const auto flushBegin = std::chrono::steady_clock::now();
+      eventLog.flush(255);
+      flushTime += std::chrono::steady_clock::now() - flushBegin;
+    }
+  }
+  eventLog.flush(255);
+  const auto writeNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin - flushTime).count() / BENCH_ROUNDS;
+  const auto flushNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(flushTime).count() / BENCH_ROUNDS;
+  printf(
+    "\nht reading log, host ns: console %lld, event log write %lld (+%lld formatted while idle), %u bytes per entry\n",
+    static_cast<long long>(consoleNanos), static_cast<long long>(writeNanos), static_cast<long long>(flushNanos), static_cast<unsigned>(sizeof(LogEntry))
+  );
+  TEST_ASSERT_LESS_THAN(consoleNanos, writeNanos);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_ring_keeps_the_newest);
+  RUN_TEST(test_centi_format_matches_console);
+  RUN_TEST(test_logging_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,188 @@
+#include <chrono>
+#include <unity.h>
+#include <FakeClimate.h>
+#include "HTSensor.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// host cost of one trigger + collect cycle against the fake bus,
+// pinned driver (inlined) against the runtime choice (virtual call)
+#define BENCH_ROUNDS 20000
+
+void setUp(void) {
+  VirtualClock::reset();
+  fakeClimate = FakeClimate();
+}
+
+void tearDown(void) {}
+
+struct BenchResult {
+  float cycleNanos = 0;
+  uint32_t failures = 0;
+  int32_t temperature = 0;
+};
+
+template <class Driver>
+static BenchResult benchCycle(const HTSensorType type) {
+  HTSensorT<Driver> ht(type);
+  BenchResult result;
+  result.failures = ht.begin() ? 0 : 1;
+  // the virtual clock waits are left out
+  const auto begin = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration waits = {};
+  for (auto i = 0; i < BENCH_ROUNDS; i++) {
+    result.failures += ht.measure() == MEASURE_FAILED ? 1 : 0;
+    const auto waitBegin = std::chrono::steady_clock::now();
+    delay(ht.getWaitMillis());
+    waits += std::chrono::steady_clock::now() - waitBegin;
+    result.failures += ht.measure() == MEASURE_FAILED ? 1 : 0;
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - begin - waits;
+  result.cycleNanos = static_cast<float>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / BENCH_ROUNDS;
+  result.temperature = ht.getCentiTemperature();
+  return result;
+}
+
+static void assertReading(const BenchResult& result) {
+  TEST_ASSERT_EQUAL(0, result.failures);
+  TEST_ASSERT_INT_WITHIN(10, 2400, result.temperature);
+}
+
+void test_pinned_and_generic_read_the_same(void) {
+  assertReading(benchCycle<Aht10Driver>(HT_SENSOR_AHT10));
+  assertReading(benchCycle<AnyHTDriver>(HT_SENSOR_AHT10));
+  assertReading(benchCycle<Sht30Driver>(HT_SENSOR_SHT30));
+  assertReading(benchCycle<AnyHTDriver>(HT_SENSOR_SHT30));
+}
+
+void test_supports(void) {
+  TEST_ASSERT_TRUE(HTSensorT<Aht10Driver>::supports(HT_SENSOR_AHT10));
+  TEST_ASSERT_FALSE(HTSensorT<Aht10Driver>::supports(HT_SENSOR_SHT30));
+  TEST_ASSERT_FALSE(HTSensorT<Sht30Driver>::supports(HT_SENSOR_AHT10));
+  TEST_ASSERT_TRUE(HTSensorT<AnyHTDriver>::supports(HT_SENSOR_SHT30));
+  TEST_ASSERT_FALSE(HTSensorT<AnyHTDriver>::supports(HT_SENSOR_OFF));
+}
+
+void test_ht_driver_benchmark(void) {
+  printf("ht measure cycle (trigger + collect), host ns:\n");
+  printf("  aht10 pinned %.1f, generic %.1f\n", benchCycle<Aht10Driver>(HT_SENSOR_AHT10).cycleNanos, benchCycle<AnyHTDriver>(HT_SENSOR_AHT10).cycleNanos);
+  printf("  sht30 pinned %.1f, generic %.1f\n", benchCycle<Sht30Driver>(HT_SENSOR_SHT30).cycleNanos, benchCycle<AnyHTDriver>(HT_SENSOR_SHT30).cycleNanos);
+  printf(
+    "sensor object: aht10 %u, sht30 %u, generic %u bytes (+ heap driver)\n",
+    static_cast<unsigned>(sizeof(HTSensorT<Aht10Driver>)), static_cast<unsigned>(sizeof(HTSensorT<Sht30Driver>)), static_cast<unsigned>(sizeof(HTSensorT<AnyHTDriver>))
+  );
+}
+
+struct ModeResult {
+  uint32_t failures = 0;
+  unsigned long latencyMillis = 0;
+  unsigned long busMicros = 0;
+  uint32_t transactions = 0;
+  int32_t temperature = 0;
+};
+
+// readings 10s apart like the ht loop, averaged over the rounds after the first
+static ModeResult benchMode(const HTRate rate, const HTRepeatability repeatability) {
+  HTSensorT<Sht30Driver> ht(HT_SENSOR_SHT30);
+  ht.configure({ .rate = rate, .repeatability = repeatability });
+  ModeResult result;
+  result.failures = ht.begin() ? 0 : 1;
+  const auto rounds = 20;
+  for (auto round = 0; round <= rounds; round++) {
+    delay(10000);
+    const auto start = millis();
+    const auto transactions = Wire.transactions;
+    unsigned long busMicros = 0;
+    auto state = MEASURE_SKIPPED;
+    while (state == MEASURE_SKIPPED) {
+      delay(ht.getWaitMillis());
+      const auto before = VirtualClock::nowMicros();
+      state = ht.measure();
+      busMicros += VirtualClock::nowMicros() - before;
+    }
+    result.failures += state == MEASURE_FAILED ? 1 : 0;
+    if (round > 0) {
+      result.latencyMillis += millis() - start;
+      result.busMicros += busMicros;
+      result.transactions += Wire.transactions - transactions;
+    }
+  }
+  result.latencyMillis /= rounds;
+  result.busMicros /= rounds;
+  result.transactions /= rounds;
+  result.temperature = ht.getCentiTemperature();
+  return result;
+}
+
+void test_sht30_modes(void) {
+  const struct {
+    const char* name;
+    HTRate rate;
+    HTRepeatability repeatability;
+  } modes[] = {
+    { "single shot high", HT_RATE_SINGLE_SHOT, HT_REPEATABILITY_HIGH },
+    { "single shot low", HT_RATE_SINGLE_SHOT, HT_REPEATABILITY_LOW },
+    { "periodic 1mps high", HT_RATE_1_MPS, HT_REPEATABILITY_HIGH },
+    { "periodic 10mps low", HT_RATE_10_MPS, HT_REPEATABILITY_LOW },
+  };
+  printf("sht30 per reading: latency ms, bus us, transactions\n");
+  for (const auto& mode : modes) {
+    const auto result = benchMode(mode.rate, mode.repeatability);
+    printf("  %-20s %4lu %6lu %3lu\n", mode.name, result.latencyMillis, result.busMicros, static_cast<unsigned long>(result.transactions));
+    TEST_ASSERT_EQUAL(0, result.failures);
+    TEST_ASSERT_INT_WITHIN(10, 2400, result.temperature);
+    if (mode.rate == HT_RATE_SINGLE_SHOT) {
+      TEST_ASSERT_EQUAL(Sht30Driver::conversionMillis(mode.repeatability), result.latencyMillis);
+    } else {
+      // the result is waiting, no conversion time in between
+      TEST_ASSERT_EQUAL(0, result.latencyMillis);
+    }
+  }
+}
+
+void test_sht30_periodic_fetch_waits_for_the_next_result(void) {
+  HTSensorT<Sht30Driver> ht(HT_SENSOR_SHT30);
+  ht.configure({ .rate = HT_RATE_2_MPS, .repeatability = HT_REPEATABILITY_HIGH });
+  TEST_ASSERT_TRUE(ht.begin());
+  // right after begin the first result is a period away
+  TEST_ASSERT_EQUAL(MEASURE_SKIPPED, ht.measure());
+  TEST_ASSERT_EQUAL(500, ht.getWaitMillis());
+  delay(ht.getWaitMillis());
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, ht.measure());
+  // back to back readings follow the sensor rate
+  TEST_ASSERT_EQUAL(MEASURE_SKIPPED, ht.measure());
+  TEST_ASSERT_EQUAL(500, ht.getWaitMillis());
+  // a reset ends periodic mode on the sensor, the driver starts it again
+  ht.reset();
+  delay(500);
+  auto state = MEASURE_SKIPPED;
+  for (auto pass = 0; pass < 10 && state == MEASURE_SKIPPED; pass++) {
+    state = ht.measure();
+    delay(ht.getWaitMillis());
+  }
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, state);
+}
+
+void test_sht30_begin_breaks_periodic_mode_left_running(void) {
+  HTSensorT<Sht30Driver> ht(HT_SENSOR_SHT30);
+  ht.configure({ .rate = HT_RATE_10_MPS, .repeatability = HT_REPEATABILITY_LOW });
+  TEST_ASSERT_TRUE(ht.begin());
+  // a warm restart finds the sensor still measuring, a bare soft reset is ignored
+  ht.configure({ .rate = HT_RATE_SINGLE_SHOT, .repeatability = HT_REPEATABILITY_HIGH });
+  TEST_ASSERT_TRUE(ht.begin());
+  TEST_ASSERT_EQUAL(MEASURE_SKIPPED, ht.measure());
+  delay(ht.getWaitMillis());
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, ht.measure());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_supports);
+  RUN_TEST(test_pinned_and_generic_read_the_same);
+  RUN_TEST(test_ht_driver_benchmark);
+  RUN_TEST(test_sht30_modes);
+  RUN_TEST(test_sht30_periodic_fetch_waits_for_the_next_result);
+  RUN_TEST(test_sht30_begin_breaks_periodic_mode_left_running);
+  return UNITY_END();
+}
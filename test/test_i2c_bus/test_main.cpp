@@ -0,0 +1,180 @@
+#include <unity.h>
+#include <FakeClimate.h>
+#include "HTSensor.h"
+#include "AQSensor.h"
+#include "I2cBus.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+#define TEST_SDA_PIN 4
+#define TEST_SCL_PIN 5
+#define TEST_SHT30_ADDRESS 0x44
+
+void setUp(void) {
+  VirtualClock::reset();
+  fakeClimate = FakeClimate();
+  i2cBus.clearStats();
+  i2cBus.begin(TEST_SDA_PIN, TEST_SCL_PIN);
+}
+
+void tearDown(void) {
+  Wire.stick(0);
+}
+
+// drive the sensor like the scheduler does, until it settles or the deadline passes
+static MeasureState readUntilSettled(HTSensor& ht, const unsigned long deadlineMillis) {
+  auto state = ht.measure();
+  while (state == MEASURE_SKIPPED && millis() < deadlineMillis) {
+    delay(std::max<unsigned long>(1, ht.getWaitMillis()));
+    state = ht.measure();
+  }
+  return state;
+}
+
+void test_latency_histogram(void) {
+  i2cBus.record(0x44, true, 50);
+  i2cBus.record(0x44, true, 150);
+  i2cBus.record(0x44, false, 1500);
+  i2cBus.record(0x44, true, 20000);
+  i2cBus.record(0x58, true, 100);
+  TEST_ASSERT_EQUAL(2, i2cBus.size());
+  const auto sht30 = i2cBus.find(0x44);
+  TEST_ASSERT_NOT_NULL(sht30);
+  TEST_ASSERT_EQUAL(4, sht30->transactions);
+  TEST_ASSERT_EQUAL(1, sht30->errors);
+  TEST_ASSERT_EQUAL(20000, sht30->maxMicros);
+  TEST_ASSERT_EQUAL(1, sht30->latency[0]);
+  TEST_ASSERT_EQUAL(1, sht30->latency[1]);
+  TEST_ASSERT_EQUAL(1, sht30->latency[4]);
+  TEST_ASSERT_EQUAL(1, sht30->latency[I2C_BUS_LATENCY_BUCKETS - 1]);
+  // bounds are exclusive
+  TEST_ASSERT_EQUAL(1, i2cBus.find(0x58)->latency[1]);
+  TEST_ASSERT_NULL(i2cBus.find(0x38));
+
+  char buffer[256];
+  size_t cursor = 0;
+  const auto length = i2cBus.writeCsv(cursor, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL(2, cursor);
+  TEST_ASSERT_EQUAL_STRING_LEN("0x44,4,1,0,0,20000,1,1,0,0,1,0,0,1\n0x58,1,0,0,0,100,0,1,0,0,0,0,0,0\n", buffer, length);
+  TEST_ASSERT_EQUAL(0, i2cBus.writeCsv(cursor, buffer, sizeof(buffer)));
+}
+
+void test_backoff(void) {
+  TEST_ASSERT_EQUAL(I2C_BUS_BACKOFF_MILLIS, I2cBus::backoffMillis(0));
+  TEST_ASSERT_EQUAL(I2C_BUS_BACKOFF_MILLIS * 2, I2cBus::backoffMillis(1));
+  TEST_ASSERT_EQUAL(I2C_BUS_BACKOFF_MILLIS * 4, I2cBus::backoffMillis(2));
+}
+
+void test_transient_failure_retried(void) {
+  HTSensor ht(HT_SENSOR_SHT30);
+  TEST_ASSERT_TRUE(ht.begin());
+  fakeClimate.fail = true;
+  // the failed trigger is held back as a retry, not reported
+  TEST_ASSERT_EQUAL(MEASURE_SKIPPED, ht.measure());
+  TEST_ASSERT_TRUE(ht.isConverting());
+  // counted from the start of measure(), the bus time of the failed trigger may cross a millis tick
+  TEST_ASSERT_UINT_WITHIN(1, I2C_BUS_BACKOFF_MILLIS, ht.getWaitMillis());
+  fakeClimate.fail = false;
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, readUntilSettled(ht, 1000));
+  TEST_ASSERT_INT_WITHIN(10, 2400, ht.getCentiTemperature());
+  const auto stats = i2cBus.find(TEST_SHT30_ADDRESS);
+  TEST_ASSERT_NOT_NULL(stats);
+  TEST_ASSERT_EQUAL(1, stats->errors);
+  TEST_ASSERT_EQUAL(1, stats->retries);
+  TEST_ASSERT_EQUAL(0, stats->recoveries);
+  TEST_ASSERT_EQUAL(0, i2cBus.getClears());
+}
+
+void test_persistent_failure_reported(void) {
+  HTSensor ht(HT_SENSOR_SHT30);
+  TEST_ASSERT_TRUE(ht.begin());
+  fakeClimate.fail = true;
+  TEST_ASSERT_EQUAL(MEASURE_FAILED, readUntilSettled(ht, 10000));
+  TEST_ASSERT_FALSE(ht.isConverting());
+  const auto stats = i2cBus.find(TEST_SHT30_ADDRESS);
+  // retries, a recovery, and the retries after it
+  TEST_ASSERT_EQUAL(I2C_BUS_RETRY_LIMIT * 2, stats->retries);
+  TEST_ASSERT_EQUAL(1, stats->recoveries);
+  TEST_ASSERT_EQUAL(1, i2cBus.getClears());
+  // the next reading starts over
+  fakeClimate.fail = false;
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, readUntilSettled(ht, millis() + 1000));
+}
+
+void test_stuck_bus_cleared(void) {
+  HTSensor ht(HT_SENSOR_SHT30);
+  TEST_ASSERT_TRUE(ht.begin());
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, readUntilSettled(ht, 1000));
+  // a slave holding sda low mid-byte, only clocking scl lets it go
+  Wire.stick();
+  const auto stuckAt = millis();
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, readUntilSettled(ht, stuckAt + 10000));
+  const auto staleMillis = millis() - stuckAt;
+  TEST_ASSERT_FALSE(Wire.isStuck());
+  TEST_ASSERT_EQUAL(1, i2cBus.getClears());
+  TEST_ASSERT_EQUAL(1, i2cBus.find(TEST_SHT30_ADDRESS)->recoveries);
+  TEST_ASSERT_INT_WITHIN(10, 2400, ht.getCentiTemperature());
+  // the wire is back on its pins afterwards
+  TEST_ASSERT_EQUAL(TEST_SDA_PIN, Wire.getSdaPin());
+  TEST_ASSERT_EQUAL(TEST_SCL_PIN, Wire.getSclPin());
+  printf("\nstuck bus: reading back after %lums (without recovery: stale until reboot)\n", staleMillis);
+  TEST_ASSERT_LESS_THAN(1000, staleMillis);
+}
+
+// one split sample: command, wait, read
+MeasureState sampleOnce(AQSensor& aq) {
+  const auto state = aq.sample();
+  if (!aq.isConverting()) {
+    return state;
+  }
+  delay(aq.getWaitMillis());
+  return aq.sample();
+}
+
+void test_sgp30_sample_split(void) {
+  AQSensor aq(AQ_SENSOR_SGP30);
+  TEST_ASSERT_TRUE(aq.begin());
+  const auto start = micros();
+  TEST_ASSERT_EQUAL(MEASURE_SKIPPED, aq.sample());
+  TEST_ASSERT_TRUE(aq.isConverting());
+  const auto commandMicros = micros() - start;
+  // read too early, NACKed like the real one, counted as a failed sample
+  TEST_ASSERT_EQUAL(MEASURE_FAILED, aq.sample());
+  TEST_ASSERT_FALSE(aq.isConverting());
+  delay(AQ_SAMPLE_INTERVAL_MILLIS);
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, sampleOnce(aq));
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, aq.measure());
+  TEST_ASSERT_UINT_WITHIN(fakeClimate.co2Noise, fakeClimate.co2, aq.getCO2());
+  TEST_ASSERT_UINT_WITHIN(fakeClimate.tvocNoise, fakeClimate.tvoc, aq.getTVOC());
+  printf("\nsgp30 sample: %luus on the bus per call instead of a %lums block\n", static_cast<unsigned long>(commandMicros), static_cast<unsigned long>(fakeClimate.sgp30MeasureMicros / 1000));
+  TEST_ASSERT_LESS_THAN(fakeClimate.sgp30MeasureMicros / 10, commandMicros);
+}
+
+void test_sgp30_recovered(void) {
+  AQSensor aq(AQ_SENSOR_SGP30);
+  TEST_ASSERT_TRUE(aq.begin());
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, sampleOnce(aq));
+  Wire.stick();
+  for (auto i = 0; i < AQ_RECOVER_FAILURES; i++) {
+    delay(AQ_SAMPLE_INTERVAL_MILLIS);
+    TEST_ASSERT_EQUAL(MEASURE_FAILED, sampleOnce(aq));
+  }
+  TEST_ASSERT_FALSE(Wire.isStuck());
+  TEST_ASSERT_EQUAL(1, aq.getSampling().recoveries);
+  TEST_ASSERT_EQUAL(1, i2cBus.find(AQ_SGP30_ADDRESS)->recoveries);
+  delay(AQ_SAMPLE_INTERVAL_MILLIS);
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, sampleOnce(aq));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_latency_histogram);
+  RUN_TEST(test_backoff);
+  RUN_TEST(test_transient_failure_retried);
+  RUN_TEST(test_persistent_failure_reported);
+  RUN_TEST(test_stuck_bus_cleared);
+  RUN_TEST(test_sgp30_sample_split);
+  RUN_TEST(test_sgp30_recovered);
+  return UNITY_END();
+}
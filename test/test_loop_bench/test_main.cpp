@@ -0,0 +1,168 @@
+#include <unity.h>
+#include <LoopBench.h>
+#include <FakeClimate.h>
+#include "ClimateStorage.h"
+#include "ClimateMeasure.h"
+#include "SensorRegistry.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// characteristics normally defined in src/accessory.c
+homekit_characteristic_t temperatureState = {};
+homekit_characteristic_t temperatureActiveState = {};
+homekit_characteristic_t humidityState = {};
+homekit_characteristic_t humidityActiveState = {};
+homekit_characteristic_t carbonDioxideState = {};
+homekit_characteristic_t vocDensityState = {};
+homekit_characteristic_t airQualityState = {};
+homekit_characteristic_t airQualityActiveState = {};
+
+// an extra consumer on the measure bus, like an exporter would be
+class CountingSink : public SensorSink {
+ public:
+  void onReading(const SensorReading& reading) override {
+    (reading.type == SENSOR_READING_HT ? ht : aq)++;
+  }
+  unsigned long ht = 0;
+  unsigned long aq = 0;
+};
+
+// one simulated hour of loop(), sleeping until the next deadline but at most 20ms per pass
+#define BENCH_LOOP_SLEEP_MAX_MS 20
+#define BENCH_SIMULATED_MS (60UL * 60 * 1000)
+
+void setUp(void) {
+  VirtualClock::reset();
+  climateHistory.clear();
+  fakeClimate = FakeClimate();
+  homekit_native_notify_count = 0;
+  metrics.clear();
+}
+
+void tearDown(void) {}
+
+void runLoopBench(const HTSensorType htSensor) {
+  const auto climate = &climateStorage.load();
+  TEST_ASSERT_GREATER_THAN(0, climate->htQuery.loopSeconds);
+  TEST_ASSERT_GREATER_THAN(0, climate->aqQuery.loopSeconds);
+
+  // one ht sensor of the given type, no bus scan
+  auto setting = *climate;
+  setting.htSensor = htSensor;
+  setting.fusion.scan = false;
+  const auto registry = new SensorRegistry();
+  registry->create(setting);
+  const auto ht = registry->getHT();
+  const auto aq = registry->getAQ();
+  TEST_ASSERT_TRUE(ht->begin());
+  TEST_ASSERT_TRUE(aq->begin());
+  aq->loadBaseline(climate->baseline);
+  VirtualClock::reset();
+  const auto measure = new ClimateMeasure(climate, ht, aq);
+  CountingSink counting;
+  TEST_ASSERT_TRUE(measure->getBus().subscribe(&counting));
+  TEST_ASSERT_TRUE(measure->begin());
+
+  PhaseStats loopStats("loop");
+  PhaseStats jobStats[JOB_COUNT] = {
+    PhaseStats("htMeasure"),
+    PhaseStats("htCollect"),
+    PhaseStats("htReset"),
+    PhaseStats("aqMeasure"),
+    PhaseStats("aqReset"),
+    PhaseStats("aqStore"),
+    PhaseStats("history"),
+    PhaseStats("aqSample"),
+    PhaseStats("aqCollect"),
+  };
+  unsigned long idlePasses = 0;
+  while (millis() < BENCH_SIMULATED_MS) {
+    auto ran = false;
+    loopStats.run([&]() {
+      uint8_t job;
+      while ((job = measure->nextJob()) != SCHEDULER_NONE) {
+        jobStats[job].run([&]() { measure->runJob(job, true); });
+        ran = true;
+      }
+      measure->flushNotify();
+    });
+    idlePasses += ran ? 0 : 1;
+    delay(std::min<unsigned long>(measure->getIdleMillis(), BENCH_LOOP_SLEEP_MAX_MS));
+  }
+
+  printf(
+    "\nsimulated %lus, %s every %us, sgp30 every %us\n", BENCH_SIMULATED_MS / 1000,
+    htSensor == HT_SENSOR_AHT10 ? "aht10" : "sht30", climate->htQuery.loopSeconds, climate->aqQuery.loopSeconds
+  );
+  PhaseStats::printHeader();
+  loopStats.print();
+  for (const auto& stats : jobStats) {
+    stats.print();
+  }
+  printf("idle passes: %lu of %lu\n", idlePasses, loopStats.calls);
+  const auto& notifyStats = measure->getNotifyBatch().getStats();
+  printf(
+    "notifications: %lu requested, %lu sent in %lu flushes, %lu saved\n",
+    notifyStats.requested, notifyStats.sent, notifyStats.flushes, notifyStats.saved
+  );
+  printf("ht worst-case block: %luus\n", ht->getMaxBlockMicros());
+  printf(
+    "sgp30 sampling: %lu samples, jitter avg %luus max %luus\n", static_cast<unsigned long>(aq->getSampling().samples),
+    static_cast<unsigned long>(aq->getSampling().jitterAvgMicros()), static_cast<unsigned long>(aq->getSampling().jitterMaxMicros)
+  );
+  printf(
+    "sgp30 humidity compensation: %lu writes, %lu skipped under %.2fg/m3\n",
+    static_cast<unsigned long>(aq->getHumidityWrites()), static_cast<unsigned long>(aq->getHumiditySkips()), climate->compensation.absoluteHumidity
+  );
+
+  TEST_ASSERT_TRUE(temperatureActiveState.value.bool_value);
+  TEST_ASSERT_TRUE(humidityActiveState.value.bool_value);
+  TEST_ASSERT_TRUE(airQualityActiveState.value.bool_value);
+  // every measure lands on its cadence, nothing polled in between
+  TEST_ASSERT_UINT_WITHIN(1, BENCH_SIMULATED_MS / 1000 / climate->htQuery.loopSeconds, jobStats[JOB_HT_MEASURE].calls);
+  TEST_ASSERT_UINT_WITHIN(1, BENCH_SIMULATED_MS / 1000 / climate->aqQuery.loopSeconds, jobStats[JOB_AQ_MEASURE].calls);
+  TEST_ASSERT_GREATER_OR_EQUAL(jobStats[JOB_HT_MEASURE].calls, jobStats[JOB_HT_COLLECT].busyCalls);
+  TEST_ASSERT_EQUAL(notifyStats.sent, homekit_native_notify_count);
+  // every notified value moved the revision the portal snapshot renders on
+  TEST_ASSERT_GREATER_OR_EQUAL(notifyStats.sent, measure->getRevision());
+  // every notification lands on a tracked characteristic, every measure is counted
+  unsigned long notified = 0;
+  for (uint8_t i = 0; i < metrics.size(); i++) {
+    notified += metrics.at(i).notified;
+  }
+  TEST_ASSERT_EQUAL(notifyStats.sent, notified);
+  TEST_ASSERT_EQUAL(jobStats[JOB_HT_MEASURE].calls, metrics.getSensor(METRIC_SENSOR_HT).success);
+  TEST_ASSERT_EQUAL(jobStats[JOB_AQ_MEASURE].calls, metrics.getSensor(METRIC_SENSOR_AQ).success);
+  // every reading reached the added sink without touching the measure code
+  TEST_ASSERT_EQUAL(jobStats[JOB_HT_MEASURE].calls, counting.ht);
+  TEST_ASSERT_EQUAL(jobStats[JOB_AQ_MEASURE].calls, counting.aq);
+  TEST_ASSERT_UINT_WITHIN(1, BENCH_SIMULATED_MS / 1000 / HISTORY_PERIOD_SECONDS, climateHistory.size());
+  TEST_ASSERT_LESS_OR_EQUAL(notifyStats.sent, notifyStats.flushes);
+  // sgp30 sampled at 1Hz no matter the reporting cadence, late by no more than one loop pass
+  TEST_ASSERT_UINT_WITHIN(1, BENCH_SIMULATED_MS / AQ_SAMPLE_INTERVAL_MILLIS, aq->getSampling().samples);
+  TEST_ASSERT_LESS_THAN(BENCH_LOOP_SLEEP_MAX_MS * 1000UL, aq->getSampling().jitterMaxMicros);
+  // one compensation decision per ht reading, the stand-in saw only the writes
+  TEST_ASSERT_EQUAL(jobStats[JOB_HT_MEASURE].calls, aq->getHumidityWrites() + aq->getHumiditySkips());
+  TEST_ASSERT_GREATER_THAN(aq->getHumidityWrites(), aq->getHumiditySkips());
+  // split-phase: nothing close to a conversion time may block loop()
+  TEST_ASSERT_LESS_THAN(5000, ht->getMaxBlockMicros());
+
+  delete measure;
+  delete registry;
+}
+
+void test_loop_bench_aht10(void) {
+  runLoopBench(HT_SENSOR_AHT10);
+}
+
+void test_loop_bench_sht30(void) {
+  runLoopBench(HT_SENSOR_SHT30);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_loop_bench_aht10);
+  RUN_TEST(test_loop_bench_sht30);
+  return UNITY_END();
+}
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <unity.h>
+#include "LoopProfiler.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// host cost of one mark(), the profiler runs eight of them per loop()
+#define BENCH_MARKS 1000000
+
+void setUp(void) {
+  VirtualClock::reset();
+}
+
+void tearDown(void) {}
+
+// one loop() with the given virtual time spent per phase
+static void iteration(LoopProfiler& profiler, const unsigned long (&micros)[LOOP_PHASE_COUNT]) {
+  profiler.begin();
+  for (uint8_t i = 0; i < LOOP_PHASE_COUNT; i++) {
+    VirtualClock::advanceMicros(micros[i]);
+    profiler.mark(static_cast<LoopPhase>(i));
+  }
+  profiler.end();
+}
+
+void test_time_goes_to_its_phase(void) {
+  LoopProfiler profiler;
+  iteration(profiler, { 300, 1000, 50, 10, 0, 20000, 1, 5000 });
+  iteration(profiler, { 100, 3000, 50, 10, 0, 20000, 1, 0 });
+  TEST_ASSERT_EQUAL(2, profiler.getIterations());
+  const auto& homekit = profiler.at(LOOP_PHASE_HOMEKIT);
+  TEST_ASSERT_EQUAL(2, homekit.calls);
+  TEST_ASSERT_EQUAL(100, homekit.minMicros);
+  TEST_ASSERT_EQUAL(300, homekit.maxMicros);
+  TEST_ASSERT_EQUAL(200, homekit.avgMicros());
+  const auto& sensor = profiler.at(LOOP_PHASE_SENSOR);
+  TEST_ASSERT_EQUAL(2000, sensor.avgMicros());
+  // 1000us and 3000us land in [512, 1024) and [2048, 4096)
+  TEST_ASSERT_EQUAL(1, sensor.histogram[9]);
+  TEST_ASSERT_EQUAL(1, sensor.histogram[11]);
+  TEST_ASSERT_EQUAL(2, profiler.at(LOOP_PHASE_BUTTON).histogram[0]);
+  TEST_ASSERT_EQUAL(1, profiler.at(LOOP_PHASE_NOTIFY).histogram[0]);
+  // the sleep is not busy time
+  TEST_ASSERT_EQUAL(20000, profiler.at(LOOP_PHASE_SLEEP).maxMicros);
+  TEST_ASSERT_EQUAL(300 + 1000 + 50 + 10 + 1 + 5000, profiler.getMaxMicros());
+}
+
+void test_slow_iteration_names_the_phase(void) {
+  LoopProfiler profiler;
+  profiler.setSlowMillis(50);
+  // a long sleep alone is fine
+  iteration(profiler, { 100, 100, 100, 100, 0, 200000, 100, 100 });
+  TEST_ASSERT_EQUAL(0, profiler.getSlowIterations());
+  // homekit serving a pairing request
+  iteration(profiler, { 80000, 100, 100, 100, 0, 0, 100, 100 });
+  TEST_ASSERT_EQUAL(1, profiler.getSlowIterations());
+  TEST_ASSERT_EQUAL(LOOP_PHASE_HOMEKIT, profiler.getSlowPhase());
+  TEST_ASSERT_EQUAL(80500, profiler.getSlowMicros());
+  // a sensor blocking on the bus
+  iteration(profiler, { 100, 60000, 100, 100, 0, 0, 100, 100 });
+  TEST_ASSERT_EQUAL(2, profiler.getSlowIterations());
+  TEST_ASSERT_EQUAL(LOOP_PHASE_SENSOR, profiler.getSlowPhase());
+  // disabled
+  profiler.setSlowMillis(0);
+  iteration(profiler, { 100, 60000, 100, 100, 0, 0, 100, 100 });
+  TEST_ASSERT_EQUAL(2, profiler.getSlowIterations());
+}
+
+void test_csv(void) {
+  LoopProfiler profiler;
+  iteration(profiler, { 3, 40000, 0, 0, 0, 0, 0, 0 });
+  char buffer[256];
+  size_t cursor = 0;
+  auto length = profiler.writeCsv(cursor, buffer, sizeof(buffer));
+  TEST_ASSERT_GREATER_THAN(0, length);
+  buffer[length] = '\0';
+  // 3us in [2, 4), 40ms in the open ended bucket
+  const char* expected = "homekit,1,3,3,3,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0\nsensor,1,40000,40000,40000,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1\n";
+  TEST_ASSERT_EQUAL(0, strncmp(buffer, expected, strlen(expected)));
+  size_t rows = 0;
+  cursor = 0;
+  while ((length = profiler.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+    for (size_t i = 0; i < length; i++) {
+      rows += buffer[i] == '\n' ? 1 : 0;
+    }
+  }
+  TEST_ASSERT_EQUAL(LOOP_PHASE_COUNT, rows);
+}
+
+void test_mark_overhead(void) {
+  LoopProfiler profiler;
+  profiler.begin();
+  const auto begin = std::chrono::steady_clock::now();
+  for (auto i = 0; i < BENCH_MARKS; i++) {
+    profiler.mark(static_cast<LoopPhase>(i % LOOP_PHASE_COUNT));
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - begin;
+  const auto nanos = static_cast<float>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / BENCH_MARKS;
+  printf("\nloop profiler mark: %.1f ns host, %u bytes of state\n", nanos, static_cast<unsigned>(sizeof(LoopProfiler)));
+  TEST_ASSERT_LESS_THAN(1000, nanos);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_time_goes_to_its_phase);
+  RUN_TEST(test_slow_iteration_names_the_phase);
+  RUN_TEST(test_csv);
+  RUN_TEST(test_mark_overhead);
+  return UNITY_END();
+}
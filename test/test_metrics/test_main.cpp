@@ -0,0 +1,107 @@
+#include <chrono>
+#include <string>
+#include <unity.h>
+#include "Metrics.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// host cost of the per event updates
+#define BENCH_EVENTS 1000000
+
+static homekit_characteristic_t temperature = {};
+static homekit_characteristic_t humidity = {};
+static homekit_characteristic_t untracked = {};
+
+void setUp(void) {
+  VirtualClock::reset();
+}
+
+void tearDown(void) {}
+
+void test_loop_rate_and_heap(void) {
+  Metrics metrics;
+  // 2ms per pass for 3 seconds
+  for (auto i = 0; i < 1500; i++) {
+    metrics.loop();
+    delay(2);
+  }
+  metrics.loop();
+  TEST_ASSERT_UINT_WITHIN(1, 500, metrics.getLoopRate());
+  const auto& heap = metrics.getHeap();
+  TEST_ASSERT_EQUAL(ESP.getFreeHeap(), heap.free);
+  TEST_ASSERT_EQUAL(ESP.getFreeHeap(), heap.freeMin);
+  TEST_ASSERT_EQUAL(ESP.getMaxFreeBlockSize(), heap.maxBlock);
+}
+
+void test_counters(void) {
+  Metrics metrics;
+  metrics.track(&temperature, F("temperature"));
+  metrics.track(&humidity, F("humidity"));
+  metrics.track(&temperature, F("temperature"));
+  TEST_ASSERT_EQUAL(2, metrics.size());
+  metrics.notified(&temperature);
+  metrics.notified(&temperature);
+  metrics.notified(&humidity);
+  metrics.notified(&untracked);
+  metrics.notifySaved();
+  TEST_ASSERT_EQUAL(2, metrics.at(0).notified);
+  TEST_ASSERT_EQUAL(1, metrics.at(1).notified);
+
+  metrics.sensorReset(METRIC_SENSOR_HT);
+  metrics.measured(METRIC_SENSOR_HT, MEASURE_SUCCESS);
+  metrics.measured(METRIC_SENSOR_HT, MEASURE_SKIPPED);
+  metrics.measured(METRIC_SENSOR_HT, MEASURE_FAILED);
+  metrics.measured(METRIC_SENSOR_AQ, MEASURE_SUCCESS);
+  TEST_ASSERT_EQUAL(1, metrics.getSensor(METRIC_SENSOR_HT).success);
+  TEST_ASSERT_EQUAL(1, metrics.getSensor(METRIC_SENSOR_HT).failure);
+  TEST_ASSERT_EQUAL(1, metrics.getSensor(METRIC_SENSOR_AQ).success);
+  delay(90000);
+  metrics.sensorReset(METRIC_SENSOR_AQ);
+  delay(30000);
+  TEST_ASSERT_EQUAL(120, metrics.getSensorUptime(METRIC_SENSOR_HT));
+  TEST_ASSERT_EQUAL(30, metrics.getSensorUptime(METRIC_SENSOR_AQ));
+
+  // small chunks still carry whole rows
+  char buffer[40];
+  std::string csv;
+  size_t cursor = 0;
+  size_t length;
+  while ((length = metrics.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+    buffer[length] = '\0';
+    csv += buffer;
+  }
+  TEST_ASSERT_EQUAL(0, csv.find("uptime_s,120\n"));
+  TEST_ASSERT_TRUE(csv.find("\nht_success,1\nht_failure,1\nht_uptime_s,120\n") != std::string::npos);
+  TEST_ASSERT_TRUE(csv.find("\naq_uptime_s,30\nnotify_saved,1\n") != std::string::npos);
+  TEST_ASSERT_TRUE(csv.find("\nnotify_temperature,2\nnotify_humidity,1\n") != std::string::npos);
+
+  metrics.clear();
+  TEST_ASSERT_EQUAL(0, metrics.at(0).notified);
+  TEST_ASSERT_EQUAL(0, metrics.getNotifySaved());
+  TEST_ASSERT_EQUAL(0, metrics.getSensor(METRIC_SENSOR_HT).success);
+}
+
+void test_update_overhead(void) {
+  Metrics metrics;
+  metrics.track(&temperature, F("temperature"));
+  metrics.track(&humidity, F("humidity"));
+  const auto begin = std::chrono::steady_clock::now();
+  for (auto i = 0; i < BENCH_EVENTS; i++) {
+    metrics.loop();
+    metrics.notified(i & 1 ? &humidity : &temperature);
+    metrics.measured(METRIC_SENSOR_HT, MEASURE_SUCCESS);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - begin;
+  const auto nanos = static_cast<float>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / BENCH_EVENTS;
+  printf("\nmetrics loop + notified + measured: %.1f ns host, %u bytes of state\n", nanos, static_cast<unsigned>(sizeof(Metrics)));
+  TEST_ASSERT_EQUAL(BENCH_EVENTS / 2, metrics.at(1).notified);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_loop_rate_and_heap);
+  RUN_TEST(test_counters);
+  RUN_TEST(test_update_overhead);
+  return UNITY_END();
+}
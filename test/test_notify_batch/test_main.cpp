@@ -0,0 +1,67 @@
+#include <unity.h>
+#include "NotifyBatch.h"
+
+using namespace Victor::Components;
+
+homekit_characteristic_t characteristics[NOTIFY_BATCH_CAPACITY + 1] = {};
+
+void setUp(void) {
+  homekit_native_notify_count = 0;
+  metrics.clear();
+}
+
+void tearDown(void) {}
+
+void test_repeats_collapse_within_flush(void) {
+  NotifyBatch batch;
+  batch.add(&characteristics[0]);
+  batch.add(&characteristics[1]);
+  batch.add(&characteristics[0]);
+  // nothing reaches the server before the flush
+  TEST_ASSERT_FALSE(batch.isEmpty());
+  TEST_ASSERT_EQUAL(0, homekit_native_notify_count);
+  batch.flush();
+  TEST_ASSERT_TRUE(batch.isEmpty());
+  TEST_ASSERT_EQUAL(2, homekit_native_notify_count);
+  const auto& stats = batch.getStats();
+  TEST_ASSERT_EQUAL(3, stats.requested);
+  TEST_ASSERT_EQUAL(2, stats.sent);
+  TEST_ASSERT_EQUAL(1, stats.saved);
+  TEST_ASSERT_EQUAL(1, stats.flushes);
+  TEST_ASSERT_EQUAL(1, metrics.getNotifySaved());
+  // the next pass notifies the same characteristic again
+  batch.add(&characteristics[0]);
+  batch.flush();
+  TEST_ASSERT_EQUAL(3, homekit_native_notify_count);
+  TEST_ASSERT_EQUAL(2, stats.flushes);
+}
+
+void test_empty_flush_is_not_counted(void) {
+  NotifyBatch batch;
+  batch.flush();
+  TEST_ASSERT_EQUAL(0, homekit_native_notify_count);
+  TEST_ASSERT_EQUAL(0, batch.getStats().flushes);
+}
+
+void test_full_batch_flushes_early(void) {
+  NotifyBatch batch;
+  for (auto i = 0; i <= NOTIFY_BATCH_CAPACITY; i++) {
+    batch.add(&characteristics[i]);
+  }
+  // the first capacity went out to make room, the last one waits
+  TEST_ASSERT_EQUAL(NOTIFY_BATCH_CAPACITY, homekit_native_notify_count);
+  TEST_ASSERT_FALSE(batch.isEmpty());
+  batch.flush();
+  TEST_ASSERT_EQUAL(NOTIFY_BATCH_CAPACITY + 1, homekit_native_notify_count);
+  TEST_ASSERT_EQUAL(NOTIFY_BATCH_CAPACITY + 1, batch.getStats().sent);
+  TEST_ASSERT_EQUAL(0, batch.getStats().saved);
+  TEST_ASSERT_EQUAL(2, batch.getStats().flushes);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_repeats_collapse_within_flush);
+  RUN_TEST(test_empty_flush_is_not_counted);
+  RUN_TEST(test_full_batch_flushes_early);
+  return UNITY_END();
+}
@@ -0,0 +1,100 @@
+#include <unity.h>
+#include "NotifyChannel.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+homekit_characteristic_t characteristic = {};
+NotifyBatch* batch = nullptr;
+NotifyChannel* channel = nullptr;
+
+// notifications the channel queued into the batch
+unsigned long pushed() {
+  return batch->getStats().requested;
+}
+
+void setUp(void) {
+  VirtualClock::reset();
+  characteristic = {};
+  batch = new NotifyBatch();
+  // 0.1 step, 0.5 deadband, 10s min, 60s max
+  channel = new NotifyChannel(&characteristic, 10, batch);
+  channel->setup(50, 10000, 60000);
+}
+
+void tearDown(void) {
+  delete channel;
+  delete batch;
+}
+
+void test_first_value_always_notified(void) {
+  TEST_ASSERT_TRUE(channel->write(2134, true));
+  TEST_ASSERT_EQUAL_FLOAT(21.3f, characteristic.value.float_value);
+  TEST_ASSERT_EQUAL(1, pushed());
+}
+
+void test_change_inside_deadband_suppressed(void) {
+  TEST_ASSERT_TRUE(channel->write(2000, true));
+  VirtualClock::advanceMillis(20000);
+  // 0.4 off the notified value, stored but not notified
+  TEST_ASSERT_FALSE(channel->write(2040, true));
+  TEST_ASSERT_EQUAL_FLOAT(20.4f, characteristic.value.float_value);
+  TEST_ASSERT_EQUAL(2, channel->getChanges());
+  // measured against the notified value, not the last stored one
+  TEST_ASSERT_FALSE(channel->write(1960, true));
+  TEST_ASSERT_TRUE(channel->write(2050, true));
+  TEST_ASSERT_EQUAL(2, pushed());
+}
+
+void test_min_interval_holds_back_large_change(void) {
+  TEST_ASSERT_TRUE(channel->write(2000, true));
+  VirtualClock::advanceMillis(9999);
+  TEST_ASSERT_FALSE(channel->write(2500, true));
+  TEST_ASSERT_EQUAL_FLOAT(25.0f, characteristic.value.float_value);
+  VirtualClock::advanceMillis(1);
+  TEST_ASSERT_TRUE(channel->write(2500, true));
+  TEST_ASSERT_EQUAL(2, pushed());
+}
+
+void test_max_interval_flushes_drift(void) {
+  TEST_ASSERT_TRUE(channel->write(2000, true));
+  VirtualClock::advanceMillis(30000);
+  TEST_ASSERT_FALSE(channel->write(2010, true));
+  VirtualClock::advanceMillis(29999);
+  TEST_ASSERT_FALSE(channel->write(2010, true));
+  VirtualClock::advanceMillis(1);
+  // a 0.1 drift goes out once max interval passed
+  TEST_ASSERT_TRUE(channel->write(2010, true));
+  TEST_ASSERT_EQUAL(2, pushed());
+}
+
+void test_no_flush_without_drift(void) {
+  TEST_ASSERT_TRUE(channel->write(2000, true));
+  // raw values rounding to the notified one are not drift
+  for (auto i = 0; i < 10; i++) {
+    VirtualClock::advanceMillis(60000);
+    TEST_ASSERT_FALSE(channel->write(2000 + (i % 5) - 2, true));
+  }
+  TEST_ASSERT_EQUAL(1, channel->getChanges());
+  TEST_ASSERT_EQUAL(1, pushed());
+}
+
+void test_notify_off_only_stores(void) {
+  TEST_ASSERT_FALSE(channel->write(2000, false));
+  TEST_ASSERT_EQUAL_FLOAT(20.0f, characteristic.value.float_value);
+  TEST_ASSERT_EQUAL(0, pushed());
+  // nothing notified yet, the next notify goes out
+  TEST_ASSERT_TRUE(channel->write(2000, true));
+  TEST_ASSERT_EQUAL(1, pushed());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_value_always_notified);
+  RUN_TEST(test_change_inside_deadband_suppressed);
+  RUN_TEST(test_min_interval_holds_back_large_change);
+  RUN_TEST(test_max_interval_flushes_drift);
+  RUN_TEST(test_no_flush_without_drift);
+  RUN_TEST(test_notify_off_only_stores);
+  return UNITY_END();
+}
@@ -0,0 +1,268 @@
+#include <chrono>
+#include <unity.h>
+#include "PortalSnapshot.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// heap traffic through operator new, per portal request
+static size_t allocations = 0;
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+  allocations++;
+  allocatedBytes += size;
+  if (void* ptr = malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+// stand-in of the portal row model handed to onServiceGet
+struct TextValueModel {
+  String text;
+  String value;
+};
+
+// pollers hitting the portal at once, each on its own period, over a simulated stretch
+// with a measure every 10s moving the readings
+#define LOAD_POLLERS 4
+#define LOAD_SIMULATED_MS (10UL * 60 * 1000)
+#define LOAD_MEASURE_MS 10000
+#define LOAD_STEP_MS 50
+
+struct FakeReadings {
+  float temperature = 23.5f;
+  float humidity = 45.0f;
+  float co2 = 412.0f;
+  float voc = 31.0f;
+  uint32_t heapFree = 41234;
+  uint32_t loopRate = 48;
+  uint32_t htSuccess = 0;
+  uint32_t revision = 0;
+} readings;
+
+void setUp(void) {
+  VirtualClock::reset();
+  portalSnapshot = PortalSnapshot();
+  readings = FakeReadings();
+}
+
+void tearDown(void) {}
+
+// the rows of the firmware portal, old way: fresh strings concatenated on every request
+void legacyStates(std::vector<TextValueModel>& states) {
+  states.push_back({ .text = F("Service"),     .value = VICTOR_ACCESSORY_SERVICE_NAME });
+  states.push_back({ .text = F("Temperature"), .value = String(readings.temperature) + F("°C") });
+  states.push_back({ .text = F("Humidity"),    .value = String(readings.humidity) + F("%") });
+  states.push_back({ .text = F("CO2 Level"),   .value = String(readings.co2) + F("ppm/㎥") });
+  states.push_back({ .text = F("VOC Density"), .value = String(readings.voc) + F("ppb/㎥") });
+  states.push_back({ .text = F("Heap"),        .value = String(readings.heapFree) + F(" free, ") + String(readings.heapFree - 2000) + F(" min") });
+  states.push_back({ .text = F("Loop Rate"),   .value = String(readings.loopRate) + F("/s") });
+  states.push_back({ .text = F("HT Reads"),    .value = String(readings.htSuccess) + F(" ok, 0 failed") });
+}
+
+// same rows, new way
+void renderStates(PortalSnapshot& snapshot) {
+  snapshot.add(F("Service"), PSTR("%s"), VICTOR_ACCESSORY_SERVICE_NAME);
+  snapshot.addCenti(F("Temperature"), lroundf(readings.temperature * 100), F("°C"));
+  snapshot.addCenti(F("Humidity"), lroundf(readings.humidity * 100), F("%"));
+  snapshot.addCenti(F("CO2 Level"), lroundf(readings.co2 * 100), F("ppm/㎥"));
+  snapshot.addCenti(F("VOC Density"), lroundf(readings.voc * 100), F("ppb/㎥"));
+  snapshot.add(F("Heap"), PSTR("%lu free, %lu min"), static_cast<unsigned long>(readings.heapFree), static_cast<unsigned long>(readings.heapFree - 2000));
+  snapshot.add(F("Loop Rate"), PSTR("%lu/s"), static_cast<unsigned long>(readings.loopRate));
+  snapshot.add(F("HT Reads"), PSTR("%lu ok, 0 failed"), static_cast<unsigned long>(readings.htSuccess));
+}
+
+void snapshotStates(std::vector<TextValueModel>& states) {
+  portalSnapshot.refresh(readings.revision);
+  states.reserve(states.size() + portalSnapshot.size());
+  for (uint8_t i = 0; i < portalSnapshot.size(); i++) {
+    states.push_back({ .text = portalSnapshot.textAt(i), .value = portalSnapshot.valueAt(i) });
+  }
+}
+
+// the /state csv, streamed out of the snapshot in chunks
+size_t snapshotCsv() {
+  portalSnapshot.refresh(readings.revision);
+  char buffer[256];
+  size_t cursor = 0;
+  size_t length;
+  size_t total = 0;
+  while ((length = portalSnapshot.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+    total += length;
+  }
+  return total;
+}
+
+void test_rows_match_the_string_concatenation(void) {
+  portalSnapshot.onRender = renderStates;
+  readings.temperature = 24.1f;
+  readings.humidity = 0.5f;
+  std::vector<TextValueModel> legacy;
+  std::vector<TextValueModel> snapshot;
+  legacyStates(legacy);
+  snapshotStates(snapshot);
+  TEST_ASSERT_EQUAL(legacy.size(), snapshot.size());
+  for (size_t i = 0; i < legacy.size(); i++) {
+    TEST_ASSERT_EQUAL_STRING(legacy[i].text.c_str(), snapshot[i].text.c_str());
+    TEST_ASSERT_EQUAL_STRING(legacy[i].value.c_str(), snapshot[i].value.c_str());
+  }
+  TEST_ASSERT_EQUAL_STRING("24.10°C", portalSnapshot.valueAt(1));
+  TEST_ASSERT_EQUAL_STRING("0.50%", portalSnapshot.valueAt(2));
+}
+
+void test_rendered_on_revision_or_age(void) {
+  portalSnapshot.onRender = renderStates;
+  TEST_ASSERT_TRUE(portalSnapshot.refresh(0));
+  TEST_ASSERT_FALSE(portalSnapshot.refresh(0));
+  // a reading moved
+  TEST_ASSERT_TRUE(portalSnapshot.refresh(1));
+  TEST_ASSERT_FALSE(portalSnapshot.refresh(1));
+  // diagnostics go stale at most max age
+  delay(PORTAL_SNAPSHOT_MAX_AGE_MILLIS - 1);
+  TEST_ASSERT_FALSE(portalSnapshot.refresh(1));
+  delay(1);
+  TEST_ASSERT_TRUE(portalSnapshot.refresh(1));
+  portalSnapshot.invalidate();
+  TEST_ASSERT_TRUE(portalSnapshot.refresh(1));
+  TEST_ASSERT_EQUAL(4, portalSnapshot.getRenders());
+  TEST_ASSERT_EQUAL(8, portalSnapshot.size());
+}
+
+void test_full_buffer_drops_rows(void) {
+  portalSnapshot.onRender = [](PortalSnapshot& snapshot) {
+    for (auto i = 0; i < PORTAL_SNAPSHOT_ROW_MAX + 2; i++) {
+      snapshot.add(F("Row"), PSTR("%d"), i);
+    }
+  };
+  portalSnapshot.refresh(0);
+  TEST_ASSERT_EQUAL(PORTAL_SNAPSHOT_ROW_MAX, portalSnapshot.size());
+  TEST_ASSERT_EQUAL(2, portalSnapshot.getDropped());
+  // a value larger than what is left, the rows before stay intact
+  portalSnapshot.onRender = [](PortalSnapshot& snapshot) {
+    static char large[PORTAL_SNAPSHOT_BUFFER_SIZE];
+    memset(large, 'x', sizeof(large) - 1);
+    snapshot.add(F("Before"), PSTR("%s"), "ok");
+    snapshot.add(F("Large"), PSTR("%s"), large);
+    snapshot.add(F("After"), PSTR("%s"), "ok");
+  };
+  portalSnapshot.invalidate();
+  portalSnapshot.refresh(0);
+  TEST_ASSERT_EQUAL(2, portalSnapshot.size());
+  TEST_ASSERT_EQUAL(1, portalSnapshot.getDropped());
+  TEST_ASSERT_EQUAL_STRING("After", portalSnapshot.textAt(1));
+  TEST_ASSERT_EQUAL_STRING("ok", portalSnapshot.valueAt(1));
+}
+
+void test_csv_in_chunks(void) {
+  portalSnapshot.onRender = renderStates;
+  portalSnapshot.refresh(0);
+  // smaller than all rows, larger than any one row
+  char buffer[64];
+  size_t cursor = 0;
+  size_t length;
+  std::string csv;
+  while ((length = portalSnapshot.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+    csv.append(buffer, length);
+  }
+  TEST_ASSERT_EQUAL(portalSnapshot.size(), cursor);
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, csv.find("Temperature,\"23.50°C\"\n"));
+  TEST_ASSERT_NOT_EQUAL(std::string::npos, csv.find("HT Reads,\"0 ok, 0 failed\"\n"));
+}
+
+// latency and heap churn per request, every poller served in turn as the loop would
+struct LoadStats {
+  const char* name;
+  unsigned long requests = 0;
+  size_t allocations = 0;
+  size_t allocatedBytes = 0;
+  std::chrono::steady_clock::duration busy = {};
+  void print() const {
+    printf(
+      "%-9s %8lu %10.1f %10.1f %10lld\n", name, requests, static_cast<double>(allocations) / requests, static_cast<double>(allocatedBytes) / requests,
+      static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count() / requests)
+    );
+  }
+};
+
+void runLoad(LoadStats& stats, const std::function<void()>& request) {
+  VirtualClock::reset();
+  const unsigned long periods[LOAD_POLLERS] = { 1000, 2000, 3000, 5000 };
+  unsigned long nextPoll[LOAD_POLLERS] = {};
+  unsigned long nextMeasure = LOAD_MEASURE_MS;
+  while (millis() < LOAD_SIMULATED_MS) {
+    const auto now = millis();
+    if (now >= nextMeasure) {
+      nextMeasure += LOAD_MEASURE_MS;
+      readings.temperature += 0.1f;
+      readings.htSuccess++;
+      readings.revision++;
+    }
+    readings.heapFree = 41234 - (now / 1000) % 64;
+    for (auto i = 0; i < LOAD_POLLERS; i++) {
+      if (now >= nextPoll[i]) {
+        nextPoll[i] += periods[i];
+        const auto beforeAllocations = allocations;
+        const auto beforeBytes = allocatedBytes;
+        const auto begin = std::chrono::steady_clock::now();
+        request();
+        stats.busy += std::chrono::steady_clock::now() - begin;
+        stats.allocations += allocations - beforeAllocations;
+        stats.allocatedBytes += allocatedBytes - beforeBytes;
+        stats.requests++;
+      }
+    }
+    delay(LOAD_STEP_MS);
+  }
+}
+
+void test_load_concurrent_polling(void) {
+  portalSnapshot.onRender = renderStates;
+  LoadStats legacy = { .name = "legacy" };
+  runLoad(legacy, []() {
+    std::vector<TextValueModel> states;
+    legacyStates(states);
+  });
+  readings = FakeReadings();
+  LoadStats snapshot = { .name = "snapshot" };
+  runLoad(snapshot, []() {
+    std::vector<TextValueModel> states;
+    snapshotStates(states);
+  });
+  const auto rendersPortal = portalSnapshot.getRenders();
+  readings = FakeReadings();
+  portalSnapshot.invalidate();
+  LoadStats csv = { .name = "/state" };
+  runLoad(csv, []() { snapshotCsv(); });
+
+  printf(
+    "\n%d pollers over %lus, a reading every %lus, host ns\n%-9s %8s %10s %10s %10s\n", LOAD_POLLERS, LOAD_SIMULATED_MS / 1000, LOAD_MEASURE_MS / 1000UL,
+    "path", "requests", "allocs/req", "bytes/req", "ns/req"
+  );
+  legacy.print();
+  snapshot.print();
+  csv.print();
+  printf("snapshot renders: %lu for %lu requests, %u bytes buffer\n", static_cast<unsigned long>(rendersPortal), snapshot.requests, static_cast<unsigned>(sizeof(PortalSnapshot)));
+
+  TEST_ASSERT_EQUAL(legacy.requests, snapshot.requests);
+  // one render per reading at most, plus the diagnostics refresh on age
+  TEST_ASSERT_LESS_OR_EQUAL(LOAD_SIMULATED_MS / LOAD_MEASURE_MS + LOAD_SIMULATED_MS / PORTAL_SNAPSHOT_MAX_AGE_MILLIS + 1, rendersPortal);
+  TEST_ASSERT_LESS_THAN(legacy.allocatedBytes, snapshot.allocatedBytes);
+  // streamed straight out of the buffer
+  TEST_ASSERT_EQUAL(0, csv.allocations);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_rows_match_the_string_concatenation);
+  RUN_TEST(test_rendered_on_revision_or_age);
+  RUN_TEST(test_full_buffer_drops_rows);
+  RUN_TEST(test_csv_in_chunks);
+  RUN_TEST(test_load_concurrent_polling);
+  return UNITY_END();
+}
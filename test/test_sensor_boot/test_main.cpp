@@ -0,0 +1,256 @@
+#include <unity.h>
+#include <FakeClimate.h>
+#include "ClimateStorage.h"
+#include "ClimateMeasure.h"
+#include "SensorBoot.h"
+#include "SensorRegistry.h"
+#include "BootTimeline.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// characteristics normally defined in src/accessory.c
+homekit_characteristic_t temperatureState = {};
+homekit_characteristic_t temperatureActiveState = {};
+homekit_characteristic_t humidityState = {};
+homekit_characteristic_t humidityActiveState = {};
+homekit_characteristic_t carbonDioxideState = {};
+homekit_characteristic_t vocDensityState = {};
+homekit_characteristic_t airQualityState = {};
+homekit_characteristic_t airQualityActiveState = {};
+
+#define BOOT_LOOP_SLEEP_MAX_MS 20
+#define BOOT_TIMEOUT_MS 60000
+
+void setUp(void) {
+  VirtualClock::reset();
+  bootTimeline.clear();
+  fakeClimate = FakeClimate();
+  temperatureActiveState.value.bool_value = false;
+  airQualityActiveState.value.bool_value = false;
+}
+
+void tearDown(void) {}
+
+void test_time_to_first_reading(void) {
+  const auto climate = &climateStorage.load();
+  I2cSetting i2c;
+  i2c.enablePin = 3;
+
+  // what setup() used to block on: the power cycle, both begins,
+  // and the first measure deadline one loop interval after that
+  auto ht = new HTSensor(climate->htSensor);
+  auto aq = new AQSensor(climate->aqSensor);
+  delay(200);
+  delay(200);
+  ht->begin();
+  aq->begin();
+  aq->loadBaseline(climate->baseline);
+  const auto sequentialBlockMillis = millis();
+  const auto sequentialReadingMillis = sequentialBlockMillis + climate->htQuery.loopSeconds * 1000UL;
+  delete ht;
+  delete aq;
+
+  // same bring-up phase by phase from loop()
+  VirtualClock::reset();
+  // the shipped sht30 + sgp30 wiring, found by the bus scan
+  Wire.plug(0x44);
+  Wire.plug(SENSOR_REGISTRY_SGP30_ADDRESS);
+  const auto registry = new SensorRegistry();
+  const auto boot = new SensorBoot(i2c, climate, registry);
+  ClimateMeasure* measure = nullptr;
+  unsigned long maxPassMicros = 0;
+  unsigned long passes = 0;
+  while (!temperatureActiveState.value.bool_value && millis() < BOOT_TIMEOUT_MS) {
+    const auto start = micros();
+    unsigned long idleMillis;
+    if (boot->isDone()) {
+      idleMillis = measure->loop(true);
+      measure->flushNotify();
+    } else {
+      idleMillis = boot->loop();
+      if (boot->isDone()) {
+        bootTimeline.mark(F("sensors ready"));
+        measure = new ClimateMeasure(climate, registry->getHT(), registry->getAQ());
+        measure->begin();
+        idleMillis = 0;
+      }
+    }
+    maxPassMicros = std::max(maxPassMicros, micros() - start);
+    passes++;
+    delay(std::min<unsigned long>(idleMillis, BOOT_LOOP_SLEEP_MAX_MS));
+  }
+  bootTimeline.mark(F("first reading"));
+  const auto asyncReadingMillis = millis();
+
+  bootTimeline.print();
+  printf(
+    "\nsequential: setup blocked %lums, first reading at %lums\n"
+    "state machine: longest loop pass %luus over %lu passes, first reading at %lums\n",
+    sequentialBlockMillis, sequentialReadingMillis, maxPassMicros, passes, asyncReadingMillis
+  );
+
+  TEST_ASSERT_TRUE(boot->isDone());
+  TEST_ASSERT_TRUE(temperatureActiveState.value.bool_value);
+  TEST_ASSERT_TRUE(registry->isFound(0x44));
+  TEST_ASSERT_EQUAL(1, registry->getHT()->size());
+  TEST_ASSERT_NOT_NULL(registry->getAQ());
+  TEST_ASSERT_TRUE(boot->hasHT());
+  TEST_ASSERT_TRUE(boot->hasAQ());
+  // no pass sits through a power cycle wait, wifi and homekit keep running
+  TEST_ASSERT_LESS_THAN(SENSOR_BOOT_POWER_MILLIS * 1000UL, maxPassMicros);
+  // first reading right after bring-up instead of one interval later
+  TEST_ASSERT_LESS_THAN(sequentialReadingMillis / 4, asyncReadingMillis);
+
+  delete measure;
+  delete boot;
+  delete registry;
+  Wire.unplug(0x44);
+  Wire.unplug(SENSOR_REGISTRY_SGP30_ADDRESS);
+}
+
+void test_timeline_csv_is_chunked(void) {
+  bootTimeline.mark(F("setup"));
+  delay(200);
+  bootTimeline.mark(F("sensor power on"));
+  delay(1);
+  bootTimeline.mark(F("first reading"));
+  char buffer[32];
+  size_t cursor = 0;
+  size_t length;
+  std::string csv;
+  while ((length = bootTimeline.writeCsv(cursor, buffer, sizeof(buffer))) > 0) {
+    csv.append(buffer, length);
+  }
+  TEST_ASSERT_EQUAL(bootTimeline.size(), cursor);
+  TEST_ASSERT_EQUAL_STRING("0.0,0.0,setup\n200.0,200.0,sensor power on\n201.0,1.0,first reading\n", csv.c_str());
+}
+
+void test_timeline_keeps_final_marks(void) {
+  // a retried phase keeps one mark, at its last attempt
+  bootTimeline.mark(F("setup"));
+  const auto scan = F("i2c scan");
+  for (auto i = 0; i < 3; i++) {
+    delay(100);
+    bootTimeline.mark(scan);
+  }
+  TEST_ASSERT_EQUAL(2, bootTimeline.size());
+  TEST_ASSERT_EQUAL(300000, bootTimeline.at(1).micros);
+  // past the capacity the last mark gives way, the first reading still makes it in
+  for (auto i = bootTimeline.size(); i < BOOT_TIMELINE_CAPACITY + 2; i++) {
+    bootTimeline.mark(i % 2 == 0 ? F("ht begin") : F("aq begin"));
+  }
+  bootTimeline.mark(F("first reading"));
+  TEST_ASSERT_EQUAL(BOOT_TIMELINE_CAPACITY, bootTimeline.size());
+  TEST_ASSERT_EQUAL(3, bootTimeline.getDropped());
+  TEST_ASSERT_EQUAL_STRING("first reading", reinterpret_cast<const char*>(bootTimeline.at(BOOT_TIMELINE_CAPACITY - 1).name));
+}
+
+void test_missing_sensor_is_reported(void) {
+  // aqs on in climate.json, but no sgp30 fitted
+  fakeClimate.sgp30Missing = true;
+  const auto climate = &climateStorage.load();
+  auto setting = *climate;
+  setting.fusion.scan = false;
+  I2cSetting i2c;
+  const auto registry = new SensorRegistry();
+  const auto boot = new SensorBoot(i2c, &setting, registry);
+  while (!boot->isDone() && millis() < BOOT_TIMEOUT_MS) {
+    delay(boot->loop());
+  }
+  TEST_ASSERT_TRUE(boot->isDone());
+  TEST_ASSERT_NOT_NULL(registry->getAQ());
+  TEST_ASSERT_TRUE(boot->hasHT());
+  TEST_ASSERT_FALSE(boot->hasAQ());
+  // still measured, and fitted later it is picked up by a probe
+  TEST_ASSERT_FALSE(registry->getAQ()->isPresent());
+  const auto measure = new ClimateMeasure(&setting, registry->getHT(), registry->getAQ());
+  measure->begin();
+  const auto bootMillis = millis();
+  while (millis() - bootMillis < 10000) {
+    delay(std::min<unsigned long>(measure->loop(true), BOOT_LOOP_SLEEP_MAX_MS));
+  }
+  TEST_ASSERT_TRUE(temperatureActiveState.value.bool_value);
+  TEST_ASSERT_FALSE(airQualityActiveState.value.bool_value);
+  fakeClimate.sgp30Missing = false;
+  while (!airQualityActiveState.value.bool_value && millis() - bootMillis < BOOT_TIMEOUT_MS) {
+    delay(std::min<unsigned long>(measure->loop(true), BOOT_LOOP_SLEEP_MAX_MS));
+  }
+  TEST_ASSERT_TRUE(registry->getAQ()->isPresent());
+  TEST_ASSERT_TRUE(airQualityActiveState.value.bool_value);
+  TEST_ASSERT_EQUAL(1, registry->getAQ()->getSampling().probes);
+  delete measure;
+  delete boot;
+  delete registry;
+}
+
+void test_sample_waits_for_pending_collect(void) {
+  const auto climate = &climateStorage.load();
+  auto setting = *climate;
+  setting.fusion.scan = false;
+  I2cSetting i2c;
+  const auto registry = new SensorRegistry();
+  const auto boot = new SensorBoot(i2c, &setting, registry);
+  while (!boot->isDone() && millis() < BOOT_TIMEOUT_MS) {
+    delay(boot->loop());
+  }
+  const auto aq = registry->getAQ();
+  const auto measure = new ClimateMeasure(&setting, registry->getHT(), aq);
+  measure->begin();
+  // a stalled loop runs the sample job again with the collect still queued
+  measure->runJob(JOB_AQ_SAMPLE, false);
+  const auto transactions = Wire.transactions;
+  measure->runJob(JOB_AQ_SAMPLE, false);
+  TEST_ASSERT_EQUAL(transactions, Wire.transactions);
+  TEST_ASSERT_TRUE(aq->isConverting());
+  delay(aq->getWaitMillis());
+  measure->runJob(JOB_AQ_COLLECT, false);
+  TEST_ASSERT_FALSE(aq->isConverting());
+  TEST_ASSERT_EQUAL(1, aq->getSampling().samples);
+  TEST_ASSERT_EQUAL(0, aq->getSampling().failures);
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, aq->measure());
+  // a collect with nothing pending stays off the bus
+  measure->runJob(JOB_AQ_COLLECT, false);
+  TEST_ASSERT_EQUAL(1, aq->getSampling().samples);
+  delete measure;
+  delete boot;
+  delete registry;
+}
+
+void test_slow_sensor_is_retried(void) {
+  // no answer to the first begin(), the next attempt finds it
+  fakeClimate.sgp30Missing = true;
+  const auto climate = &climateStorage.load();
+  auto setting = *climate;
+  setting.fusion.scan = false;
+  I2cSetting i2c;
+  const auto registry = new SensorRegistry();
+  const auto boot = new SensorBoot(i2c, &setting, registry);
+  while (boot->getPhase() != SENSOR_BOOT_AQ && millis() < BOOT_TIMEOUT_MS) {
+    delay(boot->loop());
+  }
+  delay(boot->loop());
+  TEST_ASSERT_EQUAL(SENSOR_BOOT_AQ, boot->getPhase());
+  // the layout is known, homekit does not wait for the retries
+  TEST_ASSERT_TRUE(boot->isCreated());
+  TEST_ASSERT_FALSE(boot->isDone());
+  fakeClimate.sgp30Missing = false;
+  while (!boot->isDone() && millis() < BOOT_TIMEOUT_MS) {
+    delay(boot->loop());
+  }
+  TEST_ASSERT_TRUE(boot->hasAQ());
+  TEST_ASSERT_TRUE(registry->getAQ()->isPresent());
+  delete boot;
+  delete registry;
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_time_to_first_reading);
+  RUN_TEST(test_timeline_csv_is_chunked);
+  RUN_TEST(test_timeline_keeps_final_marks);
+  RUN_TEST(test_missing_sensor_is_reported);
+  RUN_TEST(test_slow_sensor_is_retried);
+  RUN_TEST(test_sample_waits_for_pending_collect);
+  return UNITY_END();
+}
@@ -0,0 +1,88 @@
+#include <unity.h>
+#include "SensorBus.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// remembers the readings it got and in which turn
+class RecordingSink : public SensorSink {
+ public:
+  void onReading(const SensorReading& reading) override {
+    calls++;
+    last = reading;
+    turn = ++counter;
+  }
+  static uint32_t counter;
+  uint32_t calls = 0;
+  uint32_t turn = 0;
+  SensorReading last;
+};
+
+uint32_t RecordingSink::counter = 0;
+
+void setUp(void) {
+  VirtualClock::reset();
+  RecordingSink::counter = 0;
+}
+
+void tearDown(void) {}
+
+void test_fan_out_in_subscribe_order(void) {
+  SensorBus bus;
+  RecordingSink first;
+  RecordingSink second;
+  TEST_ASSERT_TRUE(bus.subscribe(&first));
+  TEST_ASSERT_TRUE(bus.subscribe(&second));
+  // known sinks are not added twice
+  TEST_ASSERT_TRUE(bus.subscribe(&first));
+  TEST_ASSERT_EQUAL(2, bus.size());
+  SensorReading reading;
+  reading.type = SENSOR_READING_AQ;
+  reading.ok = true;
+  reading.co2 = 41200;
+  reading.voc = 3100;
+  reading.airQuality = 1;
+  bus.publish(reading);
+  TEST_ASSERT_EQUAL(1, first.calls);
+  TEST_ASSERT_EQUAL(1, second.calls);
+  TEST_ASSERT_LESS_THAN(second.turn, first.turn);
+  TEST_ASSERT_EQUAL(SENSOR_READING_AQ, second.last.type);
+  TEST_ASSERT_EQUAL(41200, second.last.co2);
+  TEST_ASSERT_EQUAL(3100, second.last.voc);
+  TEST_ASSERT_EQUAL(1, bus.getPublished());
+}
+
+void test_unsubscribe_keeps_the_order(void) {
+  SensorBus bus;
+  RecordingSink sinks[3];
+  for (auto& sink : sinks) {
+    bus.subscribe(&sink);
+  }
+  bus.unsubscribe(&sinks[0]);
+  bus.unsubscribe(&sinks[0]); // unknown, no-op
+  TEST_ASSERT_EQUAL(2, bus.size());
+  bus.publish(SensorReading());
+  TEST_ASSERT_EQUAL(0, sinks[0].calls);
+  TEST_ASSERT_LESS_THAN(sinks[2].turn, sinks[1].turn);
+}
+
+void test_full_bus_refuses(void) {
+  SensorBus bus;
+  RecordingSink sinks[SENSOR_BUS_SINK_MAX + 1];
+  for (auto i = 0; i < SENSOR_BUS_SINK_MAX; i++) {
+    TEST_ASSERT_TRUE(bus.subscribe(&sinks[i]));
+  }
+  TEST_ASSERT_FALSE(bus.subscribe(&sinks[SENSOR_BUS_SINK_MAX]));
+  TEST_ASSERT_FALSE(bus.subscribe(nullptr));
+  bus.publish(SensorReading());
+  TEST_ASSERT_EQUAL(0, sinks[SENSOR_BUS_SINK_MAX].calls);
+  TEST_ASSERT_EQUAL(1, sinks[SENSOR_BUS_SINK_MAX - 1].calls);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fan_out_in_subscribe_order);
+  RUN_TEST(test_unsubscribe_keeps_the_order);
+  RUN_TEST(test_full_bus_refuses);
+  return UNITY_END();
+}
@@ -0,0 +1,220 @@
+#include <unity.h>
+#include <FakeClimate.h>
+#include "SensorRegistry.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+static const uint8_t everyAddress[] = { 0x38, 0x44, 0x45, SENSOR_REGISTRY_SGP30_ADDRESS };
+
+void setUp(void) {
+  VirtualClock::reset();
+  fakeClimate = FakeClimate();
+  for (const auto address : everyAddress) {
+    Wire.unplug(address);
+  }
+}
+
+void tearDown(void) {
+  for (const auto address : everyAddress) {
+    Wire.fit(address);
+  }
+}
+
+static ClimateSetting scanSetting() {
+  ClimateSetting setting;
+  setting.htSensor = HT_SENSOR_SHT30;
+  setting.aqSensor = AQ_SENSOR_SGP30;
+  setting.fusion.scan = true;
+  return setting;
+}
+
+// drive a round to its end the way ClimateMeasure does, one call per pass
+static MeasureState measureRound(HTFusion* ht, uint8_t& maxConverting) {
+  for (auto pass = 0; pass < 100; pass++) {
+    const auto state = ht->measure();
+    uint8_t converting = 0;
+    for (uint8_t i = 0; i < ht->size(); i++) {
+      converting += ht->at(i)->isConverting() ? 1 : 0;
+    }
+    maxConverting = std::max(maxConverting, converting);
+    if (state != MEASURE_SKIPPED) {
+      return state;
+    }
+    delay(ht->getWaitMillis());
+  }
+  return MEASURE_SKIPPED;
+}
+
+void test_scan_finds_every_known_sensor(void) {
+  for (const auto address : everyAddress) {
+    Wire.plug(address);
+  }
+  SensorRegistry registry;
+  TEST_ASSERT_EQUAL(4, registry.scan());
+  TEST_ASSERT_EQUAL_STRING("0x38 0x44 0x45 0x58", registry.describe().c_str());
+  registry.create(scanSetting());
+  TEST_ASSERT_EQUAL(3, registry.getHT()->size());
+  TEST_ASSERT_NOT_NULL(registry.getAQ());
+}
+
+void test_scan_without_sensors_falls_back_to_setting(void) {
+  SensorRegistry registry;
+  TEST_ASSERT_EQUAL(0, registry.scan());
+  TEST_ASSERT_EQUAL_STRING("none", registry.describe().c_str());
+  registry.create(scanSetting());
+  TEST_ASSERT_EQUAL(1, registry.getHT()->size());
+  TEST_ASSERT_NOT_NULL(registry.getAQ());
+  // nothing configured, nothing found
+  SensorRegistry empty;
+  ClimateSetting setting;
+  setting.htSensor = HT_SENSOR_OFF;
+  setting.aqSensor = AQ_SENSOR_OFF;
+  empty.create(setting);
+  TEST_ASSERT_NULL(empty.getHT());
+  TEST_ASSERT_NULL(empty.getAQ());
+}
+
+void test_scan_respects_kinds_switched_off(void) {
+  for (const auto address : everyAddress) {
+    Wire.plug(address);
+  }
+  // aqs:0, the sgp30 answering the scan is left alone
+  SensorRegistry noAQ;
+  TEST_ASSERT_EQUAL(4, noAQ.scan());
+  auto setting = scanSetting();
+  setting.aqSensor = AQ_SENSOR_OFF;
+  noAQ.create(setting);
+  TEST_ASSERT_EQUAL(3, noAQ.getHT()->size());
+  TEST_ASSERT_NULL(noAQ.getAQ());
+  // hts:0
+  SensorRegistry noHT;
+  noHT.scan();
+  setting = scanSetting();
+  setting.htSensor = HT_SENSOR_OFF;
+  noHT.create(setting);
+  TEST_ASSERT_NULL(noHT.getHT());
+  TEST_ASSERT_NOT_NULL(noHT.getAQ());
+}
+
+void test_fuse(void) {
+  const int32_t values[] = { 2400, 2460, 2900 };
+  const uint8_t even[] = { 1, 1, 1 };
+  const uint8_t weighted[] = { 3, 1, 0 };
+  TEST_ASSERT_EQUAL(2587, HTFusion::fuse(FUSION_MEAN, values, even, 3));
+  TEST_ASSERT_EQUAL(2415, HTFusion::fuse(FUSION_MEAN, values, weighted, 3));
+  TEST_ASSERT_EQUAL(2460, HTFusion::fuse(FUSION_MEDIAN, values, even, 3));
+  // two left: mean of the middle pair, weights only pick who takes part
+  TEST_ASSERT_EQUAL(2430, HTFusion::fuse(FUSION_MEDIAN, values, weighted, 3));
+  const int32_t negative[] = { -105, -100 };
+  TEST_ASSERT_EQUAL(-103, HTFusion::fuse(FUSION_MEAN, negative, even, 2));
+}
+
+void test_sensors_take_turns_on_the_bus(void) {
+  for (const auto address : everyAddress) {
+    Wire.plug(address);
+  }
+  SensorRegistry registry;
+  registry.scan();
+  registry.create(scanSetting());
+  const auto ht = registry.getHT();
+  TEST_ASSERT_TRUE(ht->begin());
+  uint8_t maxConverting = 0;
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, measureRound(ht, maxConverting));
+  TEST_ASSERT_EQUAL(3, ht->getFusedCount());
+  TEST_ASSERT_EQUAL(1, maxConverting);
+  TEST_ASSERT_INT_WITHIN(10, 2400, ht->getCentiTemperature());
+  TEST_ASSERT_INT_WITHIN(50, 4500, ht->getCentiHumidity());
+  // the aht10 drops off the bus, re-initialized within the same round
+  i2cBus.clearStats();
+  Wire.detach(0x38);
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, measureRound(ht, maxConverting));
+  TEST_ASSERT_EQUAL(3, ht->getFusedCount());
+  TEST_ASSERT_EQUAL(1, i2cBus.find(0x38)->recoveries);
+  TEST_ASSERT_INT_WITHIN(10, 2400, ht->getCentiTemperature());
+  // all gone
+  fakeClimate.fail = true;
+  TEST_ASSERT_EQUAL(MEASURE_FAILED, measureRound(ht, maxConverting));
+  TEST_ASSERT_EQUAL(0, ht->getFusedCount());
+}
+
+void test_sensor_missing_at_boot_is_probed_on_backoff(void) {
+  for (const auto address : everyAddress) {
+    Wire.plug(address);
+  }
+  SensorRegistry registry;
+  registry.scan();
+  registry.create(scanSetting());
+  const auto ht = registry.getHT();
+  // 0x45 answered the scan but is gone by begin()
+  Wire.unfit(0x45);
+  TEST_ASSERT_TRUE(ht->begin());
+  TEST_ASSERT_FALSE(ht->isPresent(2));
+  i2cBus.clearStats();
+  const auto clears = i2cBus.getClears();
+  uint8_t maxConverting = 0;
+  // rounds go on without it, no retries, no bus clears
+  const auto start = millis();
+  while (millis() - start < HT_FUSION_PROBE_MIN_MILLIS - 1000) {
+    TEST_ASSERT_EQUAL(MEASURE_SUCCESS, measureRound(ht, maxConverting));
+    TEST_ASSERT_EQUAL(2, ht->getFusedCount());
+    delay(1000);
+  }
+  TEST_ASSERT_EQUAL(0, ht->getProbes());
+  TEST_ASSERT_NULL(i2cBus.find(0x45));
+  // probed after the backoff, then twice as long after each miss
+  unsigned long probedAt[3] = {};
+  while (ht->getProbes() < 3) {
+    const auto probes = ht->getProbes();
+    TEST_ASSERT_EQUAL(MEASURE_SUCCESS, measureRound(ht, maxConverting));
+    if (ht->getProbes() > probes) {
+      probedAt[probes] = millis();
+    }
+    delay(1000);
+  }
+  TEST_ASSERT_UINT_WITHIN(1500, HT_FUSION_PROBE_MIN_MILLIS, probedAt[0] - start);
+  TEST_ASSERT_UINT_WITHIN(1500, HT_FUSION_PROBE_MIN_MILLIS * 2, probedAt[1] - probedAt[0]);
+  TEST_ASSERT_UINT_WITHIN(1500, HT_FUSION_PROBE_MIN_MILLIS * 4, probedAt[2] - probedAt[1]);
+  TEST_ASSERT_EQUAL(clears, i2cBus.getClears());
+  // fitted again, the next probe brings it into the rounds
+  Wire.fit(0x45);
+  while (!ht->isPresent(2)) {
+    TEST_ASSERT_EQUAL(MEASURE_SUCCESS, measureRound(ht, maxConverting));
+    delay(1000);
+  }
+  TEST_ASSERT_EQUAL(4, ht->getProbes());
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, measureRound(ht, maxConverting));
+  TEST_ASSERT_EQUAL(3, ht->getFusedCount());
+}
+
+void test_no_sensor_at_boot_fails_without_bus_traffic(void) {
+  SensorRegistry registry;
+  auto setting = scanSetting();
+  setting.fusion.scan = false;
+  registry.create(setting);
+  const auto ht = registry.getHT();
+  Wire.unfit(0x44);
+  TEST_ASSERT_FALSE(ht->begin());
+  const auto transactions = Wire.transactions;
+  TEST_ASSERT_EQUAL(MEASURE_FAILED, ht->measure());
+  TEST_ASSERT_FALSE(ht->isConverting());
+  TEST_ASSERT_EQUAL(transactions, Wire.transactions);
+  // back on the board, picked up by a probe without a reboot
+  Wire.fit(0x44);
+  delay(HT_FUSION_PROBE_MIN_MILLIS);
+  uint8_t maxConverting = 0;
+  TEST_ASSERT_EQUAL(MEASURE_SUCCESS, measureRound(ht, maxConverting));
+  TEST_ASSERT_EQUAL(1, ht->getFusedCount());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_scan_finds_every_known_sensor);
+  RUN_TEST(test_scan_without_sensors_falls_back_to_setting);
+  RUN_TEST(test_scan_respects_kinds_switched_off);
+  RUN_TEST(test_fuse);
+  RUN_TEST(test_sensors_take_turns_on_the_bus);
+  RUN_TEST(test_sensor_missing_at_boot_is_probed_on_backoff);
+  RUN_TEST(test_no_sensor_at_boot_fails_without_bus_traffic);
+  return UNITY_END();
+}
@@ -0,0 +1,127 @@
+#include <unity.h>
+#include "SignalFilter.h"
+
+using namespace Victor::Components;
+
+// same sweep runs on the host (ns) and on the device (cpu cycles)
+#ifdef VICTOR_NATIVE
+#include <chrono>
+#define BENCH_UNIT "ns"
+static uint32_t benchNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#else
+#define BENCH_UNIT "cycles"
+static uint32_t benchNow() {
+  return ESP.getCycleCount();
+}
+#endif
+
+#define BENCH_ROUNDS 10000
+
+volatile int32_t sink = 0;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_disabled_filter_passes_through(void) {
+  SignalFilter filter;
+  filter.setup(1, 0);
+  TEST_ASSERT_EQUAL(2412, filter.push(2412));
+  TEST_ASSERT_EQUAL(-735, filter.push(-735));
+  TEST_ASSERT_EQUAL(0, filter.push(0));
+}
+
+void test_median_rejects_spike(void) {
+  SignalFilter filter;
+  filter.setup(3, 0);
+  TEST_ASSERT_EQUAL(2400, filter.push(2400));
+  TEST_ASSERT_EQUAL(2410, filter.push(2410)); // middle of two, the upper one
+  TEST_ASSERT_EQUAL(2410, filter.push(9000)); // spike
+  TEST_ASSERT_EQUAL(2410, filter.push(2405));
+  TEST_ASSERT_EQUAL(2405, filter.push(2400));
+  // negative values sort the same way
+  filter.reset();
+  filter.push(-500);
+  filter.push(-9000);
+  TEST_ASSERT_EQUAL(-510, filter.push(-510));
+}
+
+void test_median_window_is_forced_odd_and_bounded(void) {
+  SignalFilter filter;
+  filter.setup(4, 0); // runs as 5
+  const int32_t values[] = { 10, 90, 20, 80, 30 };
+  int32_t last = 0;
+  for (const auto value : values) {
+    last = filter.push(value);
+  }
+  TEST_ASSERT_EQUAL(30, last);
+  filter.setup(200, 0); // capped at FILTER_MEDIAN_MAX
+  for (auto i = 0; i < FILTER_MEDIAN_MAX; i++) {
+    last = filter.push(i < FILTER_MEDIAN_MAX / 2 ? 1000 : 0);
+  }
+  TEST_ASSERT_EQUAL(0, last);
+}
+
+void test_ema_converges_to_step(void) {
+  SignalFilter filter;
+  filter.setup(1, 2); // alpha 1/4
+  TEST_ASSERT_EQUAL(4500, filter.push(4500)); // seeded by the first sample
+  TEST_ASSERT_EQUAL(4625, filter.push(5000));
+  TEST_ASSERT_EQUAL(4719, filter.push(5000));
+  int32_t last = 0;
+  for (auto i = 0; i < 40; i++) {
+    last = filter.push(5000);
+  }
+  TEST_ASSERT_EQUAL(5000, last);
+  // and back down across zero
+  for (auto i = 0; i < 60; i++) {
+    last = filter.push(-300);
+  }
+  TEST_ASSERT_EQUAL(-300, last);
+}
+
+void test_median_then_ema(void) {
+  SignalFilter filter;
+  filter.setup(3, 1);
+  filter.push(2400);
+  filter.push(2400);
+  // the spike never reaches the average
+  TEST_ASSERT_EQUAL(2400, filter.push(12000));
+  TEST_ASSERT_EQUAL(2400, filter.push(2400));
+}
+
+static float benchPush(const uint8_t median, const uint8_t emaShift) {
+  SignalFilter filter;
+  filter.setup(median, emaShift);
+  const auto begin = benchNow();
+  for (auto i = 0; i < BENCH_ROUNDS; i++) {
+    // humidity like noise around 45%RH
+    sink += filter.push(4500 + ((i * 37) % 61) - 30);
+  }
+  return static_cast<float>(benchNow() - begin) / BENCH_ROUNDS;
+}
+
+void test_signal_filter_benchmark(void) {
+  const struct {
+    uint8_t median;
+    uint8_t emaShift;
+  } configs[] = { { 1, 0 }, { 1, 2 }, { 3, 0 }, { 3, 2 }, { 5, 2 }, { 7, 3 } };
+  printf("signal filter per sample:\n");
+  for (const auto& config : configs) {
+    printf("  median %u ema %u: %.1f " BENCH_UNIT "\n", config.median, config.emaShift, benchPush(config.median, config.emaShift));
+  }
+  TEST_ASSERT_NOT_EQUAL(0, sink);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_disabled_filter_passes_through);
+  RUN_TEST(test_median_rejects_spike);
+  RUN_TEST(test_median_window_is_forced_odd_and_bounded);
+  RUN_TEST(test_ema_converges_to_step);
+  RUN_TEST(test_median_then_ema);
+  RUN_TEST(test_signal_filter_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,207 @@
+#include <chrono>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <unity.h>
+#include "Telemetry.h"
+
+using namespace Victor::Components;
+using namespace Victor::Native;
+
+// readings pushed through the exporter per batch size in the throughput run
+#define BENCH_READINGS 20000
+// ipv4 + udp headers every datagram carries on the air
+#define BENCH_UDP_OVERHEAD 28
+
+// udp listener on localhost standing in for the collector
+static int listener = -1;
+static uint16_t listenerPort = 0;
+
+static void openListener() {
+  listener = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0; // any free port
+  bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  socklen_t length = sizeof(address);
+  getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+  listenerPort = ntohs(address.sin_port);
+}
+
+// one datagram, 0 when nothing arrived within the timeout
+static size_t receive(uint8_t* buffer, const size_t size, const int timeoutMillis = 200) {
+  pollfd fd = { .fd = listener, .events = POLLIN, .revents = 0 };
+  if (poll(&fd, 1, timeoutMillis) <= 0) {
+    return 0;
+  }
+  const auto length = recv(listener, buffer, size, 0);
+  return length > 0 ? length : 0;
+}
+
+static TelemetryConfig localConfig(const uint8_t batch, const uint16_t flushSeconds) {
+  TelemetryConfig config;
+  config.ip[0] = 127;
+  config.ip[3] = 1;
+  config.port = listenerPort;
+  config.batch = batch;
+  config.flushSeconds = flushSeconds;
+  return config;
+}
+
+static SensorReading htReading(const int32_t temperature, const int32_t humidity) {
+  SensorReading reading;
+  reading.type = SENSOR_READING_HT;
+  reading.ok = true;
+  reading.millis = millis();
+  reading.temperature = temperature;
+  reading.humidity = humidity;
+  return reading;
+}
+
+static SensorReading aqReading(const int32_t co2, const int32_t voc) {
+  SensorReading reading;
+  reading.type = SENSOR_READING_AQ;
+  reading.ok = true;
+  reading.millis = millis();
+  reading.co2 = co2;
+  reading.voc = voc;
+  return reading;
+}
+
+void setUp(void) {
+  VirtualClock::reset();
+  if (listener < 0) {
+    openListener();
+  }
+}
+
+void tearDown(void) {}
+
+void test_disabled_without_port(void) {
+  TelemetryExporter exporter{ TelemetryConfig() };
+  TEST_ASSERT_FALSE(exporter.isEnabled());
+  exporter.onReading(htReading(2345, 4510));
+  TEST_ASSERT_FALSE(exporter.flush());
+  TEST_ASSERT_EQUAL(0, exporter.getStats().frames);
+}
+
+void test_batch_goes_out_as_one_datagram(void) {
+  TelemetryExporter exporter(localConfig(4, 60));
+  SensorBus bus;
+  bus.subscribe(&exporter);
+  delay(3000);
+  bus.publish(htReading(2345, 4510));
+  delay(2000);
+  bus.publish(aqReading(41234, 3125));
+  auto failed = htReading(0, 0);
+  failed.ok = false;
+  bus.publish(failed);
+  TEST_ASSERT_FALSE(exporter.loop());
+  bus.publish(htReading(-150, 10000));
+  TEST_ASSERT_TRUE(exporter.loop());
+  TEST_ASSERT_EQUAL(0, exporter.pending());
+
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  const auto length = receive(frame, sizeof(frame));
+  TEST_ASSERT_EQUAL(TELEMETRY_HEADER_SIZE + 4 * TELEMETRY_SAMPLE_SIZE, length);
+  TelemetryHeader header;
+  TelemetrySample samples[TELEMETRY_BATCH_MAX];
+  TEST_ASSERT_EQUAL(4, TelemetryExporter::decode(frame, length, header, samples, TELEMETRY_BATCH_MAX));
+  TEST_ASSERT_EQUAL(0, header.sequence);
+  TEST_ASSERT_EQUAL(3, header.seconds);
+  TEST_ASSERT_EQUAL(TELEMETRY_FLAG_OK, samples[0].flags);
+  TEST_ASSERT_EQUAL(2345, samples[0].a);
+  TEST_ASSERT_EQUAL(4510, samples[0].b);
+  TEST_ASSERT_EQUAL(TELEMETRY_FLAG_OK | TELEMETRY_FLAG_AQ, samples[1].flags);
+  TEST_ASSERT_EQUAL(2, samples[1].offset);
+  TEST_ASSERT_EQUAL(412, samples[1].a);
+  TEST_ASSERT_EQUAL(312, samples[1].b);
+  TEST_ASSERT_EQUAL(0, samples[2].flags);
+  TEST_ASSERT_EQUAL(-150, samples[3].a);
+  TEST_ASSERT_EQUAL(10000, samples[3].b);
+  // the next frame carries on the sequence
+  bus.publish(htReading(2000, 5000));
+  TEST_ASSERT_TRUE(exporter.flush());
+  const auto next = receive(frame, sizeof(frame));
+  TEST_ASSERT_EQUAL(1, TelemetryExporter::decode(frame, next, header, samples, TELEMETRY_BATCH_MAX));
+  TEST_ASSERT_EQUAL(4, header.sequence);
+}
+
+void test_flushed_on_age(void) {
+  TelemetryExporter exporter(localConfig(16, 30));
+  exporter.onReading(htReading(2345, 4510));
+  delay(29999);
+  TEST_ASSERT_FALSE(exporter.loop());
+  delay(1);
+  TEST_ASSERT_TRUE(exporter.loop());
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  TEST_ASSERT_EQUAL(TELEMETRY_HEADER_SIZE + TELEMETRY_SAMPLE_SIZE, receive(frame, sizeof(frame)));
+}
+
+void test_full_frame_drops_until_sent(void) {
+  TelemetryExporter exporter(localConfig(TELEMETRY_BATCH_MAX, 60));
+  for (auto i = 0; i < TELEMETRY_BATCH_MAX + 3; i++) {
+    exporter.onReading(htReading(i, i));
+  }
+  TEST_ASSERT_EQUAL(3, exporter.getStats().overflows);
+  TEST_ASSERT_TRUE(exporter.loop());
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  TEST_ASSERT_EQUAL(TELEMETRY_FRAME_MAX, receive(frame, sizeof(frame)));
+  // malformed frames are refused
+  TelemetryHeader header;
+  TelemetrySample samples[TELEMETRY_BATCH_MAX];
+  TEST_ASSERT_EQUAL(0, TelemetryExporter::decode(frame, TELEMETRY_FRAME_MAX - 1, header, samples, TELEMETRY_BATCH_MAX));
+  frame[0] ^= 0xFF;
+  TEST_ASSERT_EQUAL(0, TelemetryExporter::decode(frame, TELEMETRY_FRAME_MAX, header, samples, TELEMETRY_BATCH_MAX));
+}
+
+void test_throughput_by_batch_size(void) {
+  printf("\n%d readings to a localhost listener\n%5s %9s %9s %12s %13s %14s\n", BENCH_READINGS, "batch", "datagrams", "bytes", "bytes/sample", "+udp/ip", "samples/s host");
+  for (const uint8_t batch : { 1, 4, 16, TELEMETRY_BATCH_MAX }) {
+    TelemetryExporter exporter(localConfig(batch, 60));
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    TelemetryHeader header;
+    TelemetrySample samples[TELEMETRY_BATCH_MAX];
+    unsigned long received = 0;
+    unsigned long datagrams = 0;
+    unsigned long bytes = 0;
+    uint32_t expected = 0;
+    auto gaps = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (auto i = 0; i < BENCH_READINGS; i++) {
+      exporter.onReading(i % 2 == 0 ? htReading(2000 + i % 500, 4000 + i % 900) : aqReading(40000 + i, 1000 + i % 700));
+      if (exporter.loop()) {
+        // drained right away so the host socket buffer never drops anything
+        const auto length = receive(frame, sizeof(frame));
+        const auto count = TelemetryExporter::decode(frame, length, header, samples, TELEMETRY_BATCH_MAX);
+        gaps += header.sequence != expected ? 1 : 0;
+        expected = header.sequence + count;
+        received += count;
+        datagrams++;
+        bytes += length;
+      }
+    }
+    const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+    printf(
+      "%5u %9lu %9lu %12.2f %13.2f %14.0f\n", batch, datagrams, bytes, static_cast<double>(bytes) / received,
+      static_cast<double>(bytes + datagrams * BENCH_UDP_OVERHEAD) / received, static_cast<double>(received) * 1e9 / nanos
+    );
+    TEST_ASSERT_EQUAL(0, gaps);
+    TEST_ASSERT_EQUAL(BENCH_READINGS, received);
+    TEST_ASSERT_EQUAL(static_cast<unsigned long>(BENCH_READINGS / batch), datagrams);
+    TEST_ASSERT_EQUAL(exporter.getStats().bytes, bytes);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_disabled_without_port);
+  RUN_TEST(test_batch_goes_out_as_one_datagram);
+  RUN_TEST(test_flushed_on_age);
+  RUN_TEST(test_full_frame_drops_until_sent);
+  RUN_TEST(test_throughput_by_batch_size);
+  close(listener);
+  return UNITY_END();
+}